@@ -0,0 +1,112 @@
+/**
+ * bench_batch_io.cpp
+ * Dirty-check hashing: one file at a time vs batched io_uring vs threads
+ *
+ * Hashes a tree of files three ways through StateManager: hash_file() per
+ * file (the pre-batching path), then prefetch_hashes() with the io_uring
+ * and thread-pool backends. Each pass starts from a fresh StateManager.
+ *
+ * With --drop-caches the page cache is dropped before every pass, which
+ * needs root (sync; echo 3 > /proc/sys/vm/drop_caches). Without it, or if
+ * dropping fails, the numbers are for a warm cache and mostly measure
+ * syscall overhead.
+ *
+ * Usage:
+ *   bench_batch_io [--dir D] [--files N] [--kib K] [--drop-caches]
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "state/state_manager.hpp"
+
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace aria::make;
+namespace fs = std::filesystem;
+
+namespace {
+
+bool drop_caches() {
+    ::sync();
+    std::ofstream out("/proc/sys/vm/drop_caches");
+    out << "3\n";
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+std::vector<std::string> make_tree(const fs::path& dir, size_t files, size_t kib) {
+    std::vector<std::string> paths;
+    std::string content(kib * 1024, 'x');
+    for (size_t i = 0; i < files; ++i) {
+        fs::path path = dir / ("d" + std::to_string(i % 64)) / ("f" + std::to_string(i) + ".aria");
+        paths.push_back(path.string());
+        if (fs::exists(path)) continue;
+        fs::create_directories(path.parent_path());
+        content[0] = static_cast<char>('a' + i % 26);
+        std::ofstream(path, std::ios::binary) << content;
+    }
+    return paths;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    fs::path dir = fs::temp_directory_path() / "aria_make_bench_io";
+    size_t files = 5000;
+    size_t kib = 8;
+    bool drop = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--drop-caches") drop = true;
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else if (arg == "--files" && i + 1 < argc) files = std::stoul(argv[++i]);
+        else if (arg == "--kib" && i + 1 < argc) kib = std::stoul(argv[++i]);
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    auto paths = make_tree(dir, files, kib);
+    bool cold = drop && drop_caches();
+    if (drop && !cold) {
+        std::cerr << "Cannot drop caches (needs root); measuring a warm cache\n";
+    }
+    std::cout << "files=" << files << " size=" << kib << "KiB cache="
+              << (cold ? "cold" : "warm") << "\n";
+    std::printf("%-10s %10s %10s\n", "backend", "ms", "files/s");
+
+    struct Pass { const char* label; bool batched; IoBackend backend; };
+    for (const Pass& pass : {Pass{"serial", false, IoBackend::THREADS},
+                             Pass{"io_uring", true, IoBackend::URING},
+                             Pass{"threads", true, IoBackend::THREADS}}) {
+        if (cold) drop_caches();
+        StateManager mgr(dir);
+        mgr.set_io_backend(pass.backend);
+
+        auto start = std::chrono::steady_clock::now();
+        if (pass.batched) {
+            mgr.prefetch_hashes(paths);
+        }
+        for (const auto& path : paths) {
+            mgr.hash_file(path);
+        }
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::string label = pass.label;
+        if (pass.batched && label != mgr.io_backend_name()) {
+            label += " (" + mgr.io_backend_name() + ")";    // Fell back
+        }
+        std::printf("%-10s %10.1f %10.0f\n", label.c_str(), ms,
+                    static_cast<double>(paths.size()) / (ms / 1000.0));
+    }
+    return 0;
+}
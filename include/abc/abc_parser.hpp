@@ -15,6 +15,7 @@
 #define ABC_PARSER_HPP
 
 #include "abc/abc_lexer.hpp"
+#include <cstddef>
 #include <memory>
 #include <vector>
 #include <string>
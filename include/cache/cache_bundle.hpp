@@ -0,0 +1,90 @@
+/**
+ * cache_bundle.hpp
+ * Portable cache bundles (`aria_make cache export/import`)
+ *
+ * A bundle carries the build state file and the build outputs of a
+ * project so that a fresh checkout (an ephemeral CI runner) can start warm.
+ * It is a single stream:
+ *
+ *   "ARIACB01" u32 version u32 compression
+ *   frame*     u64 raw_size u64 stored_size bytes[stored_size]
+ *   end frame  (0, 0)
+ *
+ * Each frame is compressed on its own (zlib when built with it) and holds
+ * whole records - STATE (the state JSON), BLOB (digest + content, each
+ * distinct content once) and FILE (project-relative path, digest, exec
+ * bit) - so frames are compressed and decompressed in parallel. Import
+ * puts the blobs into a local content store and hardlinks files from it.
+ *
+ * Nothing is trusted blindly: recorded source hashes are content hashes,
+ * so every imported record is revalidated against the checkout's files by
+ * the next build's dirty check.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_CACHE_BUNDLE_HPP
+#define ARIA_MAKE_CACHE_BUNDLE_HPP
+
+#include "remote/content_store.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+struct BundleFile {
+    std::string path;       // Relative to the project root (as stored)
+    fs::path source;        // Local file to pack
+};
+
+// A file as recorded in a bundle
+struct BundleEntry {
+    std::string path;       // Relative to the project root
+    Digest digest;
+    bool executable = false;
+};
+
+struct BundleStats {
+    size_t files = 0;
+    size_t deferred = 0;        // Files left in the store (see read())
+    size_t blobs = 0;           // Distinct contents
+    uint64_t raw_bytes = 0;     // Uncompressed frame bytes
+    uint64_t stored_bytes = 0;  // Bytes in the bundle (after compression)
+};
+
+class CacheBundle {
+public:
+    static constexpr uint32_t VERSION = 2;     // 2: SHA-256 digests
+
+    // True when built with zlib (otherwise bundles are stored uncompressed)
+    static bool compression_available();
+
+    /**
+     * Write `state_json` and `files` to `out`. Unreadable files are skipped.
+     */
+    static bool write(std::ostream& out, const std::string& state_json,
+                      const std::vector<BundleFile>& files,
+                      BundleStats& stats, std::string& error);
+
+    /**
+     * Read a bundle from `in`: blobs go into `store`, files are placed under
+     * `dest_root` and the state JSON is returned in `state_json`. Files for
+     * which `defer(path)` is true are not placed; they are appended to
+     * `deferred` for the caller to materialize when needed.
+     */
+    static bool read(std::istream& in, ContentStore& store, const fs::path& dest_root,
+                     std::string& state_json, BundleStats& stats, std::string& error,
+                     const std::function<bool(const std::string&)>& defer = {},
+                     std::vector<BundleEntry>* deferred = nullptr);
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_CACHE_BUNDLE_HPP
@@ -0,0 +1,142 @@
+/**
+ * action_graph.hpp
+ * Action-graph intermediate representation for aria_make
+ *
+ * Targets are lowered into actions before execution. An action is one
+ * process invocation (object compile, archive, link, test run, user
+ * command) with its complete argv, environment, declared input and output
+ * files and resource requirements. Executors only ever see actions; the
+ * target-level logic (dirty checking, early cutoff, test result caching)
+ * decides which actions run.
+ *
+ * Every action carries a stable hash of its definition. Identical actions
+ * requested by several targets are merged into one node, which is how
+ * shared object compiles are deduplicated.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_ACTION_GRAPH_HPP
+#define ARIA_MAKE_ACTION_GRAPH_HPP
+
+#include "core/path_relocator.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+/**
+ * Action kinds
+ */
+enum class ActionKind {
+    COMPILE,    // Source -> object file
+    ARCHIVE,    // Objects -> static library
+    LINK,       // Sources/objects -> executable
+    TEST,       // Run a test binary
+    COMMAND     // User-defined command target
+};
+
+const char* action_kind_to_string(ActionKind kind);
+
+/**
+ * Resources an action occupies while running
+ */
+struct ActionResources {
+    std::string pool;           // Scheduling pool (empty = default for kind)
+    unsigned cpus = 1;          // Job slots consumed
+};
+
+/**
+ * A single process invocation
+ */
+struct Action {
+    size_t id = 0;
+    ActionKind kind = ActionKind::COMPILE;
+    std::vector<std::string> targets;   // Targets that requested this action
+    std::vector<std::string> argv;
+    std::vector<std::pair<std::string, std::string>> env;
+    fs::path working_dir;               // Empty = inherit
+    std::vector<std::string> inputs;    // Declared input files
+    std::vector<std::string> outputs;   // Declared output files
+    std::string depfile;                // Make-style list of files read (also an output; "" = none)
+    std::vector<size_t> deps;           // Actions that must complete first
+    ActionResources resources;
+    std::chrono::milliseconds timeout{0};
+    std::string hash;                   // Stable digest of the definition
+};
+
+/**
+ * Action graph built by lowering targets
+ */
+class ActionGraph {
+public:
+    /**
+     * Add an action on behalf of `target`.
+     *
+     * The hash is computed here. If an action with the same hash already
+     * exists it is reused: `target` is added to its owners and the existing
+     * id is returned.
+     */
+    size_t add(Action action, const std::string& target);
+
+    /**
+     * Record that `action` must wait for `dep`.
+     */
+    void add_dependency(size_t action, size_t dep);
+
+    const Action& get(size_t id) const { return actions_[id]; }
+    Action& get(size_t id) { return actions_[id]; }
+    const std::vector<Action>& actions() const { return actions_; }
+    size_t size() const { return actions_.size(); }
+    bool empty() const { return actions_.empty(); }
+
+    // Actions of a target in the order they must run
+    const std::vector<size_t>& actions_for(const std::string& target) const;
+
+    // Action that declares `output`, if any
+    std::optional<size_t> producer(const std::string& output) const;
+
+    void clear();
+
+    // Paths are relocated before hashing so checkouts in different
+    // directories produce the same action hashes (kept across clear())
+    void set_relocator(PathRelocator relocator) { relocator_ = std::move(relocator); }
+
+    /**
+     * Serialize the graph as JSON (for `aria_make actions` and the
+     * .aria_make/actions.json written by each build). Write-only: the
+     * graph is lowered again on every run.
+     */
+    std::string to_json() const;
+
+    /**
+     * Stable hash of an action definition: kind, argv, environment,
+     * working directory, inputs, outputs, depfile and timeout (FNV-1a,
+     * hex), with paths passed through `relocator`.
+     *
+     * Input file *contents* are deliberately not part of it; combine with
+     * content hashes to get a cache key.
+     */
+    static std::string compute_hash(const Action& action,
+                                    const PathRelocator& relocator = {});
+
+private:
+    PathRelocator relocator_;
+    std::vector<Action> actions_;
+    std::unordered_map<std::string, size_t> by_hash_;
+    std::unordered_map<std::string, size_t> by_output_;
+    std::unordered_map<std::string, std::vector<size_t>> by_target_;
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_ACTION_GRAPH_HPP
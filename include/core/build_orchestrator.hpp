@@ -16,8 +16,9 @@
  * 4. Detect cycles (abort if found)
  * 5. Mark dirty nodes based on StateManager analysis (content hashing)
  * 6. Topological sort for build order
- * 7. Execute parallel builds via thread pool
- * 8. Update and save build state
+ * 7. Lower dirty targets into the action graph (core/action_graph.hpp)
+ * 8. Execute the actions of each target via thread pool
+ * 9. Update and save build state
  *
  * Ecosystem Integration:
  * - Uses ariac --emit-deps for accurate `use` statement parsing (ecosystem/03_DependencyGraph)
@@ -31,13 +32,25 @@
 #define ARIA_MAKE_BUILD_ORCHESTRATOR_HPP
 
 #include "state/state_manager.hpp"
+#include "core/action_graph.hpp"
+#include "core/build_simulator.hpp"
+#include "core/cpu_topology.hpp"
+#include "core/path_relocator.hpp"
+#include "core/process_runner.hpp"
+#include "core/readahead.hpp"
+#include "cache/cache_bundle.hpp"
 #include <filesystem>
 #include <vector>
 #include <string>
 #include <functional>
 #include <memory>
 #include <chrono>
+#include <array>
 #include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <optional>
 
 namespace aria::make {
 
@@ -51,10 +64,21 @@ namespace abc {
     struct ObjectNode;
     struct ArrayNode;
 }
+class RemoteExecutor;
+class ProgressEstimator;
 
 // =============================================================================
 // Build Configuration
 // =============================================================================
+
+// Profile-guided optimization ([pgo] in build.abc). `aria_make pgo` runs
+// both phases; `build --pgo` only the second, with the existing profile.
+enum class PgoPhase {
+    NONE,
+    INSTRUMENT,     // "<target>@pgo-instrument" with profiling; runs the training target
+    OPTIMIZE        // "<target>@pgo" compiled with the merged profile
+};
+
 struct BuildConfig {
     // Project root directory
     fs::path project_root;
@@ -75,7 +99,8 @@ struct BuildConfig {
     std::vector<std::string> global_flags;
 
     // Parallel execution
-    size_t num_threads = 0;  // 0 = auto (hardware_concurrency)
+    size_t num_threads = 0;  // 0 = auto (affinity mask, capped by cgroup cpu.max)
+    CpuPinning pin_jobs = CpuPinning::NONE;  // Pin local compiles to CPUs/L3 groups
 
     // Build behavior
     bool force_rebuild = false;       // Ignore incremental state
@@ -85,8 +110,51 @@ struct BuildConfig {
     bool verbose = false;             // Detailed output
     bool quiet = false;               // Minimal output
 
+    // Test execution (test targets)
+    bool run_tests = false;           // Run test binaries after building them
+    size_t test_shard_index = 0;      // This shard (0-based, from --shard=i/n)
+    size_t test_shard_count = 1;      // Total shards (1 = no sharding)
+    unsigned test_timeout_sec = 300;  // Default per-test timeout
+
+    // Take hashes of unchanged tracked files from .git/index when available
+    bool use_git_index = true;
+
+    // How dirty checking batches stat/read (io_uring, thread pool, or auto)
+    IoBackend io_backend = IoBackend::AUTO;
+
+    // Cache keys: OLD=NEW prefix rewrites applied (after making paths under
+    // project_root relative) to every path hashed into action/state keys
+    std::vector<std::pair<std::string, std::string>> path_prefix_map;
+
+    // Encoding of the local artifact store (<state_dir>/cas)
+    StoreOptions artifact_store;
+
+    // Cache import keeps intermediate outputs (objects, archives, PCHs) in
+    // the artifact store and records only their digests; they are placed
+    // in the tree when an action that runs needs them (--lazy-outputs)
+    bool lazy_outputs = false;
+
+    // Read the inputs of the next few targets to run (sources, recorded
+    // headers, dependency outputs) into the page cache on a background
+    // thread while earlier jobs run (--no-readahead disables)
+    bool readahead = true;
+
+    // Remote execution: `aria_make worker` endpoints ("unix:/path", "host:port")
+    std::vector<std::string> remote_workers;
+
     // Target selection (empty = build all)
     std::vector<std::string> targets;
+
+    // Variants ([variant.<name>] in build.abc) to build side by side; every
+    // target is instantiated once per variant as "<target>@<variant>"
+    std::vector<std::string> variants;
+
+    // Profile-guided optimization phase (replaces `variants`)
+    PgoPhase pgo = PgoPhase::NONE;
+
+    // Linker (--linker), overriding [link] linker: "auto" (mold, else lld,
+    // else gold, from PATH), "mold", "lld", "gold", "bfd" or "default"
+    std::string linker;
 };
 
 // =============================================================================
@@ -94,7 +162,7 @@ struct BuildConfig {
 // =============================================================================
 struct BuildTarget {
     std::string name;
-    std::string type;                      // "binary", "library", "object", "c_library"
+    std::string type;                      // "binary", "library", "object", "c_library", "shared_library", "test", "command"
     std::vector<std::string> sources;      // Source patterns (globs or files)
     std::vector<std::string> dependencies; // Other targets this depends on
     std::vector<std::string> flags;        // Target-specific flags
@@ -105,8 +173,71 @@ struct BuildTarget {
     std::vector<std::string> link_paths;     // Library search paths (-L)
     
     // C/C++ compilation support
-    std::string compiler;                  // "gcc", "g++", "clang", "clang++" (for c_library)
+    std::string compiler;                  // "gcc", "g++", "clang", "clang++" (for C targets)
     std::string output;                    // Explicit output filename (overrides computed path)
+    std::string pch;                       // Header precompiled once and included in every source
+
+    // Unity builds (c_library): sources are #included into generated batch
+    // files of about unity_batch_ms recorded compile time each (0 = default)
+    bool unity = false;
+    unsigned unity_batch_ms = 0;
+
+    // Test support (for test targets)
+    std::vector<std::string> args;         // Arguments passed to the test binary
+    std::vector<std::string> inputs;       // Declared runtime inputs (globs ok), keyed into the result cache
+    unsigned timeout_sec = 0;              // Per-test timeout (0 = BuildConfig default)
+
+    // Custom command support (for command targets)
+    std::vector<std::string> argv;         // Command line; "$in"/"$out" expand to inputs/outputs
+    std::vector<std::string> outputs;      // Declared outputs (absolute after extraction)
+
+    // Scheduling
+    std::string pool;                      // Resource pool for this target's actions ([pools])
+
+    // Link-time optimization: "" (off) or "thin" (bitcode objects, ThinLTO
+    // link with a persistent cache in <state_dir>/lto-cache)
+    std::string lto;
+
+    // Profile-guided optimization: "" (off), "generate" (instrumented) or
+    // "use" (compiled with the merged profile, a hashed implicit input)
+    std::string pgo;
+
+    // Variant this instance belongs to (empty = no variants requested)
+    std::string variant;
+
+    // Workspace package ("" = the root build file; otherwise the member's
+    // directory relative to the root, which also prefixes `name` as
+    // "<package>:<name>") and the directory relative paths resolve against
+    std::string package;
+    fs::path base_dir;
+};
+
+// =============================================================================
+// Test Outcome
+// =============================================================================
+enum class TestStatus {
+    PASSED,
+    FAILED,
+    TIMED_OUT,
+    CACHED      // Passed previously with identical binary + runtime inputs
+};
+
+inline const char* test_status_to_string(TestStatus status) {
+    switch (status) {
+        case TestStatus::PASSED:    return "PASSED";
+        case TestStatus::FAILED:    return "FAILED";
+        case TestStatus::TIMED_OUT: return "TIMEOUT";
+        case TestStatus::CACHED:    return "CACHED";
+        default:                    return "UNKNOWN";
+    }
+}
+
+struct TestOutcome {
+    std::string name;
+    TestStatus status = TestStatus::PASSED;
+    int exit_code = 0;
+    std::chrono::milliseconds duration{0};
+    std::string output;                    // Captured stdout+stderr (failures only)
 };
 
 // =============================================================================
@@ -119,9 +250,15 @@ struct BuildResult {
     size_t built_targets = 0;
     size_t skipped_targets = 0;  // Up-to-date
     size_t failed_targets = 0;
+    size_t cutoff_targets = 0;   // Skipped because rebuilt deps produced identical outputs
+    size_t deduplicated_compiles = 0;  // Object compiles shared with another target
+    size_t remote_actions = 0;   // Actions executed on remote workers
+    size_t fetched_outputs = 0;  // Lazy outputs materialized from the artifact store
+    size_t readahead_files = 0;  // Inputs advised into the page cache ahead of their jobs
 
     std::chrono::milliseconds total_time{0};
     std::chrono::milliseconds compile_time{0};  // Actual compilation time
+    std::chrono::milliseconds link_time{0};     // Spent in link actions
 
     // Errors encountered
     std::vector<std::string> errors;
@@ -132,6 +269,18 @@ struct BuildResult {
 
     // Per-target timing (for profiling)
     std::vector<std::pair<std::string, std::chrono::milliseconds>> target_times;
+    std::vector<std::pair<std::string, std::chrono::milliseconds>> link_times;  // Part of target_times
+
+    // Test outcomes (in completion order)
+    std::vector<TestOutcome> test_results;
+
+    size_t tests_failed() const {
+        size_t n = 0;
+        for (const auto& t : test_results) {
+            if (t.status == TestStatus::FAILED || t.status == TestStatus::TIMED_OUT) ++n;
+        }
+        return n;
+    }
 
     // Cache statistics
     double cache_hit_rate() const {
@@ -159,6 +308,8 @@ struct BuildProgress {
     size_t total = 0;
     std::string current_target;
     std::string message;
+    std::chrono::milliseconds elapsed{0};                   // Since the build started
+    std::optional<std::chrono::milliseconds> remaining;     // Estimated (COMPILING, with history)
 };
 
 using ProgressCallback = std::function<void(const BuildProgress&)>;
@@ -205,6 +356,14 @@ public:
      */
     BuildResult check();
 
+    /**
+     * Profile-guided optimization ([pgo] in build.abc): build instrumented
+     * instances, run the training target, merge its raw profiles with
+     * llvm-profdata into profile_path(), then build the optimized instances.
+     * Returns the result of the optimized build (plus the training run).
+     */
+    BuildResult pgo();
+
     // =========================================================================
     // Configuration
     // =========================================================================
@@ -239,6 +398,59 @@ public:
      */
     std::string dependency_graph_dot() const;
 
+    /**
+     * Lower every target into the action graph (for `aria_make actions`).
+     * Targets that cannot be lowered are reported in `errors`.
+     */
+    const ActionGraph& action_graph(std::vector<std::string>& errors);
+
+    /**
+     * One simulator task per target with its recorded wall time, CPU time
+     * and peak RSS (for `aria_make simulate`). Run check() first. Targets
+     * without history get the mean recorded duration; `missing` counts them.
+     */
+    std::vector<SimTask> simulation_tasks(size_t& missing);
+
+    /**
+     * Resource pool depths declared in [pools].
+     */
+    const std::unordered_map<std::string, size_t>& pool_depths() const { return pool_depths_; }
+
+    /**
+     * Merged profile that `aria_make pgo` writes and `build --pgo` uses.
+     */
+    fs::path profile_path() const { return config_.state_dir / "pgo" / "merged.profdata"; }
+
+    /**
+     * Linker passed to the compiler drivers (-fuse-ld=), "" for their
+     * default. Resolved from --linker or [link] by check()/build().
+     */
+    const std::string& linker() const { return linker_; }
+
+    // =========================================================================
+    // Cache Bundles
+    // =========================================================================
+
+    /**
+     * Pack the saved build state and every existing output of the action
+     * graph into a bundle (`aria_make cache export`). Run check() first.
+     */
+    bool export_cache(std::ostream& out, BundleStats& stats, std::string& error);
+
+    /**
+     * Unpack a bundle (`aria_make cache import`): outputs are restored
+     * from the local store (<state_dir>/cas) and the state file replaced.
+     * With lazy_outputs, intermediate outputs are only recorded by digest;
+     * run check() first so the action graph is known.
+     */
+    bool import_cache(std::istream& in, BundleStats& stats, std::string& error);
+
+    /**
+     * Size, compression ratio and restore throughput of the local store
+     * (nullopt if there is none yet).
+     */
+    std::optional<StoreStats> artifact_store_stats();
+
     /**
      * Cancel the current build.
      */
@@ -254,11 +466,20 @@ private:
     // Build Pipeline Stages
     // =========================================================================
 
-    // Stage 1: Parse build.abc
+    // Stage 1: Parse build.abc (and, in a workspace, every member's in parallel)
     bool parse_build_file();
+    bool read_build_file(const fs::path& build_path, std::string& content);
+    bool parse_workspace_members();
 
     // Stage 2: Extract targets from AST
     bool extract_targets();
+    bool extract_targets_from(const abc::BuildFileNode& ast, const fs::path& base_dir,
+                              const std::string& package);
+
+    // Stage 2b: Read resource pool depths ([pools])
+    bool extract_pools();
+    bool extract_pools_from(const abc::BuildFileNode& ast);
+    bool extract_link_config();
 
     // Stage 3: Expand source patterns (glob)
     bool expand_sources();
@@ -267,6 +488,7 @@ private:
     bool scan_dependencies();
 
     // Stage 5: Build dependency graph
+    bool expand_variants();     // Per-variant target instances (before the graph)
     bool build_dependency_graph();
 
     // Stage 6: Detect cycles
@@ -275,15 +497,87 @@ private:
     // Stage 7: Mark dirty targets
     bool mark_dirty_targets();
 
-    // Stage 8: Execute builds
+    // Stage 8: Lower targets into actions (in build order)
+    bool lower_actions(const std::vector<std::string>& target_names,
+                       std::vector<std::string>& errors);
+    void lower_target(const BuildTarget& target);
+
+    // Stage 9: Execute builds
     bool execute_builds();
     bool execute_builds_sequential();  // Single-threaded fallback
     bool execute_builds_parallel();    // Multi-threaded with dependency tracking
 
+    // Hint the known inputs of a target to readahead_ (no-op without it)
+    void readahead_inputs(const std::string& target_name);
+
     // Build a single target (used by both sequential and parallel)
     bool build_single_target(const BuildTarget& target);
 
-    // Stage 9: Save build state
+    // Run a test target's binary (result-cached, honours timeout)
+    bool run_test(const BuildTarget& target);
+
+    // Run a target's build actions (everything except its test run).
+    // `cpu_time` and `peak_rss_kb` sum/max the rusage of its processes;
+    // `link_time` is the wall time of its link actions.
+    int run_target_actions(const BuildTarget& target,
+                           std::string& stdout_out,
+                           std::string& stderr_out,
+                           std::chrono::milliseconds& cpu_time,
+                           uint64_t& peak_rss_kb,
+                           std::chrono::milliseconds& link_time);
+
+    // Run one action. Each action runs at most once per build; a target
+    // that shares an action already started by another one waits for it.
+    ProcessResult run_action(size_t id);
+
+    // Actions with a depfile (precompiled headers) are skipped while the
+    // files it listed are unchanged; their closure is also recorded as
+    // dependencies of the owning target
+    bool action_up_to_date(const Action& action) const;
+    void record_depfile_action(const Action& action, const ProcessResult& run,
+                               bool ran_remotely);
+    std::vector<DependencyInfo> depfile_dependencies(const BuildTarget& target) const;
+
+    // State record of the action writing `output` ("action:<relocated path>")
+    std::string action_record_name(const std::string& output) const;
+
+    // Local process slots (num_threads). When all are taken an action may
+    // go to a remote worker if that is cheaper than waiting for one.
+    bool try_acquire_local_slot();
+    void acquire_local_slot();
+    void release_local_slot(ActionKind kind, std::chrono::milliseconds duration);
+    double expected_local_wait_ms(ActionKind kind);
+
+    // `action` as shipped to a worker: compiles also carry the project
+    // files their last depfile listed. nullopt for a compile whose closure
+    // is not known (no depfile, never run), which stays local.
+    std::optional<Action> remote_action(const Action& action) const;
+
+    // Extra threads running independent actions of one target. They come
+    // from a build-wide budget of one per slot; a target that gets none
+    // runs its actions on its own thread.
+    size_t acquire_action_helpers(size_t wanted);
+    void release_action_helpers(size_t count);
+
+    // --pin-jobs: the least loaded placement group for a local compile
+    // (-1 when not pinning), handed back after the process exits
+    int acquire_placement();
+    void release_placement(int group);
+
+    // Resource pools ([pools] in build.abc) cap how many actions of a pool
+    // run at once, on top of the local slots. Unknown/empty pools are free.
+    void acquire_pool(const std::string& pool);
+    void release_pool(const std::string& pool);
+
+    // Simulator tasks for `names` (in build order) from the recorded history;
+    // known[i] is false where a target has none and the mean was assumed
+    std::vector<SimTask> history_tasks(const std::vector<std::string>& names,
+                                       std::vector<bool>& known);
+
+    // Early cutoff: dirty only via deps, and every rebuilt dep was unchanged
+    bool can_cut_off(const BuildTarget& target) const;
+
+    // Stage 10: Save build state
     bool save_state();
 
     // =========================================================================
@@ -297,28 +591,32 @@ private:
     // Fallback regex-based dependency extraction (when compiler unavailable)
     std::vector<std::string> extract_dependencies_fallback(const std::string& source_file);
 
-    // Execute a single compile command
-    int execute_compile(const std::string& target_name,
-                        const std::vector<std::string>& sources,
-                        const fs::path& output,
-                        const std::vector<std::string>& flags,
-                        std::string& stdout_out,
-                        std::string& stderr_out);
-
-    // Build a static library (compile sources + ar archive)
-    int build_library(const BuildTarget& target,
-                      const std::vector<std::string>& flags,
-                      std::string& stdout_out,
-                      std::string& stderr_out);
-    
-    // Build a C/C++ library (compile C sources + ar archive)
-    int build_c_library(const BuildTarget& target,
-                        const std::vector<std::string>& flags,
-                        std::string& stdout_out,
-                        std::string& stderr_out);
-
-    // Build the compile command for a target
-    std::vector<std::string> build_command(const BuildTarget& target);
+    // Lowering helpers: object compiles (shared across targets by their
+    // canonical key: compiler, flags, source) and per-type final actions
+    fs::path object_path_for(const std::vector<std::string>& action_key,
+                             const std::string& source,
+                             const std::string& extension = ".o") const;
+    mutable std::unordered_map<std::string, std::vector<std::string>> object_keys_;
+    void lower_library(const BuildTarget& target, const std::vector<std::string>& flags);
+    void lower_c_library(const BuildTarget& target, const std::vector<std::string>& flags);
+
+    // Unity batches of a c_library. Membership comes from the batch files
+    // of the previous build, so it only changes when sources come and go
+    // or a source is being edited (it then compiles on its own until it
+    // has been left alone for a while).
+    struct UnityPlan {
+        fs::path dir;                                   // Generated batch files
+        std::string extension;                          // ".c" or ".cpp"
+        std::vector<std::vector<std::string>> batches;  // Members by batch index (may be empty)
+        std::vector<std::string> loose;                 // Sources compiled on their own
+    };
+    UnityPlan plan_unity(const BuildTarget& target,
+                         const std::function<std::string(const std::string&)>& object_for) const;
+    static fs::path unity_file(const UnityPlan& plan, size_t batch);
+    void write_unity_files(const UnityPlan& plan);
+    void lower_binary(const BuildTarget& target, const std::vector<std::string>& flags);
+    void lower_command(const BuildTarget& target);
+    void lower_test_run(const BuildTarget& target);
     
     // File type detection
     bool is_c_source(const std::string& path) const;
@@ -328,6 +626,41 @@ private:
     // Detect appropriate C/C++ compiler for target
     std::string detect_c_compiler(const BuildTarget& target) const;
 
+    // Linker flags (-L/-l) for binary and test targets
+    std::vector<std::string> link_flags_for(const BuildTarget& target) const;
+
+    // LTO: the bitcode-emitting flags for a C/C++ compile and the archiver
+    // that indexes such objects
+    std::vector<std::string> c_lto_flags(const std::string& compiler_path) const;
+    std::string lto_archiver(const std::string& compiler_path) const;
+
+    // PGO: instrumentation or profile-use flags of a target (LLVM driver
+    // syntax, for ariac and clang) and where instrumented runs write to
+    std::vector<std::string> pgo_flags(const BuildTarget& target) const;
+    fs::path raw_profile_dir() const { return config_.state_dir / "pgo" / "raw"; }
+    bool merge_profiles(std::string& error);
+
+    // What StateManager hashes for a target: its files, its command line
+    // and everything it produces
+    const std::vector<std::string>& tracked_inputs(const BuildTarget& target) const;
+    std::vector<std::string> tracked_flags(const BuildTarget& target) const;
+    std::vector<std::string> target_outputs(const BuildTarget& target) const;
+
+    // Lazy outputs (see StateManager): an output counts as available when
+    // it is in the tree or recorded by digest. Fetching places a recorded
+    // one from the artifact store (false only if that fails).
+    bool output_available(const std::string& path) const;
+    bool fetch_lazy_output(const std::string& path);
+
+    // Test sharding and result cache. The shard's tests are assigned once
+    // per build by assign_test_shard(). A cached result is keyed on the test
+    // binary, its inputs and every shared library it loads (test_cache_inputs).
+    void assign_test_shard();
+    bool in_test_shard(const BuildTarget& target) const;
+    bool test_result_cached(const BuildTarget& target) const;
+    std::vector<std::string> test_cache_inputs(const BuildTarget& target) const;
+    fs::path test_stamp_path(const BuildTarget& target) const;
+
     // Report progress to callback
     void report_progress(BuildPhase phase, size_t current, size_t total,
                          const std::string& target = "",
@@ -347,6 +680,22 @@ private:
     // Parsed build file
     std::unique_ptr<abc::BuildFileNode> build_ast_;
 
+    // Workspace members ([workspace] members = [...] in the root build file)
+    struct WorkspaceMember {
+        std::string package;                    // Directory relative to project_root
+        fs::path dir;
+        std::unique_ptr<abc::BuildFileNode> ast;
+    };
+    std::vector<WorkspaceMember> members_;
+
+    // Instance name of the [pgo] training target (INSTRUMENT phase)
+    std::string pgo_training_;
+
+    // [link]: resolved linker ("" = driver default) and whether targets
+    // built with -g get split DWARF and a gdb index
+    std::string linker_;
+    bool split_debug_ = false;
+
     // Extracted targets
     std::vector<BuildTarget> targets_;
 
@@ -359,17 +708,83 @@ private:
     // Targets that need rebuilding
     std::unordered_set<std::string> dirty_targets_;
 
+    // Test targets whose binary is up to date but whose result is not cached
+    std::unordered_set<std::string> test_run_only_;
+
+    // Test targets this shard builds and runs
+    std::unordered_set<std::string> shard_tests_;
+
+    // Dirty only because a dependency is being rebuilt (early cutoff candidates)
+    std::unordered_set<std::string> propagated_dirty_;
+
+    // Targets rebuilt this run whose outputs actually changed
+    std::unordered_set<std::string> changed_outputs_;
+    mutable std::mutex changed_mutex_;
+
+    // Declared command outputs -> producing target (generated sources)
+    std::unordered_map<std::string, std::string> generated_by_;
+
+    // Lowered actions for this build
+    ActionGraph actions_;
+
+    // Unity plans of the lowered c_library targets (written when built)
+    std::unordered_map<std::string, UnityPlan> unity_plans_;
+
+    // Makes key paths independent of where the project is checked out
+    PathRelocator relocator_;
+
+    // Actions started this build (action id -> completion)
+    std::unordered_map<size_t, std::shared_future<ProcessResult>> action_runs_;
+    std::mutex action_runs_mutex_;
+
+    // Remote execution backend (null unless remote_workers are configured)
+    std::unique_ptr<RemoteExecutor> remote_;
+
+    // Local artifact store (created on first use). Lazy output fetches may
+    // come from several build threads: fetch_mutex_ guards the store's
+    // creation and the in-flight map, so each path is materialized once
+    // while different paths are fetched concurrently.
+    std::unique_ptr<ContentStore> artifact_store_;
+    ContentStore& artifact_store();
+    std::mutex fetch_mutex_;
+    std::unordered_map<std::string, std::shared_future<bool>> fetches_;
+
+    // Local slot accounting and observed local run time per ActionKind
+    std::mutex local_slots_mutex_;
+    std::condition_variable local_slots_cv_;
+    size_t local_running_ = 0;
+    std::array<double, 5> local_cost_ms_{};
+    size_t action_helpers_free_ = 0;
+
+    // Placement groups for pinned compiles and jobs running in each
+    // (guarded by local_slots_mutex_)
+    std::vector<std::vector<int>> placement_groups_;
+    std::vector<size_t> placement_load_;
+
+    // Resource pools: name -> depth, and actions currently holding each
+    std::unordered_map<std::string, size_t> pool_depths_;
+    std::unordered_map<std::string, size_t> pool_running_;
+    std::mutex pools_mutex_;
+    std::condition_variable pools_cv_;
+
     // Build order (topologically sorted)
     std::vector<std::string> build_order_;
 
-    // Current result being built
+    // Current result being built (result_mutex_ guards updates from workers)
     BuildResult result_;
+    std::mutex result_mutex_;
 
     // Cancellation flag
     std::atomic<bool> cancelled_{false};
 
     // Build start time
     std::chrono::steady_clock::time_point start_time_;
+
+    // Remaining-time estimates for progress reports (set per execution)
+    std::unique_ptr<ProgressEstimator> estimator_;
+
+    // Page-cache readahead of upcoming inputs (set per execution)
+    std::unique_ptr<Readahead> readahead_;
 };
 
 // =============================================================================
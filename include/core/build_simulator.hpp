@@ -0,0 +1,91 @@
+/**
+ * build_simulator.hpp
+ * Offline replay of a build schedule from recorded history
+ *
+ * Tuning -j, pools or scheduling order on live builds is slow and noisy.
+ * The simulator instead replays a clean build of the target graph in
+ * virtual time, using each target's recorded wall time, CPU time and peak
+ * RSS, and reports the predicted makespan and slot utilization.
+ *
+ * Model: a target occupies `width` job slots for its whole duration, where
+ * width is its recorded CPU parallelism (cpu_ms / wall_ms, rounded, at
+ * least 1). Given fewer slots than that it runs proportionally longer.
+ * Each running target holds one place in its pool and peak_rss_kb per
+ * slot of memory. Tasks that fit start as soon as their dependencies are
+ * done, in the order of the scheduling policy (later tasks may backfill
+ * slots an earlier one cannot use).
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_BUILD_SIMULATOR_HPP
+#define ARIA_MAKE_BUILD_SIMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aria::make {
+
+/**
+ * Order in which ready tasks are started
+ */
+enum class SchedulePolicy {
+    FIFO,           // In the order they became ready (what the orchestrator does)
+    CRITICAL_PATH,  // Longest remaining path to the end of the build first
+    LONGEST_FIRST   // Longest task first
+};
+
+// "fifo", "critical-path", "longest" (nullopt for anything else)
+std::optional<SchedulePolicy> parse_schedule_policy(const std::string& name);
+const char* schedule_policy_to_string(SchedulePolicy policy);
+
+/**
+ * One unit of scheduled work (a target) and its recorded cost
+ */
+struct SimTask {
+    std::string name;
+    std::vector<size_t> deps;       // Indices of tasks that must finish first
+    double wall_ms = 0;             // Recorded duration
+    double cpu_ms = 0;              // Recorded CPU time (0 = unknown, width 1)
+    uint64_t peak_rss_kb = 0;       // Recorded peak RSS of one process
+    std::string pool;               // Resource pool (empty = none)
+};
+
+struct SimConfig {
+    size_t jobs = 1;
+    SchedulePolicy policy = SchedulePolicy::FIFO;
+    std::unordered_map<std::string, size_t> pool_depths;   // Undeclared pools are free
+    uint64_t memory_limit_kb = 0;   // 0 = unlimited
+};
+
+struct SimResult {
+    double makespan_ms = 0;
+    double work_ms = 0;             // Slot-milliseconds spent running tasks
+    double utilization = 0;         // work_ms / (jobs * makespan_ms)
+    size_t peak_slots = 0;          // Most slots in use at once
+    uint64_t peak_memory_kb = 0;    // Most memory in use at once
+};
+
+/**
+ * Longest dependency chain by recorded wall time: the makespan with
+ * unlimited slots, and a lower bound for every simulation.
+ */
+struct CriticalPath {
+    double length_ms = 0;
+    std::vector<size_t> tasks;      // From the first task to the last
+};
+
+CriticalPath critical_path(const std::vector<SimTask>& tasks);
+
+/**
+ * Replay a clean build of `tasks` (which must form a DAG).
+ */
+SimResult simulate_build(const std::vector<SimTask>& tasks, const SimConfig& config);
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_BUILD_SIMULATOR_HPP
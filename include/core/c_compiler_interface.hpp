@@ -46,6 +46,9 @@ public:
         std::vector<std::string> defines;        // Preprocessor defines (-D flags)
         bool compile_only = true;                // -c flag (compile without linking)
         bool position_independent = false;       // -fPIC for shared libraries
+        bool precompile_header = false;          // Sources are headers: output is a PCH
+        std::string pch;                         // Precompiled header to use (from pch_extension())
+        bool split_debug = false;                // -gsplit-dwarf (debug info in .dwo files)
     };
     
     /**
@@ -57,6 +60,10 @@ public:
         bool shared = false;                     // true = .so, false = .a
         std::vector<std::string> link_libraries; // Libraries to link (-l)
         std::vector<std::string> library_paths;  // Library search paths (-L)
+        std::vector<std::string> flags;          // Extra link flags for shared libraries (-flto, ...)
+        std::string soname;                      // DT_SONAME of a shared library (-Wl,-soname)
+        std::string linker;                      // Linker for shared libraries (-fuse-ld=, empty = default)
+        bool split_debug = false;                // Add a gdb index (--gdb-index) to shared libraries
     };
     
     /**
@@ -120,10 +127,8 @@ public:
      */
     bool is_available() const;
 
-private:
-    std::string compiler_path_;  // Path to gcc/clang/g++/clang++
-    bool is_cpp_;                // C++ mode vs C mode
-    
+    // Argument builders (public so the orchestrator can lower into actions)
+
     /**
      * Build command-line arguments from CompileTask
      * 
@@ -147,6 +152,20 @@ private:
      * @return argv array for compiler with -shared
      */
     std::vector<std::string> build_shared_args(const LibraryTask& task) const;
+
+    /**
+     * Extension appended to a header's name for its precompiled form
+     *
+     * GCC finds "<header>.gch" next to an -include'd header; clang loads
+     * a ".pch" named explicitly with -include-pch.
+     */
+    std::string pch_extension() const;
+
+private:
+    bool is_clang() const;
+
+    std::string compiler_path_;  // Path to gcc/clang/g++/clang++
+    bool is_cpp_;                // C++ mode vs C mode
     
     /**
      * Execute command and capture output
@@ -41,6 +41,8 @@ public:
         std::string output;                      // Output file path (-o flag)
         std::vector<std::string> flags;          // Additional flags (-O2, -Wall, etc)
         std::vector<std::string> include_paths;  // Module search paths (-I flags)
+        std::string linker;                      // Linker for executables (-fuse-ld=, empty = default)
+        bool split_debug = false;                // -gsplit-dwarf (and a gdb index when linking)
         
         // Target type derived from output extension or explicit flag
         // - If output ends with .ll → --emit-llvm
@@ -90,18 +92,20 @@ public:
      */
     bool is_available() const;
 
-private:
-    std::string compiler_path_;  // Path to ariac binary
-    
     /**
      * Build command-line arguments from CompileTask
      * 
      * Format: ariac <sources...> -o <output> [flags...] [-I <include_paths...>]
      * 
+     * Public so the orchestrator can lower compiles into actions.
+     * 
      * @param task Task specification
      * @return argv array suitable for execvp (null-terminated)
      */
     std::vector<std::string> build_command_args(const CompileTask& task) const;
+
+private:
+    std::string compiler_path_;  // Path to ariac binary
     
     /**
      * Execute command and capture output
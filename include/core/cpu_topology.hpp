@@ -0,0 +1,81 @@
+/**
+ * cpu_topology.hpp
+ * Usable CPUs and job placement for aria_make
+ *
+ * std::thread::hardware_concurrency() reports every CPU of the host. Inside
+ * a container that is usually far more than the process may use: the
+ * affinity mask (cpusets, `taskset`) restricts which CPUs run it and the
+ * cgroup v2 `cpu.max` quota limits how much CPU time it gets. Running one
+ * compile per host CPU under an 8-CPU quota only buys throttling, so the
+ * default job count is the smaller of the two.
+ *
+ * Placement groups split the usable CPUs for pinning local jobs: one group
+ * per CPU, or one per set of CPUs sharing a last-level (L3) cache. A job
+ * pinned to a group keeps its working set in that cache instead of
+ * migrating across sockets or CCXs.
+ *
+ * The sysfs/procfs roots are parameters so tests can point them at a
+ * fabricated tree.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_CPU_TOPOLOGY_HPP
+#define ARIA_MAKE_CPU_TOPOLOGY_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+/**
+ * How local jobs are pinned to CPUs
+ */
+enum class CpuPinning {
+    NONE,   // Let the scheduler place jobs (default)
+    CORE,   // One placement group per usable CPU
+    CACHE   // One placement group per shared L3 cache
+};
+
+// "none", "core", "cache" (nullopt for anything else)
+std::optional<CpuPinning> parse_cpu_pinning(const std::string& name);
+const char* cpu_pinning_to_string(CpuPinning pinning);
+
+// Parse a kernel CPU list ("0-3,8,10-11"); malformed ranges are skipped
+std::vector<int> parse_cpu_list(const std::string& text);
+
+// CPUs in this process's affinity mask (sorted; empty if unavailable)
+std::vector<int> affinity_cpus();
+
+/**
+ * CPUs' worth of time allowed by cgroup v2 `cpu.max` along this process's
+ * cgroup path (the tightest quota/period of any ancestor), or nullopt when
+ * no quota is set or cgroup v2 is not mounted.
+ */
+std::optional<double> cgroup_cpu_limit(const fs::path& cgroup_root = "/sys/fs/cgroup",
+                                       const fs::path& proc_cgroup = "/proc/self/cgroup");
+
+/**
+ * Default parallelism: affinity CPUs, capped by the cgroup quota (rounded
+ * up), falling back to hardware_concurrency() and finally 4.
+ */
+size_t default_job_count();
+
+/**
+ * Split `cpus` into placement groups for `pinning` (empty for NONE).
+ * CACHE reads each CPU's cache/indexN/shared_cpu_list under `sysfs_cpu_root`;
+ * CPUs whose L3 cannot be determined form one group per CPU.
+ */
+std::vector<std::vector<int>> cpu_placement_groups(
+    CpuPinning pinning,
+    const std::vector<int>& cpus,
+    const fs::path& sysfs_cpu_root = "/sys/devices/system/cpu");
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_CPU_TOPOLOGY_HPP
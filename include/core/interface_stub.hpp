@@ -0,0 +1,51 @@
+/**
+ * interface_stub.hpp
+ * Exported dynamic interface of a shared library
+ *
+ * A binary linked against a shared library records only what it needs
+ * from the library's dynamic interface: the SONAME and the symbols (with
+ * versions) it resolves. Rebuilding the library with a changed function
+ * body changes the .so but not that interface, so dependents need not be
+ * relinked. The stub captures the interface as text, and its hash stands
+ * in for the library's when deciding whether dependents are rebuilt.
+ *
+ * Stub format, one entry per line, symbols sorted by name:
+ *
+ *   soname libfoo.so
+ *   func foo@@FOO_1
+ *   object table 64
+ *   func compat_fn@FOO_0 weak
+ *
+ * Only defined global/weak symbols of default or protected visibility
+ * are listed. Data (object, tls) entries carry their size, since copy
+ * relocations in dependents depend on it.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_INTERFACE_STUB_HPP
+#define ARIA_MAKE_INTERFACE_STUB_HPP
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+/**
+ * Interface stub text of an ELF shared library (native byte order), or
+ * nullopt with `error` set if it cannot be read.
+ */
+std::optional<std::string> read_interface_stub(const fs::path& library, std::string& error);
+
+/**
+ * Write the stub of `library` to `stub`. An existing stub with the same
+ * content is left untouched.
+ */
+bool write_interface_stub(const fs::path& library, const fs::path& stub, std::string& error);
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_INTERFACE_STUB_HPP
@@ -0,0 +1,63 @@
+/**
+ * path_relocator.hpp
+ * Checkout-independent paths for cache keys
+ *
+ * Sources are expanded to absolute paths, so the same commit checked out
+ * in two directories (CI workspaces, worktrees) would otherwise hash to
+ * different action and state keys. PathRelocator rewrites the text that
+ * goes into those keys: paths under the project root become relative to
+ * it and user prefix mappings (`--path-prefix-map OLD=NEW`, in the spirit
+ * of -fdebug-prefix-map) cover toolchains or SDKs installed elsewhere.
+ *
+ * Only keys are rewritten; the commands that actually run keep their
+ * absolute paths.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_PATH_RELOCATOR_HPP
+#define ARIA_MAKE_PATH_RELOCATOR_HPP
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+class PathRelocator {
+public:
+    PathRelocator() = default;
+    PathRelocator(const fs::path& root,
+                  const std::vector<std::pair<std::string, std::string>>& prefix_map);
+
+    /**
+     * Rewrite every occurrence of a mapped prefix in `text`, which may be a
+     * bare path or a flag with an embedded one (-I/abs/include).
+     * Longer prefixes win over shorter ones.
+     */
+    std::string map(const std::string& text) const;
+    std::vector<std::string> map(const std::vector<std::string>& texts) const;
+
+    /**
+     * Inverse of map() for a bare path: a relative path is taken to be
+     * relative to the root and a mapped prefix is turned back into the
+     * local one. Other paths are returned unchanged.
+     */
+    std::string resolve(const std::string& path) const;
+
+    // Parse "OLD=NEW" (nullopt if there is no '=' or OLD is empty)
+    static std::optional<std::pair<std::string, std::string>> parse_mapping(
+        const std::string& spec);
+
+private:
+    std::string root_;                                         // Without trailing '/'
+    std::vector<std::pair<std::string, std::string>> prefixes_; // Longest first
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_PATH_RELOCATOR_HPP
@@ -0,0 +1,65 @@
+/**
+ * process_runner.hpp
+ * Generic child-process launcher for aria_make
+ *
+ * Runs an arbitrary argv with captured stdout/stderr, an optional working
+ * directory, extra environment variables and a wall-clock timeout. Used for
+ * everything the orchestrator executes that is not a compiler invocation
+ * (test binaries, user commands).
+ *
+ * The child is placed in its own process group so a timeout can kill the
+ * whole tree (test binaries commonly fork helpers).
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_PROCESS_RUNNER_HPP
+#define ARIA_MAKE_PROCESS_RUNNER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+/**
+ * Process specification
+ */
+struct ProcessSpec {
+    std::vector<std::string> argv;        // argv[0] is resolved via PATH
+    fs::path working_dir;                 // Empty = inherit
+    std::vector<std::pair<std::string, std::string>> env;  // Added to inherited env
+    std::chrono::milliseconds timeout{0}; // 0 = no timeout
+    std::vector<int> cpu_affinity;        // CPUs the child may run on (empty = inherit)
+};
+
+/**
+ * Result of running a process
+ */
+struct ProcessResult {
+    int exit_code = -1;                   // 128+N if killed by signal N
+    bool timed_out = false;               // Killed because timeout elapsed
+    std::string stdout_output;
+    std::string stderr_output;
+    std::chrono::milliseconds duration{0};
+    std::chrono::milliseconds cpu_time{0};  // User + system time of the child and its waited-for children
+    uint64_t peak_rss_kb = 0;             // Largest resident set of any of them
+
+    bool success() const { return exit_code == 0 && !timed_out; }
+};
+
+/**
+ * Run a process to completion.
+ *
+ * @throws std::runtime_error on pipe/fork failure (not on non-zero exit)
+ */
+ProcessResult run_process(const ProcessSpec& spec);
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_PROCESS_RUNNER_HPP
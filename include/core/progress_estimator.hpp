@@ -0,0 +1,84 @@
+/**
+ * progress_estimator.hpp
+ * Remaining-time estimates for a running build
+ *
+ * "[3/40]" says little when one of the 40 targets takes most of the time.
+ * The estimator keeps the recorded cost of every target still to build
+ * (see build_simulator.hpp) and, when asked, simulates the rest of the
+ * build from the current moment: running targets with what is left of
+ * their expected time, pending ones behind their unfinished dependencies,
+ * on the build's job slots.
+ *
+ * Recorded times are scaled by how this build is actually going: the
+ * ratio of observed to recorded durations of the targets finished so far
+ * (a loaded machine, a colder cache, or more contention than last time).
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_PROGRESS_ESTIMATOR_HPP
+#define ARIA_MAKE_PROGRESS_ESTIMATOR_HPP
+
+#include "core/build_simulator.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aria::make {
+
+class ProgressEstimator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * `tasks` are the targets of this build (deps index into `tasks`);
+     * `known` marks those whose cost comes from history rather than a
+     * guess. Pools in `config` are honoured; its policy should be the
+     * live scheduler's.
+     */
+    ProgressEstimator(std::vector<SimTask> tasks, std::vector<bool> known, SimConfig config);
+
+    void started(const std::string& name, Clock::time_point now = Clock::now());
+    void finished(const std::string& name, Clock::time_point now = Clock::now());
+
+    /**
+     * Estimated wall time until the last target finishes (nullopt when
+     * there is no history to go on). Thread-safe; results are reused for
+     * a short while so frequent progress updates stay cheap.
+     */
+    std::optional<std::chrono::milliseconds> remaining(Clock::time_point now = Clock::now());
+
+    // Observed / recorded duration of the finished targets (1.0 until known)
+    double speed_factor() const;
+
+private:
+    enum class State { PENDING, RUNNING, DONE };
+
+    // Callers hold mutex_
+    std::optional<std::chrono::milliseconds> estimate(Clock::time_point now) const;
+    double scale() const;
+
+    std::vector<SimTask> tasks_;
+    std::vector<bool> known_;
+    SimConfig config_;
+    std::unordered_map<std::string, size_t> index_;
+    std::vector<State> state_;
+    std::vector<Clock::time_point> started_at_;
+
+    double observed_ms_ = 0;    // Of finished targets with history
+    double recorded_ms_ = 0;
+
+    std::optional<std::chrono::milliseconds> cached_;
+    Clock::time_point cached_at_;
+    bool have_cached_ = false;
+    mutable std::mutex mutex_;
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_PROGRESS_ESTIMATOR_HPP
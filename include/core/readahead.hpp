@@ -0,0 +1,79 @@
+/**
+ * readahead.hpp
+ * Page-cache readahead of the inputs of upcoming jobs
+ *
+ * On a cold cache (a fresh CI runner, a tree larger than memory) a
+ * compile that starts first blocks on reading its sources and headers,
+ * one open() and read() after another. The scheduler knows which targets
+ * run next, so it hands their input paths to a Readahead. One background
+ * thread opens each file and asks the kernel to start reading it
+ * (posix_fadvise(POSIX_FADV_WILLNEED) queues asynchronous readahead and
+ * returns). By the time the compiler opens the file it is usually
+ * resident, and the I/O overlapped with whatever was running.
+ *
+ * Each file is advised once. Files that do not exist yet (outputs of
+ * targets still being built) are skipped and may be hinted again later.
+ * Only the first MAX_ADVISE_BYTES of a file are advised, so one huge
+ * input cannot push everything else out of the cache.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_READAHEAD_HPP
+#define ARIA_MAKE_READAHEAD_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace aria::make {
+
+class Readahead {
+public:
+    static constexpr uint64_t MAX_ADVISE_BYTES = 64ull << 20;
+
+    Readahead();
+
+    // Pending hints are dropped; the thread is joined
+    ~Readahead();
+
+    Readahead(const Readahead&) = delete;
+    Readahead& operator=(const Readahead&) = delete;
+
+    /**
+     * Queue `paths` for readahead, in order (earlier paths are needed
+     * sooner). Paths already advised or queued are ignored. Thread-safe.
+     */
+    void hint(const std::vector<std::string>& paths);
+
+    // Wait until every hint queued so far has been handled
+    void drain();
+
+    size_t files_advised() const;
+    uint64_t bytes_advised() const;
+
+private:
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::string> queue_;
+    std::unordered_set<std::string> known_;     // Queued or advised
+    bool busy_ = false;
+    bool stop_ = false;
+
+    size_t files_advised_ = 0;
+    uint64_t bytes_advised_ = 0;
+
+    std::thread thread_;  // Last: starts once the state above exists
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_READAHEAD_HPP
@@ -0,0 +1,53 @@
+/**
+ * trash.hpp
+ * Instant removal of build trees
+ *
+ * Deleting a multi-GB output directory with hundreds of thousands of
+ * objects takes tens of seconds of unlink() calls. `clean` instead renames
+ * the directory into a trash directory on the same filesystem - a single
+ * atomic step, so a following build sees either the whole old tree or
+ * nothing at all, never a half-deleted one - and leaves the deletion to a
+ * detached helper process that outlives aria_make.
+ *
+ * The helper removes trees with unlinkat() relative to open directory fds
+ * (no repeated path resolution) and works on several subtrees at once.
+ * It empties the whole trash directory, so leftovers of an interrupted
+ * purge are collected by the next one.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_TRASH_HPP
+#define ARIA_MAKE_TRASH_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+/**
+ * Rename `path` into `trash_dir` under a unique name. Fails (returning
+ * false with `error` set) if the two are on different filesystems or the
+ * rename is refused; `path` is then untouched.
+ */
+bool move_to_trash(const fs::path& path, const fs::path& trash_dir, std::string& error);
+
+/**
+ * Empty `trash_dir` in a detached background process and return at once.
+ * Returns false if the helper could not be started.
+ */
+bool purge_trash_async(const fs::path& trash_dir);
+
+/**
+ * Delete a directory tree with unlinkat() over directory fds, using up
+ * to `threads` threads for separate subtrees. Symlinks are removed, never
+ * followed. Returns true if `path` no longer exists.
+ */
+bool remove_tree(const fs::path& path, size_t threads);
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_TRASH_HPP
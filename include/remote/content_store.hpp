@@ -0,0 +1,156 @@
+/**
+ * content_store.hpp
+ * Content-addressable blob store for remote execution
+ *
+ * Blobs are addressed by a Digest: the SHA-256 of the content plus its
+ * size (which lets schedulers price a transfer without reading the blob).
+ * Stores are shared between machines and a key is trusted to name exactly
+ * one content, so it has to be collision resistant; the fast FNV-1a
+ * hashes are only used for local change detection. The store is a plain
+ * directory:
+ *
+ *   <root>/<first two hex digits>/<hash>-<size>
+ *
+ * Writes go through a temporary file and rename(), so concurrent writers
+ * of the same blob are harmless.
+ *
+ * Blobs are stored compressed when that pays (`<key>.z`, zlib). Small
+ * blobs - object files, mostly - share a lot of structure (headers,
+ * section names, runtime symbols) that a single blob is too short to
+ * exploit, so once enough of them have been seen the store trains a
+ * preset dictionary from them (`dict/<id>`) and compresses later small
+ * blobs against it. With chunking enabled, large blobs (archives,
+ * binaries) are cut at content-defined boundaries and stored as a
+ * manifest (`<key>.cdc`) of chunks in `chunks/`, so successive versions
+ * of an archive share the members that did not change. Blobs that do
+ * not compress are stored as is and can still be hardlinked out.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_CONTENT_STORE_HPP
+#define ARIA_MAKE_CONTENT_STORE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+/**
+ * Content digest (hash + size)
+ */
+struct Digest {
+    std::string hash;       // 64 hex digits (SHA-256)
+    uint64_t size = 0;
+
+    std::string key() const { return hash + "-" + std::to_string(size); }
+    bool empty() const { return hash.empty(); }
+
+    bool operator==(const Digest& other) const {
+        return hash == other.hash && size == other.size;
+    }
+    bool operator!=(const Digest& other) const { return !(*this == other); }
+};
+
+/**
+ * How blobs are encoded on disk
+ */
+struct StoreOptions {
+    bool compress = true;                    // zlib (no-op without zlib)
+    bool chunk_large = false;                // Content-defined chunking
+    uint64_t chunk_threshold = 1 << 20;      // Chunk blobs at least this big
+};
+
+/**
+ * Store usage and restore throughput
+ */
+struct StoreStats {
+    size_t blobs = 0;
+    uint64_t logical_bytes = 0;              // Sum of blob sizes
+    uint64_t stored_bytes = 0;               // On disk (chunks, dictionaries included)
+    uint64_t restored_bytes = 0;             // Materialized by this process
+    double restore_seconds = 0.0;
+
+    double ratio() const {
+        return stored_bytes == 0 ? 0.0
+                                 : static_cast<double>(logical_bytes) / stored_bytes;
+    }
+    double restore_mb_per_sec() const {
+        return restore_seconds <= 0.0 ? 0.0
+                                      : restored_bytes / (1024.0 * 1024.0) / restore_seconds;
+    }
+};
+
+class ContentStore {
+public:
+    explicit ContentStore(fs::path root, StoreOptions options = {});
+
+    // Digest helpers (do not touch the store)
+    static Digest digest_bytes(const std::string& data);
+    static Digest digest_file(const fs::path& path);   // Empty digest if unreadable
+
+    const fs::path& root() const { return root_; }
+    const StoreOptions& options() const { return options_; }
+    fs::path path_for(const Digest& digest) const;     // Uncompressed location
+    bool contains(const Digest& digest) const;
+
+    /**
+     * Store a blob. Returns false if `data` does not match `digest`
+     * or the write fails.
+     */
+    bool put(const Digest& digest, const std::string& data);
+
+    /**
+     * Store a file's content and return its digest (empty on failure).
+     */
+    Digest put_file(const fs::path& path);
+
+    std::optional<std::string> read(const Digest& digest) const;
+
+    /**
+     * Place a stored blob at `dest`: hardlink for blobs stored as is
+     * (falling back to copy), decoded copy otherwise.
+     */
+    bool materialize(const Digest& digest, const fs::path& dest, bool executable) const;
+
+    /**
+     * Walk the store for its size on disk; restore figures cover this
+     * process's materialize() calls.
+     */
+    StoreStats stats() const;
+
+    /**
+     * Build a preset dictionary (at most `max_size` bytes) from sample
+     * blobs: the segments whose 8-byte substrings occur in the most
+     * samples, most valuable last (zlib reaches the end more cheaply).
+     */
+    static std::string train_dictionary(const std::vector<std::string>& samples,
+                                        size_t max_size = 32 * 1024);
+
+private:
+    struct Shared;
+
+    enum class Encoding { RAW, COMPRESSED, CHUNKED };
+
+    std::optional<std::pair<fs::path, Encoding>> locate(const fs::path& base,
+                                                        const Digest& digest) const;
+    bool store_blob(const fs::path& base, const Digest& digest,
+                    const std::string& data, bool use_dictionary);
+    std::optional<std::string> load_blob(const fs::path& base, const Digest& digest) const;
+    void sample_for_dictionary(const std::string& data);
+    std::shared_ptr<const std::string> dictionary(const std::string& id) const;
+
+    fs::path root_;
+    StoreOptions options_;
+    std::shared_ptr<Shared> shared_;     // Dictionaries and counters (copies share them)
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_CONTENT_STORE_HPP
@@ -0,0 +1,128 @@
+/**
+ * remote_executor.hpp
+ * Client side of remote execution: ships actions to `aria_make worker`s
+ *
+ * An action is eligible when all of its inputs, outputs and its working
+ * directory lie under the execution root (the directory aria_make runs
+ * in). Paths are sent relative to that root and absolute occurrences of
+ * the root in argv are rewritten, so the worker's scratch directory can
+ * stand in for it.
+ *
+ * Scheduling: the orchestrator only asks for remote execution when every
+ * local slot is busy, passing how long it expects to wait for one. The
+ * executor prices each worker with a free slot as
+ *
+ *   round-trip latency + bytes the worker is missing / measured bandwidth
+ *
+ * (blobs already uploaded to a worker are free) and declines, so the action
+ * waits for a local slot instead, when the cheapest worker costs more than
+ * the local wait.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_REMOTE_EXECUTOR_HPP
+#define ARIA_MAKE_REMOTE_EXECUTOR_HPP
+
+#include "core/action_graph.hpp"
+#include "core/process_runner.hpp"
+#include "remote/content_store.hpp"
+#include "remote/remote_protocol.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+struct RemoteStats {
+    size_t remote_actions = 0;    // Actions executed on a worker
+    size_t blobs_uploaded = 0;
+    size_t blobs_present = 0;     // Inputs the worker already had
+    uint64_t bytes_uploaded = 0;
+};
+
+class RemoteExecutor {
+public:
+    RemoteExecutor(std::vector<Endpoint> endpoints, fs::path exec_root);
+    ~RemoteExecutor();
+
+    RemoteExecutor(const RemoteExecutor&) = delete;
+    RemoteExecutor& operator=(const RemoteExecutor&) = delete;
+
+    /**
+     * Handshake with every worker. Unreachable workers are reported in
+     * `errors` and skipped. Returns the total number of remote slots.
+     */
+    size_t connect(std::vector<std::string>& errors);
+
+    /**
+     * Run `action` on a worker if it is eligible, a worker has a free slot
+     * and the estimated transfer cost does not exceed `local_wait_ms`.
+     * Returns nullopt when the action should run locally instead
+     * (including transport failures, which also retire the worker).
+     */
+    std::optional<ProcessResult> try_execute(const Action& action, double local_wait_ms);
+
+    size_t slots() const;
+    RemoteStats stats() const;
+
+private:
+    struct WorkerState {
+        Endpoint endpoint;
+        bool alive = false;
+        size_t slots = 0;
+        size_t in_flight = 0;
+        std::vector<int> idle_fds;                  // One request per connection
+        std::unordered_set<std::string> known;      // Digest keys the worker has
+        double bytes_per_ms = 50000.0;              // ~50MB/s until measured
+        double rtt_ms = 1.0;
+    };
+
+    struct PreparedInput {
+        RemoteFile file;
+        fs::path local_path;
+    };
+
+    bool prepare(const Action& action, RemoteRequest& request,
+                 std::vector<PreparedInput>& inputs,
+                 std::vector<std::pair<std::string, std::string>>& outputs);
+
+    // Path relative to the execution root ("" if outside it)
+    std::string relativize(const std::string& path) const;
+    std::string rewrite_arg(const std::string& arg) const;
+    Digest cached_digest(const fs::path& path);
+
+    std::optional<ProcessResult> run_on(WorkerState& worker, int fd,
+                                        RemoteRequest& request,
+                                        const std::vector<PreparedInput>& inputs,
+                                        const std::vector<std::pair<std::string, std::string>>& outputs,
+                                        bool& transport_ok);
+
+    std::vector<std::unique_ptr<WorkerState>> workers_;
+    fs::path exec_root_;
+    std::string exec_root_prefix_;                  // exec_root_ + "/"
+
+    mutable std::mutex mutex_;                      // Guards workers_ and stats_
+    RemoteStats stats_;
+
+    // path -> (mtime, size, digest): avoids rehashing unchanged inputs
+    struct DigestEntry {
+        fs::file_time_type mtime;
+        uint64_t size = 0;
+        Digest digest;
+    };
+    std::unordered_map<std::string, DigestEntry> digest_cache_;
+    std::mutex digest_mutex_;
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_REMOTE_EXECUTOR_HPP
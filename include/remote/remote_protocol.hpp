@@ -0,0 +1,161 @@
+/**
+ * remote_protocol.hpp
+ * Wire protocol between aria_make and `aria_make worker` daemons
+ *
+ * Transport: a stream socket (TCP or Unix domain). Each message is
+ *
+ *   u32 type | u64 payload length | payload
+ *
+ * with all integers little-endian. A connection carries one request at a
+ * time; the client opens one connection per concurrently running action.
+ *
+ * Conversation:
+ *   HELLO            -> HELLO_REPLY (protocol version, worker slots)
+ *   FIND_MISSING     -> MISSING     (which of these digests to upload)
+ *   UPLOAD           -> UPLOAD_OK   (one blob, verified against its digest)
+ *   EXECUTE          -> EXECUTE_REPLY (exit status, output, output blobs)
+ *
+ * Any request may instead be answered with ERROR (a message string).
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_REMOTE_PROTOCOL_HPP
+#define ARIA_MAKE_REMOTE_PROTOCOL_HPP
+
+#include "remote/content_store.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aria::make {
+
+constexpr uint32_t REMOTE_PROTOCOL_VERSION = 2;  // 2: SHA-256 digests
+
+enum class MessageType : uint32_t {
+    HELLO = 1,
+    HELLO_REPLY,
+    FIND_MISSING,
+    MISSING,
+    UPLOAD,
+    UPLOAD_OK,
+    EXECUTE,
+    EXECUTE_REPLY,
+    ERROR
+};
+
+// =============================================================================
+// Endpoints
+// =============================================================================
+
+/**
+ * Worker address: "unix:/path/to.sock", "tcp:host:port" or "host:port"
+ */
+struct Endpoint {
+    enum class Kind { TCP, UNIX };
+
+    Kind kind = Kind::TCP;
+    std::string host;       // TCP
+    uint16_t port = 0;      // TCP (0 = any, when listening)
+    std::string path;       // UNIX
+
+    static std::optional<Endpoint> parse(const std::string& spec);
+    std::string to_string() const;
+};
+
+// Returns a connected/listening socket, or -1 with `error` set
+int connect_endpoint(const Endpoint& endpoint, std::string& error);
+int listen_endpoint(const Endpoint& endpoint, std::string& error);
+
+// Port actually bound by a TCP listener (for port 0)
+uint16_t bound_port(int listen_fd);
+
+// =============================================================================
+// Framing
+// =============================================================================
+
+bool send_message(int fd, MessageType type, const std::string& payload);
+bool recv_message(int fd, MessageType& type, std::string& payload);
+
+class WireWriter {
+public:
+    void u32(uint32_t value);
+    void u64(uint64_t value);
+    void str(const std::string& value);
+    void strings(const std::vector<std::string>& values);
+    void digest(const Digest& value);
+
+    const std::string& data() const { return data_; }
+
+private:
+    std::string data_;
+};
+
+/**
+ * Reads what WireWriter wrote.
+ * @throws std::runtime_error on truncated or malformed payloads
+ */
+class WireReader {
+public:
+    explicit WireReader(const std::string& data) : data_(data) {}
+
+    uint32_t u32();
+    uint64_t u64();
+    std::string str();
+    std::vector<std::string> strings();
+    Digest digest();
+
+    bool at_end() const { return pos_ >= data_.size(); }
+
+private:
+    const std::string& data_;
+    size_t pos_ = 0;
+
+    void need(size_t n) const;
+};
+
+// =============================================================================
+// Messages
+// =============================================================================
+
+/**
+ * A file placed in (or collected from) the worker's scratch directory.
+ * Paths are relative to the execution root.
+ */
+struct RemoteFile {
+    std::string path;
+    Digest digest;
+    bool executable = false;
+};
+
+struct RemoteRequest {
+    std::vector<std::string> argv;
+    std::vector<std::pair<std::string, std::string>> env;
+    std::string working_dir;                // Relative to the execution root
+    uint64_t timeout_ms = 0;
+    std::vector<RemoteFile> inputs;
+    std::vector<std::string> outputs;       // Relative paths to collect
+
+    std::string encode() const;
+    static RemoteRequest decode(const std::string& payload);
+};
+
+struct RemoteResponse {
+    int32_t exit_code = -1;
+    bool timed_out = false;
+    std::string stdout_output;
+    std::string stderr_output;
+    uint64_t duration_ms = 0;
+    std::vector<RemoteFile> outputs;        // Produced outputs
+    std::vector<std::string> output_data;   // Blob contents, parallel to outputs
+
+    std::string encode() const;
+    static RemoteResponse decode(const std::string& payload);
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_REMOTE_PROTOCOL_HPP
@@ -0,0 +1,95 @@
+/**
+ * worker.hpp
+ * Remote execution worker (`aria_make worker`)
+ *
+ * Listens on a TCP or Unix socket and executes actions for aria_make
+ * clients. Input blobs live in a content-addressed store under the cache
+ * directory, so a client only uploads what the worker has not seen yet.
+ * Each action runs in a fresh scratch directory that stands in for the
+ * client's execution root: inputs are hardlinked in from the store, the
+ * declared outputs are collected into the store and returned, and the
+ * directory is removed.
+ *
+ * Tools (compilers, ar, sh) are not shipped; workers are expected to have
+ * the same toolchain installed at the same paths as the client.
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#ifndef ARIA_MAKE_WORKER_HPP
+#define ARIA_MAKE_WORKER_HPP
+
+#include "remote/content_store.hpp"
+#include "remote/remote_protocol.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+struct WorkerConfig {
+    Endpoint endpoint;                          // Where to listen
+    fs::path cache_dir = ".aria_make/worker";   // CAS + scratch directories
+    size_t slots = 0;                           // Concurrent actions (0 = usable CPUs)
+    StoreOptions store;                         // Blob encoding in the CAS
+    bool verbose = false;
+};
+
+class Worker {
+public:
+    explicit Worker(WorkerConfig config);
+    ~Worker();
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+    /**
+     * Bind the listening socket. Returns false with `error` set on failure.
+     */
+    bool start(std::string& error);
+
+    /**
+     * Accept and serve connections until stop() is called.
+     */
+    void serve();
+
+    /**
+     * Stop accepting, disconnect clients and let serve() return.
+     */
+    void stop();
+
+    // Listening address (TCP port resolved if 0 was requested)
+    Endpoint endpoint() const;
+    size_t slots() const { return config_.slots; }
+
+private:
+    void handle_connection(int fd);
+    RemoteResponse execute(const RemoteRequest& request);
+
+    WorkerConfig config_;
+    ContentStore store_;
+    int listen_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+
+    // Bounds concurrently running actions to config_.slots
+    std::mutex slot_mutex_;
+    std::condition_variable slot_cv_;
+    size_t running_ = 0;
+
+    std::atomic<uint64_t> next_scratch_{0};
+
+    std::mutex connections_mutex_;
+    std::vector<std::thread> connections_;
+    std::vector<int> connection_fds_;
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_WORKER_HPP
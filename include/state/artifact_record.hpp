@@ -37,6 +37,7 @@ struct ArtifactRecord {
     // Integrity Metrics
     std::string source_hash;      // BLAKE3 hash of source content
     uint64_t command_hash;        // FNV-1a hash of compiler flags
+    std::string output_hash;      // Content hash of the produced outputs (early cutoff)
 
     // Provenance Tracking
     std::vector<DependencyInfo> direct_dependencies;   // Explicit deps (use statements)
@@ -48,18 +49,30 @@ struct ArtifactRecord {
 
     // Build Metrics (for telemetry)
     uint64_t build_duration_ms;   // How long the build took
+    uint64_t cpu_time_ms;         // CPU time of its processes (user + system)
+    uint64_t peak_rss_kb;         // Largest resident set of any of its processes
 
     ArtifactRecord()
         : command_hash(0)
         , source_timestamp(0)
         , build_timestamp(0)
-        , build_duration_ms(0) {}
+        , build_duration_ms(0)
+        , cpu_time_ms(0)
+        , peak_rss_kb(0) {}
 
     bool is_valid() const {
         return !target_name.empty() && !source_hash.empty();
     }
 };
 
+// An output restored by digest only: its content is in the artifact store,
+// not in the working tree, until something needs the bytes
+struct LazyOutput {
+    std::string path;             // Absolute, normalized
+    std::string digest;           // Artifact store key ("<hash>-<size>")
+    bool executable = false;
+};
+
 // Represents the toolchain identity
 struct ToolchainInfo {
     std::string compiler_version;  // e.g., "v0.0.7"
@@ -116,6 +129,8 @@ struct BuildStats {
     size_t failed_targets;
     uint64_t total_time_ms;
     uint64_t hash_time_ms;
+    size_t files_hashed;       // Content hashes computed by reading the file
+    size_t git_index_hits;     // Content hashes taken from the git index
 
     BuildStats()
         : total_targets(0)
@@ -123,7 +138,9 @@ struct BuildStats {
         , cached_targets(0)
         , failed_targets(0)
         , total_time_ms(0)
-        , hash_time_ms(0) {}
+        , hash_time_ms(0)
+        , files_hashed(0)
+        , git_index_hits(0) {}
 
     double cache_hit_rate() const {
         if (total_targets == 0) return 0.0;
@@ -0,0 +1,77 @@
+#ifndef ARIA_MAKE_BATCH_IO_HPP
+#define ARIA_MAKE_BATCH_IO_HPP
+
+// batch_io.hpp - Batched stat and read for dirty checking and hashing
+// Part of aria_make - Aria Build System
+//
+// A dirty check stats and reads every source one file at a time. On a cold
+// page cache or a network filesystem each of those syscalls waits for the
+// device, so the check is bound by latency rather than bandwidth.
+// BatchReader keeps many requests in flight instead:
+//
+// - io_uring: statx, openat and read submitted in batches from one thread;
+//   completed buffers go straight to the caller's sink (the hasher)
+// - threads: a small pool of blocking workers, used where io_uring is not
+//   available (old kernels, seccomp profiles that block it, non-Linux)
+//
+// Both backends produce identical results; only latency differs.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace aria::make {
+
+// Result of stat()ing a path (symlinks followed)
+struct FileStat {
+    bool exists = false;
+    bool regular = false;
+    uint64_t size = 0;
+    int64_t mtime_sec = 0;
+    uint32_t mtime_nsec = 0;
+    int64_t ctime_sec = 0;
+    uint32_t ctime_nsec = 0;
+    uint64_t ino = 0;
+};
+
+enum class IoBackend {
+    AUTO,       // io_uring if the kernel allows it, else threads
+    URING,
+    THREADS
+};
+
+// "auto", "uring", "threads" (nullopt for anything else)
+std::optional<IoBackend> parse_io_backend(const std::string& name);
+
+class BatchReader {
+public:
+    // Receives a file's content in order. Calls for one file never overlap;
+    // calls for different files may run concurrently (threads backend).
+    using ContentSink = std::function<void(size_t index, const char* data, size_t size)>;
+
+    virtual ~BatchReader() = default;
+
+    // Backend actually in use ("io_uring" or "threads")
+    virtual const char* name() const = 0;
+
+    // Stat every path; result[i] belongs to paths[i]
+    virtual std::vector<FileStat> stat_all(const std::vector<std::string>& paths) = 0;
+
+    // Read paths[i] for every i in `selected`, passing the bytes to `sink`.
+    // result[k] is true if selected[k] was read to EOF without error.
+    virtual std::vector<bool> read_all(const std::vector<std::string>& paths,
+                                       const std::vector<size_t>& selected,
+                                       const ContentSink& sink) = 0;
+
+    // URING falls back to threads if io_uring cannot be set up; a reader
+    // whose ring fails later switches to threads for good (name() says so)
+    static std::unique_ptr<BatchReader> create(IoBackend backend = IoBackend::AUTO);
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_BATCH_IO_HPP
@@ -0,0 +1,98 @@
+#ifndef ARIA_MAKE_GIT_INDEX_HPP
+#define ARIA_MAKE_GIT_INDEX_HPP
+
+// git_index.hpp - Read-only view of a git index (.git/index)
+// Part of aria_make - Aria Build System
+//
+// For a tracked file whose stat data still matches its index entry, the
+// entry's blob OID is a content hash git has already computed, so the file
+// does not need to be read. The index is parsed directly (versions 2-4);
+// no git subprocess is involved.
+//
+// A match requires mtime, ctime, inode and size to agree and the entry to
+// be older than the index file itself (git's "racily clean" rule: a file
+// modified within the same timestamp tick as the index write cannot be
+// trusted). Conflicted, assume-unchanged, skip-worktree and intent-to-add
+// entries are never trusted.
+//
+// Only SHA-1 repositories are supported; load() declines SHA-256 ones.
+
+#include "batch_io.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace aria::make {
+
+namespace fs = std::filesystem;
+
+class GitIndex {
+public:
+    // Find the worktree containing `dir` and parse its index.
+    // Returns nullptr if there is none or it cannot be used.
+    static std::shared_ptr<const GitIndex> load(const fs::path& dir);
+
+    // Worktree root (absolute)
+    const fs::path& worktree() const { return worktree_; }
+
+    // Number of usable entries
+    size_t size() const { return entries_.size(); }
+
+    // True if `path` lies inside the worktree
+    bool contains(const fs::path& path) const;
+
+    // Blob OID (hex) if `path` is tracked and unchanged since it was indexed
+    std::optional<std::string> clean_oid(const fs::path& path) const;
+
+    // Same, with stat data the caller already has (from BatchReader)
+    std::optional<std::string> clean_oid(const fs::path& path, const FileStat& st) const;
+
+    // Git blob OID of a file's current content: SHA-1("blob <size>\0" + data)
+    // Empty string if the file cannot be read.
+    static std::string blob_oid(const fs::path& path);
+
+    // blob_oid() for content that arrives in pieces
+    class BlobHasher {
+    public:
+        explicit BlobHasher(uint64_t size);
+        ~BlobHasher();
+        BlobHasher(BlobHasher&&) noexcept;
+        BlobHasher& operator=(BlobHasher&&) noexcept;
+
+        void update(const char* data, size_t len);
+
+        // Hex OID; empty if the bytes fed do not add up to `size`
+        std::string finish();
+
+    private:
+        struct State;
+        std::unique_ptr<State> state_;
+    };
+
+private:
+    struct Entry {
+        uint32_t ctime_sec = 0;
+        uint32_t ctime_nsec = 0;
+        uint32_t mtime_sec = 0;
+        uint32_t mtime_nsec = 0;
+        uint32_t ino = 0;
+        uint32_t size = 0;          // Truncated to 32 bits, as git stores it
+        std::string oid;            // Hex
+    };
+
+    bool parse(const std::string& data);
+    std::optional<std::string> relative(const fs::path& path) const;
+
+    fs::path worktree_;
+    int64_t index_mtime_sec_ = 0;
+    int64_t index_mtime_nsec_ = 0;
+    std::unordered_map<std::string, Entry> entries_;    // Worktree-relative path
+};
+
+} // namespace aria::make
+
+#endif // ARIA_MAKE_GIT_INDEX_HPP
@@ -13,11 +13,15 @@
 // Thread-safe: Uses shared_mutex for concurrent read access
 
 #include "artifact_record.hpp"
+#include "git_index.hpp"
+#include "core/path_relocator.hpp"
 
 #include <filesystem>
 #include <unordered_map>
 #include <unordered_set>
 #include <shared_mutex>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <functional>
 
@@ -101,7 +105,29 @@ public:
         const std::vector<DependencyInfo>& resolved_deps,
         const std::vector<std::string>& implicit_deps,
         const std::vector<std::string>& flags,
-        uint64_t build_duration_ms = 0);
+        uint64_t build_duration_ms = 0,
+        uint64_t cpu_time_ms = 0,
+        uint64_t peak_rss_kb = 0);
+
+    // Record the content hash of a target's outputs after a build.
+    // Returns true if they differ from the previously recorded outputs
+    // (or none were recorded); false means dependents may be cut off.
+    bool update_output_hash(
+        const std::string& target_name,
+        const std::vector<std::string>& output_files);
+
+    // =========================================================================
+    // Lazy Outputs (Thread-Safe)
+    // =========================================================================
+    // Outputs imported by digest only ("build without the bytes"). They
+    // count as present for check_dirty() until materialized or rebuilt.
+    // Kept as "lazy:<path>" records (digest in output_hash, exec bit in
+    // command_hash), so they persist with the rest of the state.
+
+    void record_lazy_output(const LazyOutput& output);
+    std::optional<LazyOutput> lazy_output(const fs::path& path) const;
+    void forget_lazy_output(const fs::path& path);
+    std::vector<LazyOutput> lazy_outputs() const;
 
     // Remove a record (forces rebuild next time)
     void invalidate(const std::string& target_name);
@@ -141,6 +167,34 @@ public:
     // Clear all hash caches
     void clear_hash_cache();
 
+    // Take content hashes of unchanged tracked files from the git index of
+    // the worktree containing `dir` instead of reading them. Files inside
+    // that worktree are then hashed as git blob OIDs ("git:<oid>") whether
+    // or not the index entry matches, so the scheme stays consistent.
+    // Returns false (and changes nothing) if there is no usable index.
+    bool use_git_index(const fs::path& dir);
+
+    // Index in use (null if none)
+    std::shared_ptr<const GitIndex> git_index() const;
+
+    // Hash many files ahead of the checks that need them. Stats and reads
+    // are batched through a BatchReader (io_uring, else a thread pool) and
+    // the results land in the hash cache, so later hash_file()/check_dirty()
+    // calls only confirm the timestamp. Returns the number of hashes added.
+    size_t prefetch_hashes(const std::vector<std::string>& paths);
+
+    // Backend for prefetch_hashes() (default: AUTO)
+    void set_io_backend(IoBackend backend);
+
+    // Backend the last prefetch used ("" if none ran yet)
+    std::string io_backend_name() const;
+
+    // Paths in the state file (artifacts, dependencies, lazy record names)
+    // are written through relocator.map() and read back through resolve(),
+    // so a state file moved to another checkout describes that checkout's
+    // files. Set before load().
+    void set_relocator(PathRelocator relocator) { relocator_ = std::move(relocator); }
+
     // =========================================================================
     // Statistics
     // =========================================================================
@@ -166,6 +220,19 @@ private:
     mutable std::unordered_map<std::string, std::string> hash_cache_;
     mutable std::unordered_map<std::string, uint64_t> timestamp_cache_;
 
+    // Git index (optional) and hashing counters (guarded by cache_mutex_)
+    std::shared_ptr<const GitIndex> git_index_;
+    mutable size_t files_hashed_ = 0;
+    mutable size_t git_index_hits_ = 0;
+
+    // Batched I/O for prefetch_hashes() (created on first use)
+    IoBackend io_backend_ = IoBackend::AUTO;
+    std::unique_ptr<BatchReader> reader_;
+    mutable std::mutex io_mutex_;
+
+    // Checkout-independent form of persisted paths
+    PathRelocator relocator_;
+
     // Build statistics
     mutable BuildStats stats_;
 
@@ -201,6 +268,13 @@ private:
 
     // Get file modification timestamp
     static uint64_t get_file_timestamp(const fs::path& path);
+
+    // Record name of a lazy output (relocated, like the persisted paths)
+    std::string lazy_record_name(const fs::path& path) const;
+
+    // A path as written to / read from the state file
+    std::string portable_path(const fs::path& path) const;
+    fs::path local_path(const std::string& path) const;
 };
 
 } // namespace aria::make
@@ -0,0 +1,387 @@
+/**
+ * cache_bundle.cpp
+ * Implementation of portable cache bundles
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "cache/cache_bundle.hpp"
+#include "core/cpu_topology.hpp"
+#include "remote/remote_protocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+#ifdef ARIA_MAKE_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace aria::make {
+
+namespace {
+
+constexpr char MAGIC[8] = {'A', 'R', 'I', 'A', 'C', 'B', '0', '1'};
+constexpr size_t FRAME_TARGET_BYTES = 4 << 20;
+// Largest frame the writer produces and the reader accepts; a blob record
+// must fit in one frame
+constexpr uint64_t MAX_FRAME_BYTES = uint64_t(1) << 30;
+
+enum class RecordKind : uint32_t {
+    STATE = 1,
+    BLOB = 2,
+    FILE = 3
+};
+
+enum class Compression : uint32_t {
+    NONE = 0,
+    ZLIB = 1
+};
+
+size_t worker_count() {
+    return default_job_count();
+}
+
+// A frame as written: stored == raw means the bytes are not compressed
+struct Frame {
+    uint64_t raw_size = 0;
+    std::string bytes;
+};
+
+Frame compress_frame(std::string raw, Compression compression) {
+    Frame frame;
+    frame.raw_size = raw.size();
+#ifdef ARIA_MAKE_HAS_ZLIB
+    if (compression == Compression::ZLIB) {
+        uLongf bound = compressBound(static_cast<uLong>(raw.size()));
+        std::string packed(bound, '\0');
+        if (compress2(reinterpret_cast<Bytef*>(&packed[0]), &bound,
+                      reinterpret_cast<const Bytef*>(raw.data()),
+                      static_cast<uLong>(raw.size()), Z_BEST_SPEED) == Z_OK &&
+            bound < raw.size()) {
+            packed.resize(bound);
+            frame.bytes = std::move(packed);
+            return frame;
+        }
+    }
+#else
+    (void)compression;
+#endif
+    frame.bytes = std::move(raw);  // Incompressible (or no zlib): store as is
+    return frame;
+}
+
+bool decompress_frame(const Frame& frame, std::string& raw, std::string& error) {
+    if (frame.bytes.size() == frame.raw_size) {
+        raw = frame.bytes;
+        return true;
+    }
+#ifdef ARIA_MAKE_HAS_ZLIB
+    raw.assign(frame.raw_size, '\0');
+    uLongf size = static_cast<uLongf>(frame.raw_size);
+    if (uncompress(reinterpret_cast<Bytef*>(&raw[0]), &size,
+                   reinterpret_cast<const Bytef*>(frame.bytes.data()),
+                   static_cast<uLong>(frame.bytes.size())) != Z_OK ||
+        size != frame.raw_size) {
+        error = "corrupt compressed frame";
+        return false;
+    }
+    return true;
+#else
+    error = "bundle is compressed but aria_make was built without zlib";
+    return false;
+#endif
+}
+
+void write_frame_header(std::ostream& out, uint64_t raw_size, uint64_t stored_size) {
+    WireWriter w;
+    w.u64(raw_size);
+    w.u64(stored_size);
+    out.write(w.data().data(), static_cast<std::streamsize>(w.data().size()));
+}
+
+// Reads in bounded chunks, so a corrupt size fails at end of input
+// instead of being allocated up front
+bool read_exact(std::istream& in, std::string& buffer, size_t size) {
+    constexpr size_t CHUNK_BYTES = 1 << 20;
+    buffer.clear();
+    while (buffer.size() < size) {
+        size_t offset = buffer.size();
+        size_t chunk = std::min(CHUNK_BYTES, size - offset);
+        buffer.resize(offset + chunk);
+        in.read(&buffer[offset], static_cast<std::streamsize>(chunk));
+        if (static_cast<size_t>(in.gcount()) != chunk) return false;
+    }
+    return true;
+}
+
+bool read_file(const fs::path& path, std::string& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    data = oss.str();
+    return true;
+}
+
+// Bundle paths must stay inside the destination
+bool safe_relative(const std::string& path) {
+    fs::path p(path);
+    if (p.empty() || p.is_absolute()) return false;
+    for (const auto& part : p) {
+        if (part == "..") return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool CacheBundle::compression_available() {
+#ifdef ARIA_MAKE_HAS_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CacheBundle::write(std::ostream& out, const std::string& state_json,
+                        const std::vector<BundleFile>& files,
+                        BundleStats& stats, std::string& error) {
+    Compression compression = compression_available() ? Compression::ZLIB : Compression::NONE;
+
+    out.write(MAGIC, sizeof(MAGIC));
+    WireWriter header;
+    header.u32(VERSION);
+    header.u32(static_cast<uint32_t>(compression));
+    out.write(header.data().data(), static_cast<std::streamsize>(header.data().size()));
+
+    // Frames are compressed concurrently and written in order
+    std::deque<std::future<Frame>> pending;
+    size_t max_pending = worker_count();
+
+    auto write_oldest = [&] {
+        Frame frame = pending.front().get();
+        pending.pop_front();
+        write_frame_header(out, frame.raw_size, frame.bytes.size());
+        out.write(frame.bytes.data(), static_cast<std::streamsize>(frame.bytes.size()));
+        stats.raw_bytes += frame.raw_size;
+        stats.stored_bytes += frame.bytes.size() + 16;
+    };
+
+    auto records = std::make_unique<WireWriter>();
+    auto flush = [&] {
+        if (records->data().empty()) return;
+        if (pending.size() >= max_pending) write_oldest();
+        pending.push_back(std::async(std::launch::async, compress_frame,
+                                     records->data(), compression));
+        records = std::make_unique<WireWriter>();
+    };
+
+    records->u32(static_cast<uint32_t>(RecordKind::STATE));
+    records->str(state_json);
+
+    std::unordered_set<std::string> written;
+    for (const auto& file : files) {
+        std::string data;
+        if (!read_file(file.source, data)) continue;
+
+        Digest digest = ContentStore::digest_bytes(data);
+        if (written.insert(digest.key()).second) {
+            // Record overhead: kind, digest and length prefixes
+            if (records->data().size() + data.size() + 1024 > MAX_FRAME_BYTES) flush();
+            if (data.size() + 1024 > MAX_FRAME_BYTES) {
+                error = "file too large for a bundle: " + file.path;
+                pending.clear();
+                return false;
+            }
+            records->u32(static_cast<uint32_t>(RecordKind::BLOB));
+            records->digest(digest);
+            records->str(data);
+            stats.blobs++;
+        }
+
+        std::error_code ec;
+        auto perms = fs::status(file.source, ec).permissions();
+        records->u32(static_cast<uint32_t>(RecordKind::FILE));
+        records->str(file.path);
+        records->digest(digest);
+        records->u32((perms & fs::perms::owner_exec) != fs::perms::none ? 1 : 0);
+        stats.files++;
+
+        if (records->data().size() >= FRAME_TARGET_BYTES) flush();
+    }
+    flush();
+    while (!pending.empty()) write_oldest();
+
+    write_frame_header(out, 0, 0);
+    stats.stored_bytes += sizeof(MAGIC) + header.data().size() + 16;
+
+    out.flush();
+    if (!out) {
+        error = "failed to write bundle";
+        return false;
+    }
+    return true;
+}
+
+bool CacheBundle::read(std::istream& in, ContentStore& store, const fs::path& dest_root,
+                       std::string& state_json, BundleStats& stats, std::string& error,
+                       const std::function<bool(const std::string&)>& defer,
+                       std::vector<BundleEntry>* deferred) {
+    std::string buffer;
+    if (!read_exact(in, buffer, sizeof(MAGIC) + 8) ||
+        !std::equal(MAGIC, MAGIC + sizeof(MAGIC), buffer.begin())) {
+        error = "not an aria_make cache bundle";
+        return false;
+    }
+    std::string header = buffer.substr(sizeof(MAGIC));
+    WireReader header_reader(header);
+    uint32_t version = header_reader.u32();
+    if (version != VERSION) {
+        error = "unsupported bundle version " + std::to_string(version);
+        return false;
+    }
+
+    // Phase 1: decompress frames in parallel, storing blobs as they come
+    std::mutex mutex;
+    std::vector<BundleEntry> file_records;
+    std::string first_error;
+
+    auto process = [&](Frame frame) {
+        std::string raw;
+        std::string frame_error;
+        bool ok = decompress_frame(frame, raw, frame_error);
+
+        std::vector<BundleEntry> local_files;
+        size_t blobs = 0;
+        if (ok) {
+            try {
+                WireReader r(raw);
+                while (!r.at_end()) {
+                    auto kind = static_cast<RecordKind>(r.u32());
+                    if (kind == RecordKind::STATE) {
+                        std::string json = r.str();
+                        std::lock_guard<std::mutex> lock(mutex);
+                        state_json = std::move(json);
+                    } else if (kind == RecordKind::BLOB) {
+                        Digest digest = r.digest();
+                        std::string data = r.str();
+                        if (!store.contains(digest) && !store.put(digest, data)) {
+                            throw std::runtime_error("blob " + digest.key() + " is corrupt");
+                        }
+                        blobs++;
+                    } else if (kind == RecordKind::FILE) {
+                        BundleEntry record;
+                        record.path = r.str();
+                        record.digest = r.digest();
+                        record.executable = r.u32() != 0;
+                        local_files.push_back(std::move(record));
+                    } else {
+                        throw std::runtime_error("unknown record kind");
+                    }
+                }
+            } catch (const std::exception& e) {
+                ok = false;
+                frame_error = e.what();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ok && first_error.empty()) first_error = frame_error;
+        stats.blobs += blobs;
+        file_records.insert(file_records.end(),
+                            std::make_move_iterator(local_files.begin()),
+                            std::make_move_iterator(local_files.end()));
+    };
+
+    std::deque<std::future<void>> pending;
+    size_t max_pending = worker_count();
+    while (true) {
+        if (!read_exact(in, buffer, 16)) {
+            error = "truncated bundle";
+            break;
+        }
+        WireReader r(buffer);
+        Frame frame;
+        frame.raw_size = r.u64();
+        uint64_t stored_size = r.u64();
+        if (frame.raw_size == 0 && stored_size == 0) break;
+
+        // Frames are never stored larger than raw (see compress_frame)
+        if (frame.raw_size > MAX_FRAME_BYTES || stored_size > frame.raw_size) {
+            error = "truncated bundle";
+            break;
+        }
+        if (!read_exact(in, frame.bytes, stored_size)) {
+            error = "truncated bundle";
+            break;
+        }
+        stats.raw_bytes += frame.raw_size;
+        stats.stored_bytes += stored_size + 16;
+
+        if (pending.size() >= max_pending) {
+            pending.front().get();
+            pending.pop_front();
+        }
+        pending.push_back(std::async(std::launch::async, process, std::move(frame)));
+    }
+    for (auto& task : pending) task.get();
+    stats.stored_bytes += sizeof(MAGIC) + header.size() + 16;
+
+    if (error.empty() && !first_error.empty()) error = first_error;
+    if (!error.empty()) return false;
+
+    // Deferred files stay in the store; their digests go to the caller
+    if (defer) {
+        auto lazy = std::stable_partition(file_records.begin(), file_records.end(),
+                                          [&](const BundleEntry& record) {
+                                              return !(safe_relative(record.path) &&
+                                                       defer(record.path));
+                                          });
+        stats.deferred += static_cast<size_t>(file_records.end() - lazy);
+        if (deferred) {
+            deferred->insert(deferred->end(), lazy, file_records.end());
+        }
+        file_records.erase(lazy, file_records.end());
+    }
+
+    // Phase 2: materialize (every blob is stored by now)
+    std::vector<std::future<void>> placers;
+    size_t workers = std::min(worker_count(), std::max<size_t>(file_records.size(), 1));
+    std::atomic<size_t> next{0};
+    for (size_t w = 0; w < workers; ++w) {
+        placers.push_back(std::async(std::launch::async, [&] {
+            for (size_t i = next++; i < file_records.size(); i = next++) {
+                const BundleEntry& record = file_records[i];
+                bool ok = safe_relative(record.path) &&
+                          store.materialize(record.digest, dest_root / record.path,
+                                            record.executable);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ok) {
+                    stats.files++;
+                } else if (first_error.empty()) {
+                    first_error = "cannot place " + record.path;
+                }
+            }
+        }));
+    }
+    for (auto& placer : placers) placer.get();
+
+    if (!first_error.empty()) {
+        error = first_error;
+        return false;
+    }
+    return true;
+}
+
+} // namespace aria::make
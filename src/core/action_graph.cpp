@@ -0,0 +1,205 @@
+/**
+ * action_graph.cpp
+ * Implementation of the action-graph IR
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/action_graph.hpp"
+#include "state/state_manager.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace aria::make {
+
+const char* action_kind_to_string(ActionKind kind) {
+    switch (kind) {
+        case ActionKind::COMPILE: return "compile";
+        case ActionKind::ARCHIVE: return "archive";
+        case ActionKind::LINK:    return "link";
+        case ActionKind::TEST:    return "test";
+        case ActionKind::COMMAND: return "command";
+    }
+    return "unknown";
+}
+
+size_t ActionGraph::add(Action action, const std::string& target) {
+    action.hash = compute_hash(action, relocator_);
+
+    auto existing = by_hash_.find(action.hash);
+    if (existing != by_hash_.end()) {
+        Action& shared = actions_[existing->second];
+        if (std::find(shared.targets.begin(), shared.targets.end(), target) ==
+            shared.targets.end()) {
+            shared.targets.push_back(target);
+            by_target_[target].push_back(shared.id);
+        }
+        return shared.id;
+    }
+
+    action.id = actions_.size();
+    action.targets = {target};
+    by_hash_[action.hash] = action.id;
+    for (const auto& output : action.outputs) {
+        by_output_[output] = action.id;
+    }
+    by_target_[target].push_back(action.id);
+    actions_.push_back(std::move(action));
+    return actions_.back().id;
+}
+
+void ActionGraph::add_dependency(size_t action, size_t dep) {
+    if (action == dep) return;
+    auto& deps = actions_[action].deps;
+    if (std::find(deps.begin(), deps.end(), dep) == deps.end()) {
+        deps.push_back(dep);
+    }
+}
+
+const std::vector<size_t>& ActionGraph::actions_for(const std::string& target) const {
+    static const std::vector<size_t> none;
+    auto it = by_target_.find(target);
+    return it != by_target_.end() ? it->second : none;
+}
+
+std::optional<size_t> ActionGraph::producer(const std::string& output) const {
+    auto it = by_output_.find(output);
+    if (it == by_output_.end()) return std::nullopt;
+    return it->second;
+}
+
+void ActionGraph::clear() {
+    actions_.clear();
+    by_hash_.clear();
+    by_output_.clear();
+    by_target_.clear();
+}
+
+std::string ActionGraph::compute_hash(const Action& action, const PathRelocator& relocator) {
+    // Sections are separated by markers so that moving a string from one
+    // list to the next changes the digest
+    std::vector<std::string> parts;
+    parts.push_back(action_kind_to_string(action.kind));
+    parts.push_back("\x01argv");
+    for (const auto& arg : action.argv) {
+        parts.push_back(relocator.map(arg));
+    }
+    parts.push_back("\x01" "env");
+    for (const auto& [key, value] : action.env) {
+        parts.push_back(key + "=" + relocator.map(value));
+    }
+    parts.push_back("\x01" "cwd");
+    parts.push_back(action.working_dir.empty() ? "" : relocator.map(action.working_dir.string()));
+    parts.push_back("\x01in");
+    for (const auto& input : action.inputs) {
+        parts.push_back(relocator.map(input));
+    }
+    parts.push_back("\x01out");
+    for (const auto& output : action.outputs) {
+        parts.push_back(relocator.map(output));
+    }
+    parts.push_back("\x01" "depfile");
+    parts.push_back(action.depfile.empty() ? "" : relocator.map(action.depfile));
+    parts.push_back("\x01timeout");
+    parts.push_back(std::to_string(action.timeout.count()));
+
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0') << std::setw(16)
+        << StateManager::hash_flags(parts);
+    return oss.str();
+}
+
+// =============================================================================
+// JSON Serialization
+// =============================================================================
+
+namespace {
+
+std::string json_escape(const std::string& str) {
+    std::ostringstream oss;
+    for (unsigned char c : str) {
+        switch (c) {
+            case '"':  oss << "\\\""; break;
+            case '\\': oss << "\\\\"; break;
+            case '\n': oss << "\\n"; break;
+            case '\t': oss << "\\t"; break;
+            case '\r': oss << "\\r"; break;
+            default:
+                if (c < 0x20) {
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(c) << std::dec;
+                } else {
+                    oss << c;
+                }
+        }
+    }
+    return oss.str();
+}
+
+void write_string_array(std::ostringstream& oss, const std::vector<std::string>& values) {
+    oss << "[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) oss << ", ";
+        oss << "\"" << json_escape(values[i]) << "\"";
+    }
+    oss << "]";
+}
+
+} // namespace
+
+std::string ActionGraph::to_json() const {
+    std::ostringstream oss;
+    oss << "{\n";
+    oss << "  \"actions\": [";
+
+    for (size_t i = 0; i < actions_.size(); ++i) {
+        const Action& action = actions_[i];
+        oss << (i > 0 ? ",\n" : "\n");
+        oss << "    {\n";
+        oss << "      \"id\": " << action.id << ",\n";
+        oss << "      \"kind\": \"" << action_kind_to_string(action.kind) << "\",\n";
+        oss << "      \"hash\": \"" << action.hash << "\",\n";
+        oss << "      \"targets\": ";
+        write_string_array(oss, action.targets);
+        oss << ",\n";
+        oss << "      \"argv\": ";
+        write_string_array(oss, action.argv);
+        oss << ",\n";
+
+        oss << "      \"env\": {";
+        for (size_t e = 0; e < action.env.size(); ++e) {
+            if (e > 0) oss << ", ";
+            oss << "\"" << json_escape(action.env[e].first) << "\": \""
+                << json_escape(action.env[e].second) << "\"";
+        }
+        oss << "},\n";
+
+        oss << "      \"working_dir\": \"" << json_escape(action.working_dir.string()) << "\",\n";
+        oss << "      \"inputs\": ";
+        write_string_array(oss, action.inputs);
+        oss << ",\n";
+        oss << "      \"outputs\": ";
+        write_string_array(oss, action.outputs);
+        oss << ",\n";
+
+        oss << "      \"deps\": [";
+        for (size_t d = 0; d < action.deps.size(); ++d) {
+            if (d > 0) oss << ", ";
+            oss << action.deps[d];
+        }
+        oss << "],\n";
+
+        oss << "      \"pool\": \"" << json_escape(action.resources.pool) << "\",\n";
+        oss << "      \"cpus\": " << action.resources.cpus << ",\n";
+        oss << "      \"timeout_ms\": " << action.timeout.count() << "\n";
+        oss << "    }";
+    }
+
+    oss << (actions_.empty() ? "]\n" : "\n  ]\n");
+    oss << "}\n";
+    return oss.str();
+}
+
+} // namespace aria::make
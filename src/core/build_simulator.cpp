@@ -0,0 +1,202 @@
+/**
+ * build_simulator.cpp
+ * Implementation of the offline build schedule simulator
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/build_simulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace aria::make {
+
+namespace {
+
+// Recorded CPU parallelism of a task
+size_t task_width(const SimTask& task) {
+    if (task.wall_ms <= 0 || task.cpu_ms <= task.wall_ms) return 1;
+    return std::max<size_t>(1, static_cast<size_t>(std::lround(task.cpu_ms / task.wall_ms)));
+}
+
+std::vector<std::vector<size_t>> dependents_of(const std::vector<SimTask>& tasks) {
+    std::vector<std::vector<size_t>> dependents(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        for (size_t dep : tasks[i].deps) {
+            dependents[dep].push_back(i);
+        }
+    }
+    return dependents;
+}
+
+// Tasks with every dependency before them
+std::vector<size_t> topological_order(const std::vector<SimTask>& tasks,
+                                      const std::vector<std::vector<size_t>>& dependents) {
+    std::vector<size_t> waiting(tasks.size());
+    std::vector<size_t> order;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        waiting[i] = tasks[i].deps.size();
+        if (waiting[i] == 0) order.push_back(i);
+    }
+    for (size_t k = 0; k < order.size(); ++k) {
+        for (size_t dependent : dependents[order[k]]) {
+            if (--waiting[dependent] == 0) order.push_back(dependent);
+        }
+    }
+    return order;
+}
+
+} // namespace
+
+std::optional<SchedulePolicy> parse_schedule_policy(const std::string& name) {
+    if (name == "fifo") return SchedulePolicy::FIFO;
+    if (name == "critical-path") return SchedulePolicy::CRITICAL_PATH;
+    if (name == "longest") return SchedulePolicy::LONGEST_FIRST;
+    return std::nullopt;
+}
+
+const char* schedule_policy_to_string(SchedulePolicy policy) {
+    switch (policy) {
+        case SchedulePolicy::FIFO:          return "fifo";
+        case SchedulePolicy::CRITICAL_PATH: return "critical-path";
+        case SchedulePolicy::LONGEST_FIRST: return "longest";
+    }
+    return "fifo";
+}
+
+CriticalPath critical_path(const std::vector<SimTask>& tasks) {
+    auto dependents = dependents_of(tasks);
+    auto order = topological_order(tasks, dependents);
+
+    // finish[i]: earliest finish of task i with unlimited slots
+    std::vector<double> finish(tasks.size(), 0.0);
+    std::vector<size_t> via(tasks.size(), tasks.size());
+    for (size_t i : order) {
+        double start = 0;
+        for (size_t dep : tasks[i].deps) {
+            if (via[i] == tasks.size() || finish[dep] > start) {
+                start = finish[dep];
+                via[i] = dep;
+            }
+        }
+        finish[i] = start + tasks[i].wall_ms;
+    }
+
+    CriticalPath path;
+    if (tasks.empty()) return path;
+    size_t last = static_cast<size_t>(
+        std::max_element(finish.begin(), finish.end()) - finish.begin());
+    path.length_ms = finish[last];
+    for (size_t i = last; i != tasks.size(); i = via[i]) {
+        path.tasks.push_back(i);
+    }
+    std::reverse(path.tasks.begin(), path.tasks.end());
+    return path;
+}
+
+SimResult simulate_build(const std::vector<SimTask>& tasks, const SimConfig& config) {
+    SimResult result;
+    size_t jobs = std::max<size_t>(1, config.jobs);
+    auto dependents = dependents_of(tasks);
+
+    // Effective slots, duration and memory of each task under this config
+    std::vector<size_t> slots(tasks.size());
+    std::vector<double> duration(tasks.size());
+    std::vector<uint64_t> memory(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        size_t width = task_width(tasks[i]);
+        slots[i] = std::min(width, jobs);
+        duration[i] = tasks[i].wall_ms * static_cast<double>(width) / static_cast<double>(slots[i]);
+        memory[i] = tasks[i].peak_rss_kb * slots[i];
+    }
+
+    // Priority: larger runs first; FIFO uses the (negated) ready sequence
+    std::vector<double> priority(tasks.size(), 0.0);
+    if (config.policy == SchedulePolicy::CRITICAL_PATH) {
+        auto order = topological_order(tasks, dependents);
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            double rest = 0;
+            for (size_t dependent : dependents[*it]) rest = std::max(rest, priority[dependent]);
+            priority[*it] = duration[*it] + rest;
+        }
+    } else if (config.policy == SchedulePolicy::LONGEST_FIRST) {
+        priority = duration;
+    }
+
+    std::vector<size_t> waiting(tasks.size());
+    std::vector<size_t> ready;
+    double sequence = 0;
+    auto make_ready = [&](size_t i) {
+        if (config.policy == SchedulePolicy::FIFO) priority[i] = -(sequence++);
+        ready.push_back(i);
+    };
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        waiting[i] = tasks[i].deps.size();
+        if (waiting[i] == 0) make_ready(i);
+    }
+
+    using Finish = std::pair<double, size_t>;
+    std::priority_queue<Finish, std::vector<Finish>, std::greater<Finish>> running;
+    std::unordered_map<std::string, size_t> pool_used;
+    size_t free_slots = jobs;
+    uint64_t memory_used = 0;
+    double now = 0;
+
+    auto fits = [&](size_t i) {
+        if (slots[i] > free_slots) return false;
+        auto depth = config.pool_depths.find(tasks[i].pool);
+        if (depth != config.pool_depths.end() && pool_used[tasks[i].pool] >= depth->second) {
+            return false;
+        }
+        // A task larger than the limit still runs, alone
+        return config.memory_limit_kb == 0 || running.empty() ||
+               memory_used + memory[i] <= config.memory_limit_kb;
+    };
+
+    while (!ready.empty() || !running.empty()) {
+        std::stable_sort(ready.begin(), ready.end(),
+                         [&](size_t a, size_t b) { return priority[a] > priority[b]; });
+        std::vector<size_t> blocked;
+        for (size_t i : ready) {
+            if (!fits(i)) {
+                blocked.push_back(i);
+                continue;
+            }
+            free_slots -= slots[i];
+            memory_used += memory[i];
+            ++pool_used[tasks[i].pool];
+            running.emplace(now + duration[i], i);
+            result.work_ms += duration[i] * static_cast<double>(slots[i]);
+        }
+        ready = std::move(blocked);
+        result.peak_slots = std::max(result.peak_slots, jobs - free_slots);
+        result.peak_memory_kb = std::max(result.peak_memory_kb, memory_used);
+
+        if (running.empty()) break;     // Only if the graph has a cycle
+
+        // Retire everything finishing at the next event time
+        now = running.top().first;
+        while (!running.empty() && running.top().first <= now) {
+            size_t i = running.top().second;
+            running.pop();
+            free_slots += slots[i];
+            memory_used -= memory[i];
+            --pool_used[tasks[i].pool];
+            for (size_t dependent : dependents[i]) {
+                if (--waiting[dependent] == 0) make_ready(dependent);
+            }
+        }
+    }
+
+    result.makespan_ms = now;
+    if (now > 0) {
+        result.utilization = result.work_ms / (static_cast<double>(jobs) * now);
+    }
+    return result;
+}
+
+} // namespace aria::make
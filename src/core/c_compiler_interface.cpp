@@ -57,6 +57,12 @@ std::vector<std::string> CCompilerInterface::build_compile_args(
         args.push_back("-fPIC");
     }
     
+    // Headers compiled on their own become a precompiled header
+    if (task.precompile_header) {
+        args.push_back("-x");
+        args.push_back(is_cpp_ ? "c++-header" : "c-header");
+    }
+    
     // Add source files
     for (const auto& source : task.sources) {
         args.push_back(source);
@@ -85,9 +91,41 @@ std::vector<std::string> CCompilerInterface::build_compile_args(
         args.push_back(flag);
     }
     
+    // Debug info in .dwo files next to the object
+    if (task.split_debug) {
+        args.push_back("-gsplit-dwarf");
+    }
+    
+    // Precompiled header, included ahead of each source. GCC is given the
+    // header name and picks up the adjacent .gch.
+    if (!task.pch.empty()) {
+        if (is_clang()) {
+            args.push_back("-include-pch");
+            args.push_back(task.pch);
+        } else {
+            const std::string ext = pch_extension();
+            std::string header = task.pch;
+            if (header.size() > ext.size() &&
+                header.compare(header.size() - ext.size(), ext.size(), ext) == 0) {
+                header.resize(header.size() - ext.size());
+            }
+            args.push_back("-include");
+            args.push_back(header);
+        }
+    }
+    
     return args;
 }
 
+std::string CCompilerInterface::pch_extension() const {
+    return is_clang() ? ".pch" : ".gch";
+}
+
+bool CCompilerInterface::is_clang() const {
+    std::string name = compiler_path_.substr(compiler_path_.find_last_of('/') + 1);
+    return name.find("clang") != std::string::npos;
+}
+
 std::vector<std::string> CCompilerInterface::build_archive_args(
     const LibraryTask& task
 ) const {
@@ -120,6 +158,12 @@ std::vector<std::string> CCompilerInterface::build_shared_args(
     
     // Shared library flag
     args.push_back("-shared");
+    if (!task.soname.empty()) {
+        args.push_back("-Wl,-soname," + task.soname);
+    }
+    for (const auto& flag : task.flags) {
+        args.push_back(flag);
+    }
     
     // Output file
     args.push_back("-o");
@@ -142,6 +186,14 @@ std::vector<std::string> CCompilerInterface::build_shared_args(
         args.push_back(lib);
     }
     
+    // Linker choice; BFD ld cannot write a gdb index
+    if (!task.linker.empty()) {
+        args.push_back("-fuse-ld=" + task.linker);
+        if (task.split_debug && task.linker != "bfd") {
+            args.push_back("-Wl,--gdb-index");
+        }
+    }
+    
     return args;
 }
 
@@ -62,14 +62,18 @@ std::vector<std::string> CompilerInterface::build_command_args(
     
     // Detect special output types from extension
     const std::string& output = task.output;
+    bool linking = std::find(task.flags.begin(), task.flags.end(), "-c") == task.flags.end();
     if (output.size() >= 3) {
         std::string ext = output.substr(output.size() - 3);
         if (ext == ".ll") {
             args.push_back("--emit-llvm");
+            linking = false;
         } else if (ext == ".bc") {
             args.push_back("--emit-llvm-bc");
+            linking = false;
         } else if (output.size() >= 2 && output.substr(output.size() - 2) == ".s") {
             args.push_back("--emit-asm");
+            linking = false;
         }
     }
     
@@ -84,6 +88,18 @@ std::vector<std::string> CompilerInterface::build_command_args(
         args.push_back(flag);
     }
     
+    // Debug info goes to .dwo files the linker never reads; the index
+    // keeps gdb start-up fast (BFD ld cannot write one)
+    if (task.split_debug) {
+        args.push_back("-gsplit-dwarf");
+    }
+    if (linking && !task.linker.empty()) {
+        args.push_back("-fuse-ld=" + task.linker);
+        if (task.split_debug && task.linker != "bfd") {
+            args.push_back("-Wl,--gdb-index");
+        }
+    }
+    
     return args;
 }
 
@@ -0,0 +1,203 @@
+/**
+ * cpu_topology.cpp
+ * Implementation of usable-CPU detection and job placement groups
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/cpu_topology.hpp"
+
+#include <sched.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace aria::make {
+
+namespace {
+
+std::string read_first_line(const fs::path& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+// quota/period from a cpu.max line ("max 100000" = unlimited)
+std::optional<double> parse_cpu_max(const std::string& line) {
+    std::istringstream in(line);
+    std::string quota;
+    long long period = 0;
+    if (!(in >> quota >> period) || quota == "max" || period <= 0) {
+        return std::nullopt;
+    }
+    try {
+        long long q = std::stoll(quota);
+        if (q <= 0) return std::nullopt;
+        return static_cast<double>(q) / static_cast<double>(period);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+// Last-level data/unified cache of a CPU, as its shared_cpu_list
+std::optional<std::string> last_level_cache(const fs::path& sysfs_cpu_root, int cpu) {
+    fs::path cache_dir = sysfs_cpu_root / ("cpu" + std::to_string(cpu)) / "cache";
+    std::error_code ec;
+    if (!fs::is_directory(cache_dir, ec)) return std::nullopt;
+
+    int best_level = 0;
+    std::string shared;
+    for (const auto& entry : fs::directory_iterator(cache_dir, ec)) {
+        if (entry.path().filename().string().rfind("index", 0) != 0) continue;
+        if (read_first_line(entry.path() / "type") == "Instruction") continue;
+        int level = 0;
+        try {
+            level = std::stoi(read_first_line(entry.path() / "level"));
+        } catch (const std::exception&) {
+            continue;
+        }
+        if (level > best_level) {
+            best_level = level;
+            shared = read_first_line(entry.path() / "shared_cpu_list");
+        }
+    }
+    if (shared.empty()) return std::nullopt;
+    return shared;
+}
+
+} // namespace
+
+std::optional<CpuPinning> parse_cpu_pinning(const std::string& name) {
+    if (name == "none") return CpuPinning::NONE;
+    if (name == "core") return CpuPinning::CORE;
+    if (name == "cache") return CpuPinning::CACHE;
+    return std::nullopt;
+}
+
+const char* cpu_pinning_to_string(CpuPinning pinning) {
+    switch (pinning) {
+        case CpuPinning::NONE:  return "none";
+        case CpuPinning::CORE:  return "core";
+        case CpuPinning::CACHE: return "cache";
+    }
+    return "none";
+}
+
+std::vector<int> parse_cpu_list(const std::string& text) {
+    std::set<int> cpus;
+    std::istringstream in(text);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        part.erase(std::remove_if(part.begin(), part.end(), ::isspace), part.end());
+        if (part.empty()) continue;
+        try {
+            size_t dash = part.find('-');
+            int first = std::stoi(part.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(part.substr(dash + 1));
+            if (first < 0 || last < first) continue;
+            for (int cpu = first; cpu <= last; ++cpu) cpus.insert(cpu);
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return {cpus.begin(), cpus.end()};
+}
+
+std::vector<int> affinity_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+std::optional<double> cgroup_cpu_limit(const fs::path& cgroup_root,
+                                       const fs::path& proc_cgroup) {
+    // cgroup v2 has a single "0::<path>" line
+    std::ifstream in(proc_cgroup);
+    std::string line;
+    std::string relative;
+    bool found = false;
+    while (std::getline(in, line)) {
+        if (line.rfind("0::", 0) == 0) {
+            relative = line.substr(3);
+            found = true;
+            break;
+        }
+    }
+    if (!found) return std::nullopt;
+
+    // Every ancestor's quota applies; the tightest one wins
+    std::optional<double> limit;
+    fs::path dir = fs::path(relative).relative_path();
+    while (true) {
+        std::error_code ec;
+        fs::path cpu_max = cgroup_root / dir / "cpu.max";
+        if (fs::exists(cpu_max, ec)) {
+            auto cpus = parse_cpu_max(read_first_line(cpu_max));
+            if (cpus && (!limit || *cpus < *limit)) limit = cpus;
+        }
+        if (dir.empty()) break;
+        dir = dir.parent_path();
+    }
+    return limit;
+}
+
+size_t default_job_count() {
+    size_t jobs = affinity_cpus().size();
+    if (jobs == 0) jobs = std::thread::hardware_concurrency();
+    if (jobs == 0) jobs = 4;
+
+    if (auto limit = cgroup_cpu_limit()) {
+        size_t quota = static_cast<size_t>(std::ceil(*limit));
+        jobs = std::min(jobs, std::max<size_t>(quota, 1));
+    }
+    return jobs;
+}
+
+std::vector<std::vector<int>> cpu_placement_groups(CpuPinning pinning,
+                                                   const std::vector<int>& cpus,
+                                                   const fs::path& sysfs_cpu_root) {
+    std::vector<std::vector<int>> groups;
+    if (pinning == CpuPinning::NONE) return groups;
+
+    if (pinning == CpuPinning::CORE) {
+        for (int cpu : cpus) groups.push_back({cpu});
+        return groups;
+    }
+
+    // Group by the cache's sharing list, restricted to usable CPUs
+    std::set<int> usable(cpus.begin(), cpus.end());
+    std::map<std::string, size_t> by_cache;
+    for (int cpu : cpus) {
+        auto shared = last_level_cache(sysfs_cpu_root, cpu);
+        if (!shared) {
+            groups.push_back({cpu});
+            continue;
+        }
+        auto [it, inserted] = by_cache.emplace(*shared, groups.size());
+        if (inserted) {
+            std::vector<int> group;
+            for (int member : parse_cpu_list(*shared)) {
+                if (usable.count(member)) group.push_back(member);
+            }
+            if (group.empty()) group.push_back(cpu);
+            groups.push_back(std::move(group));
+        }
+    }
+    return groups;
+}
+
+} // namespace aria::make
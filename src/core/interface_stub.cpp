@@ -0,0 +1,228 @@
+/**
+ * interface_stub.cpp
+ * Implementation of shared library interface stubs (ELF .dynsym reader)
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/interface_stub.hpp"
+
+#include <elf.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace aria::make {
+
+namespace {
+
+template <typename T>
+bool read_at(const std::string& data, uint64_t offset, T& out) {
+    if (offset > data.size() || data.size() - offset < sizeof(T)) return false;
+    std::memcpy(&out, data.data() + offset, sizeof(T));
+    return true;
+}
+
+// NUL-terminated string `index` bytes into a string table section
+struct StringTable {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+
+    std::string at(const std::string& data, uint64_t index) const {
+        if (index >= size || offset > data.size() || data.size() - offset < size) return "";
+        const char* start = data.data() + offset + index;
+        return std::string(start, strnlen(start, size - index));
+    }
+};
+
+const char* symbol_kind(unsigned type) {
+    switch (type) {
+        case STT_FUNC:      return "func";
+        case STT_GNU_IFUNC: return "ifunc";
+        case STT_OBJECT:    return "object";
+        case STT_COMMON:    return "object";
+        case STT_TLS:       return "tls";
+        default:            return "notype";
+    }
+}
+
+template <typename Ehdr, typename Shdr, typename Sym, typename Dyn>
+bool parse_elf(const std::string& data, std::string& soname,
+               std::vector<std::string>& symbols, std::string& error) {
+    Ehdr ehdr;
+    if (!read_at(data, 0, ehdr) || ehdr.e_shentsize != sizeof(Shdr)) {
+        error = "malformed ELF header";
+        return false;
+    }
+
+    std::vector<Shdr> sections(ehdr.e_shnum);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (!read_at(data, ehdr.e_shoff + i * sizeof(Shdr), sections[i])) {
+            error = "truncated section headers";
+            return false;
+        }
+    }
+    auto strings_of = [&](const Shdr& section) {
+        StringTable table;
+        if (section.sh_link < sections.size()) {
+            table.offset = sections[section.sh_link].sh_offset;
+            table.size = sections[section.sh_link].sh_size;
+        }
+        return table;
+    };
+
+    const Shdr* dynsym = nullptr;
+    const Shdr* versym = nullptr;
+    const Shdr* verdef = nullptr;
+    const Shdr* dynamic = nullptr;
+    for (const auto& section : sections) {
+        switch (section.sh_type) {
+            case SHT_DYNSYM:      dynsym = &section; break;
+            case SHT_GNU_versym:  versym = &section; break;
+            case SHT_GNU_verdef:  verdef = &section; break;
+            case SHT_DYNAMIC:     dynamic = &section; break;
+            default: break;
+        }
+    }
+    if (!dynsym) {
+        error = "no dynamic symbol table";
+        return false;
+    }
+
+    // Version names by index; the base definition is the library itself
+    std::unordered_map<uint16_t, std::string> versions;
+    if (verdef) {
+        StringTable names = strings_of(*verdef);
+        uint64_t offset = verdef->sh_offset;
+        for (uint64_t n = 0; n < verdef->sh_info; ++n) {
+            Elf64_Verdef def;
+            Elf64_Verdaux aux;
+            if (!read_at(data, offset, def) || !read_at(data, offset + def.vd_aux, aux)) break;
+            if (!(def.vd_flags & VER_FLG_BASE)) {
+                versions[def.vd_ndx] = names.at(data, aux.vda_name);
+            }
+            if (def.vd_next == 0) break;
+            offset += def.vd_next;
+        }
+    }
+
+    StringTable names = strings_of(*dynsym);
+    uint64_t count = dynsym->sh_entsize ? dynsym->sh_size / dynsym->sh_entsize : 0;
+    for (uint64_t i = 1; i < count; ++i) {
+        Sym sym;
+        if (!read_at(data, dynsym->sh_offset + i * sizeof(Sym), sym)) break;
+        unsigned bind = sym.st_info >> 4;
+        unsigned type = sym.st_info & 0xf;
+        unsigned visibility = sym.st_other & 0x3;
+        if (sym.st_shndx == SHN_UNDEF) continue;
+        if (bind != STB_GLOBAL && bind != STB_WEAK && bind != STB_GNU_UNIQUE) continue;
+        if (visibility == STV_HIDDEN || visibility == STV_INTERNAL) continue;
+
+        std::string entry = names.at(data, sym.st_name);
+        if (entry.empty()) continue;
+        Elf64_Versym version = 0;
+        if (versym && read_at(data, versym->sh_offset + i * sizeof(Elf64_Versym), version)) {
+            auto name = versions.find(static_cast<uint16_t>(version & 0x7fff));
+            if (name != versions.end()) {
+                entry += ((version & 0x8000) ? "@" : "@@") + name->second;
+            }
+        }
+
+        std::string line = std::string(symbol_kind(type)) + " " + entry;
+        if (type == STT_OBJECT || type == STT_COMMON || type == STT_TLS) {
+            line += " " + std::to_string(static_cast<uint64_t>(sym.st_size));
+        }
+        if (bind == STB_WEAK) line += " weak";
+        symbols.push_back(std::move(line));
+    }
+
+    if (dynamic) {
+        StringTable dynstr = strings_of(*dynamic);
+        uint64_t entries = dynamic->sh_size / sizeof(Dyn);
+        for (uint64_t i = 0; i < entries; ++i) {
+            Dyn dyn;
+            if (!read_at(data, dynamic->sh_offset + i * sizeof(Dyn), dyn) ||
+                dyn.d_tag == DT_NULL) {
+                break;
+            }
+            if (dyn.d_tag == DT_SONAME) soname = dynstr.at(data, dyn.d_un.d_val);
+        }
+    }
+    return true;
+}
+
+// Sort by symbol name rather than by the kind prefix
+std::string symbol_name(const std::string& line) {
+    size_t start = line.find(' ') + 1;
+    return line.substr(start, line.find(' ', start) - start);
+}
+
+} // namespace
+
+std::optional<std::string> read_interface_stub(const fs::path& library, std::string& error) {
+    std::ifstream in(library, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + library.string();
+        return std::nullopt;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    const uint16_t probe = 1;
+    unsigned char native = *reinterpret_cast<const unsigned char*>(&probe) == 1 ? ELFDATA2LSB
+                                                                               : ELFDATA2MSB;
+    if (data.size() < EI_NIDENT || std::memcmp(data.data(), ELFMAG, SELFMAG) != 0 ||
+        static_cast<unsigned char>(data[EI_DATA]) != native) {
+        error = library.string() + " is not a native ELF shared library";
+        return std::nullopt;
+    }
+
+    std::string soname;
+    std::vector<std::string> symbols;
+    bool ok = data[EI_CLASS] == ELFCLASS64
+        ? parse_elf<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym, Elf64_Dyn>(data, soname, symbols, error)
+        : parse_elf<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym, Elf32_Dyn>(data, soname, symbols, error);
+    if (!ok) {
+        error = library.string() + ": " + error;
+        return std::nullopt;
+    }
+
+    std::sort(symbols.begin(), symbols.end(), [](const std::string& a, const std::string& b) {
+        std::string name_a = symbol_name(a);
+        std::string name_b = symbol_name(b);
+        return name_a != name_b ? name_a < name_b : a < b;
+    });
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+    std::ostringstream stub;
+    stub << "soname " << soname << "\n";
+    for (const auto& symbol : symbols) {
+        stub << symbol << "\n";
+    }
+    return stub.str();
+}
+
+bool write_interface_stub(const fs::path& library, const fs::path& stub, std::string& error) {
+    auto content = read_interface_stub(library, error);
+    if (!content) return false;
+
+    std::ifstream in(stub, std::ios::binary);
+    std::string existing((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (in && existing == *content) return true;
+    in.close();
+
+    std::ofstream out(stub, std::ios::binary | std::ios::trunc);
+    out << *content;
+    if (!out) {
+        error = "cannot write " + stub.string();
+        return false;
+    }
+    return true;
+}
+
+} // namespace aria::make
@@ -0,0 +1,88 @@
+/**
+ * path_relocator.cpp
+ * Implementation of checkout-independent key paths
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/path_relocator.hpp"
+
+#include <algorithm>
+
+namespace aria::make {
+
+PathRelocator::PathRelocator(
+    const fs::path& root,
+    const std::vector<std::pair<std::string, std::string>>& prefix_map)
+    : prefixes_(prefix_map)
+{
+    if (!root.empty()) {
+        root_ = fs::absolute(root).lexically_normal().string();
+        while (root_.size() > 1 && root_.back() == '/') root_.pop_back();
+        // "<root>/src/a.c" -> "src/a.c"; the bare root is handled in map()
+        prefixes_.emplace_back(root_ + "/", "");
+    }
+
+    std::stable_sort(prefixes_.begin(), prefixes_.end(),
+                     [](const auto& a, const auto& b) { return a.first.size() > b.first.size(); });
+}
+
+std::string PathRelocator::map(const std::string& text) const {
+    if (prefixes_.empty()) return text;
+    if (!root_.empty() && text == root_) return ".";
+
+    std::string out;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        bool replaced = false;
+        for (const auto& [from, to] : prefixes_) {
+            if (text.compare(pos, from.size(), from) == 0) {
+                out += to;
+                pos += from.size();
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced) {
+            out += text[pos++];
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> PathRelocator::map(const std::vector<std::string>& texts) const {
+    std::vector<std::string> out;
+    out.reserve(texts.size());
+    for (const auto& text : texts) {
+        out.push_back(map(text));
+    }
+    return out;
+}
+
+std::string PathRelocator::resolve(const std::string& path) const {
+    // Longest replacement wins, as the longest prefix does in map()
+    const std::pair<std::string, std::string>* best = nullptr;
+    for (const auto& prefix : prefixes_) {
+        const std::string& to = prefix.second;
+        if (to.empty() || path.compare(0, to.size(), to) != 0) continue;
+        if (!best || to.size() > best->second.size()) best = &prefix;
+    }
+    if (best) {
+        return best->first + path.substr(best->second.size());
+    }
+
+    if (root_.empty() || path.empty() || fs::path(path).is_absolute()) return path;
+    if (path == ".") return root_;
+    return root_ + "/" + path;
+}
+
+std::optional<std::pair<std::string, std::string>> PathRelocator::parse_mapping(
+    const std::string& spec) {
+    auto eq = spec.find('=');
+    if (eq == std::string::npos || eq == 0) {
+        return std::nullopt;
+    }
+    return std::make_pair(spec.substr(0, eq), spec.substr(eq + 1));
+}
+
+} // namespace aria::make
@@ -0,0 +1,207 @@
+/**
+ * process_runner.cpp
+ * Implementation of the generic child-process launcher
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/process_runner.hpp"
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace aria::make {
+
+ProcessResult run_process(const ProcessSpec& spec) {
+    if (spec.argv.empty()) {
+        throw std::runtime_error("Cannot execute empty command");
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    int stdout_pipe[2];
+    int stderr_pipe[2];
+
+    if (pipe(stdout_pipe) != 0) {
+        throw std::runtime_error(
+            std::string("Failed to create stdout pipe: ") + strerror(errno));
+    }
+    if (pipe(stderr_pipe) != 0) {
+        close(stdout_pipe[0]);
+        close(stdout_pipe[1]);
+        throw std::runtime_error(
+            std::string("Failed to create stderr pipe: ") + strerror(errno));
+    }
+
+    pid_t pid = fork();
+
+    if (pid < 0) {
+        close(stdout_pipe[0]); close(stdout_pipe[1]);
+        close(stderr_pipe[0]); close(stderr_pipe[1]);
+        throw std::runtime_error(
+            std::string("Failed to fork process: ") + strerror(errno));
+    }
+
+    if (pid == 0) {
+        // Child process: own process group so timeouts kill helpers too
+        setpgid(0, 0);
+
+        dup2(stdout_pipe[1], STDOUT_FILENO);
+        dup2(stderr_pipe[1], STDERR_FILENO);
+        close(stdout_pipe[0]); close(stdout_pipe[1]);
+        close(stderr_pipe[0]); close(stderr_pipe[1]);
+
+        if (!spec.working_dir.empty() && chdir(spec.working_dir.c_str()) != 0) {
+            std::cerr << "Failed to enter " << spec.working_dir << ": "
+                      << strerror(errno) << std::endl;
+            _exit(127);
+        }
+
+        for (const auto& [key, value] : spec.env) {
+            setenv(key.c_str(), value.c_str(), 1);
+        }
+
+#ifdef __linux__
+        // Best effort: a CPU that went offline just leaves the job unpinned
+        if (!spec.cpu_affinity.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : spec.cpu_affinity) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+            }
+            sched_setaffinity(0, sizeof(set), &set);
+        }
+#endif
+
+        std::vector<char*> argv;
+        for (const auto& arg : spec.argv) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        execvp(argv[0], argv.data());
+
+        std::cerr << "Failed to execute " << spec.argv[0] << ": "
+                  << strerror(errno) << std::endl;
+        _exit(127);
+    }
+
+    // Parent process
+    close(stdout_pipe[1]);
+    close(stderr_pipe[1]);
+
+    ProcessResult result;
+    char buffer[4096];
+    bool stdout_open = true;
+    bool stderr_open = true;
+
+    while (stdout_open || stderr_open) {
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        int max_fd = -1;
+        if (stdout_open) {
+            FD_SET(stdout_pipe[0], &read_fds);
+            max_fd = std::max(max_fd, stdout_pipe[0]);
+        }
+        if (stderr_open) {
+            FD_SET(stderr_pipe[0], &read_fds);
+            max_fd = std::max(max_fd, stderr_pipe[0]);
+        }
+
+        struct timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = 10000;  // 10ms
+
+        int ready = select(max_fd + 1, &read_fds, nullptr, nullptr, &tv);
+        if (ready < 0 && errno != EINTR) break;
+
+        if (ready > 0) {
+            if (stdout_open && FD_ISSET(stdout_pipe[0], &read_fds)) {
+                ssize_t n = read(stdout_pipe[0], buffer, sizeof(buffer));
+                if (n > 0) result.stdout_output.append(buffer, n);
+                else stdout_open = false;
+            }
+            if (stderr_open && FD_ISSET(stderr_pipe[0], &read_fds)) {
+                ssize_t n = read(stderr_pipe[0], buffer, sizeof(buffer));
+                if (n > 0) result.stderr_output.append(buffer, n);
+                else stderr_open = false;
+            }
+        }
+
+        // Enforce timeout
+        if (spec.timeout.count() > 0 && !result.timed_out) {
+            auto elapsed = std::chrono::steady_clock::now() - start_time;
+            if (elapsed > spec.timeout) {
+                kill(-pid, SIGKILL);
+                result.timed_out = true;
+            }
+        }
+
+        // Safety limits (same as CompilerInterface)
+        if (result.stdout_output.size() > 10 * 1024 * 1024) {
+            result.stdout_output += "\n[... stdout truncated at 10MB ...]";
+            stdout_open = false;
+        }
+        if (result.stderr_output.size() > 10 * 1024 * 1024) {
+            result.stderr_output += "\n[... stderr truncated at 10MB ...]";
+            stderr_open = false;
+        }
+    }
+
+    close(stdout_pipe[0]);
+    close(stderr_pipe[0]);
+
+    // The child may close or redirect its stdout/stderr and keep running,
+    // so the timeout still holds after both pipes reached EOF
+    int status = 0;
+    struct rusage usage {};
+    while (true) {
+        bool bounded = spec.timeout.count() > 0 && !result.timed_out;
+        pid_t waited = wait4(pid, &status, bounded ? WNOHANG : 0, &usage);
+        if (waited == pid) break;
+        if (waited < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(
+                std::string("Failed to wait for child process: ") + strerror(errno));
+        }
+
+        if (std::chrono::steady_clock::now() - start_time > spec.timeout) {
+            kill(-pid, SIGKILL);
+            result.timed_out = true;
+        } else {
+            usleep(10000);  // 10ms
+        }
+    }
+
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time);
+    auto to_ms = [](const struct timeval& tv) {
+        return std::chrono::milliseconds(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+    };
+    result.cpu_time = to_ms(usage.ru_utime) + to_ms(usage.ru_stime);
+    result.peak_rss_kb = static_cast<uint64_t>(usage.ru_maxrss);    // KiB on Linux
+
+    if (WIFEXITED(status)) {
+        result.exit_code = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.exit_code = 128 + WTERMSIG(status);
+    } else {
+        result.exit_code = -1;
+    }
+
+    return result;
+}
+
+} // namespace aria::make
@@ -0,0 +1,124 @@
+/**
+ * progress_estimator.cpp
+ * Implementation of history-based remaining-time estimates
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/progress_estimator.hpp"
+
+#include <algorithm>
+
+namespace aria::make {
+
+namespace {
+
+// An estimate is reused, counted down, for this long
+constexpr auto REFRESH_INTERVAL = std::chrono::milliseconds(250);
+
+// Observed/recorded ratios outside this range are treated as noise
+constexpr double MIN_SPEED_FACTOR = 0.25;
+constexpr double MAX_SPEED_FACTOR = 4.0;
+
+} // namespace
+
+ProgressEstimator::ProgressEstimator(std::vector<SimTask> tasks, std::vector<bool> known,
+                                     SimConfig config)
+    : tasks_(std::move(tasks))
+    , known_(std::move(known))
+    , config_(std::move(config))
+    , state_(tasks_.size(), State::PENDING)
+    , started_at_(tasks_.size()) {
+    known_.resize(tasks_.size(), false);
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        index_[tasks_[i].name] = i;
+    }
+}
+
+void ProgressEstimator::started(const std::string& name, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(name);
+    if (it == index_.end() || state_[it->second] != State::PENDING) return;
+    state_[it->second] = State::RUNNING;
+    started_at_[it->second] = now;
+}
+
+void ProgressEstimator::finished(const std::string& name, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(name);
+    if (it == index_.end() || state_[it->second] == State::DONE) return;
+    size_t i = it->second;
+    if (state_[i] == State::RUNNING && known_[i] && tasks_[i].wall_ms > 0) {
+        observed_ms_ += std::chrono::duration<double, std::milli>(now - started_at_[i]).count();
+        recorded_ms_ += tasks_[i].wall_ms;
+    }
+    state_[i] = State::DONE;
+}
+
+double ProgressEstimator::speed_factor() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scale();
+}
+
+double ProgressEstimator::scale() const {
+    if (recorded_ms_ <= 0) return 1.0;
+    return std::clamp(observed_ms_ / recorded_ms_, MIN_SPEED_FACTOR, MAX_SPEED_FACTOR);
+}
+
+std::optional<std::chrono::milliseconds> ProgressEstimator::remaining(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (have_cached_ && now - cached_at_ < REFRESH_INTERVAL) {
+        if (!cached_) return std::nullopt;
+        auto left = *cached_ - std::chrono::duration_cast<std::chrono::milliseconds>(now - cached_at_);
+        return std::max(left, std::chrono::milliseconds(0));
+    }
+    cached_ = estimate(now);
+    cached_at_ = now;
+    have_cached_ = true;
+    return cached_;
+}
+
+std::optional<std::chrono::milliseconds> ProgressEstimator::estimate(Clock::time_point now) const {
+    if (std::none_of(known_.begin(), known_.end(), [](bool k) { return k; })) {
+        return std::nullopt;
+    }
+
+    // The unfinished part of the build as a fresh graph. Running targets
+    // go first so the (FIFO) simulation keeps them on their slots.
+    double factor = scale();
+    std::vector<size_t> order;
+    for (State wanted : {State::RUNNING, State::PENDING}) {
+        for (size_t i = 0; i < tasks_.size(); ++i) {
+            if (state_[i] == wanted) order.push_back(i);
+        }
+    }
+
+    std::vector<size_t> remap(tasks_.size(), tasks_.size());
+    std::vector<SimTask> rest;
+    for (size_t i : order) {
+        remap[i] = rest.size();
+        SimTask task = tasks_[i];
+        task.wall_ms *= factor;
+        task.cpu_ms *= factor;
+        if (state_[i] == State::RUNNING) {
+            // Overdue targets are assumed to be about to finish
+            double elapsed = std::chrono::duration<double, std::milli>(now - started_at_[i]).count();
+            double left = std::max(0.0, task.wall_ms - elapsed);
+            if (task.wall_ms > 0) task.cpu_ms *= left / task.wall_ms;
+            task.wall_ms = left;
+        }
+        rest.push_back(std::move(task));
+    }
+    for (auto& task : rest) {
+        std::vector<size_t> deps;
+        for (size_t dep : task.deps) {
+            if (remap[dep] != tasks_.size()) deps.push_back(remap[dep]);
+        }
+        task.deps = std::move(deps);
+    }
+
+    double ms = simulate_build(rest, config_).makespan_ms;
+    return std::chrono::milliseconds(static_cast<int64_t>(ms + 0.5));
+}
+
+} // namespace aria::make
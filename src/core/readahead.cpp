@@ -0,0 +1,113 @@
+/**
+ * readahead.cpp
+ * Implementation of background page-cache readahead
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/readahead.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace aria::make {
+
+namespace {
+
+// Start reading `path` into the page cache; its advised size, or -1 if it
+// cannot be opened
+int64_t advise(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st {};
+    int64_t advised = -1;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        auto length = std::min<uint64_t>(static_cast<uint64_t>(st.st_size),
+                                         Readahead::MAX_ADVISE_BYTES);
+#ifdef POSIX_FADV_WILLNEED
+        if (::posix_fadvise(fd, 0, static_cast<off_t>(length), POSIX_FADV_WILLNEED) == 0) {
+            advised = static_cast<int64_t>(length);
+        }
+#else
+        advised = 0;  // No portable hint; the open() alone warms the metadata
+#endif
+    }
+    ::close(fd);
+    return advised;
+}
+
+} // namespace
+
+Readahead::Readahead() : thread_([this] { run(); }) {}
+
+Readahead::~Readahead() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        queue_.clear();
+    }
+    work_cv_.notify_all();
+    thread_.join();
+}
+
+void Readahead::hint(const std::vector<std::string>& paths) {
+    bool added = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& path : paths) {
+            if (!path.empty() && known_.insert(path).second) {
+                queue_.push_back(path);
+                added = true;
+            }
+        }
+    }
+    if (added) work_cv_.notify_one();
+}
+
+void Readahead::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+size_t Readahead::files_advised() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_advised_;
+}
+
+uint64_t Readahead::bytes_advised() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_advised_;
+}
+
+void Readahead::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (stop_) break;
+
+        std::string path = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        int64_t advised = advise(path);
+
+        lock.lock();
+        busy_ = false;
+        if (advised < 0) {
+            known_.erase(path);  // Not there yet: may be hinted again
+        } else {
+            files_advised_++;
+            bytes_advised_ += static_cast<uint64_t>(advised);
+        }
+        if (queue_.empty()) idle_cv_.notify_all();
+    }
+    busy_ = false;
+    idle_cv_.notify_all();
+}
+
+} // namespace aria::make
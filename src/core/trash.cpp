@@ -0,0 +1,199 @@
+/**
+ * trash.cpp
+ * Implementation of rename-to-trash and background tree deletion
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "core/trash.hpp"
+#include "core/cpu_topology.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace aria::make {
+
+namespace {
+
+constexpr int DIR_FLAGS = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+
+// Subtrees deeper than this are removed by whichever thread owns them
+constexpr int FAN_OUT_DEPTH = 2;
+
+bool is_directory_entry(int dir_fd, const struct dirent* entry) {
+    if (entry->d_type != DT_UNKNOWN) return entry->d_type == DT_DIR;
+    struct stat st;
+    return ::fstatat(dir_fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0 &&
+           S_ISDIR(st.st_mode);
+}
+
+bool is_dot(const char* name) {
+    return std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0;
+}
+
+// List the entries of an open directory; `dir_fd` stays open and owned by
+// the caller. Reads through a fresh open of "." - a dup() would share (and
+// exhaust) the directory offset of `dir_fd`.
+std::vector<std::pair<std::string, bool>> list_entries(int dir_fd) {
+    std::vector<std::pair<std::string, bool>> entries;
+    int fd = ::openat(dir_fd, ".", DIR_FLAGS);
+    if (fd < 0) return entries;
+    DIR* dir = ::fdopendir(fd);
+    if (!dir) {
+        ::close(fd);
+        return entries;
+    }
+    while (struct dirent* entry = ::readdir(dir)) {
+        if (is_dot(entry->d_name)) continue;
+        entries.emplace_back(entry->d_name, is_directory_entry(dir_fd, entry));
+    }
+    ::closedir(dir);
+    return entries;
+}
+
+// Empty the directory open at `dir_fd`, depth first
+void remove_contents(int dir_fd) {
+    for (const auto& [name, is_dir] : list_entries(dir_fd)) {
+        if (is_dir) {
+            int sub = ::openat(dir_fd, name.c_str(), DIR_FLAGS);
+            if (sub >= 0) {
+                remove_contents(sub);
+                ::close(sub);
+            }
+            ::unlinkat(dir_fd, name.c_str(), AT_REMOVEDIR);
+        } else {
+            ::unlinkat(dir_fd, name.c_str(), 0);
+        }
+    }
+}
+
+// Directories (relative to `root_fd`) at FAN_OUT_DEPTH, the units of work
+// handed to threads. Shallower directories are emptied afterwards.
+void collect_subtrees(int root_fd, const std::string& rel, int depth,
+                      std::vector<std::string>& out) {
+    int fd = ::openat(root_fd, rel.empty() ? "." : rel.c_str(), DIR_FLAGS);
+    if (fd < 0) return;
+    for (const auto& [name, is_dir] : list_entries(fd)) {
+        if (!is_dir) continue;
+        std::string child = rel.empty() ? name : rel + "/" + name;
+        if (depth + 1 >= FAN_OUT_DEPTH) {
+            out.push_back(child);
+        } else {
+            collect_subtrees(root_fd, child, depth + 1, out);
+        }
+    }
+    ::close(fd);
+}
+
+std::string unique_trash_name(const fs::path& path) {
+    static std::atomic<unsigned> counter{0};
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return path.filename().string() + "." + std::to_string(::getpid()) + "." +
+           std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(now).count()) +
+           "." + std::to_string(counter++);
+}
+
+// Runs in the detached helper: remove everything inside `trash_dir`
+void purge_trash(const fs::path& trash_dir) {
+    std::error_code ec;
+    size_t threads = std::clamp<size_t>(default_job_count(), 4, 16);
+    for (const auto& entry : fs::directory_iterator(trash_dir, ec)) {
+        remove_tree(entry.path(), threads);
+    }
+}
+
+} // namespace
+
+bool move_to_trash(const fs::path& path, const fs::path& trash_dir, std::string& error) {
+    std::error_code ec;
+    fs::create_directories(trash_dir, ec);
+    if (ec) {
+        error = "cannot create " + trash_dir.string() + ": " + ec.message();
+        return false;
+    }
+
+    fs::path target = trash_dir / unique_trash_name(path);
+    if (::rename(path.c_str(), target.c_str()) != 0) {
+        error = "cannot move " + path.string() + " to " + trash_dir.string() + ": " +
+                std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool purge_trash_async(const fs::path& trash_dir) {
+    // Double fork: the helper is reparented to init, so it neither becomes
+    // a zombie of ours nor dies with our session
+    pid_t child = ::fork();
+    if (child < 0) return false;
+    if (child == 0) {
+        ::setsid();
+        pid_t helper = ::fork();
+        if (helper != 0) ::_exit(helper < 0 ? 1 : 0);
+
+        int null_fd = ::open("/dev/null", O_RDWR);
+        if (null_fd >= 0) {
+            ::dup2(null_fd, STDIN_FILENO);
+            ::dup2(null_fd, STDOUT_FILENO);
+            ::dup2(null_fd, STDERR_FILENO);
+            if (null_fd > STDERR_FILENO) ::close(null_fd);
+        }
+        if (::nice(10) < 0) {}     // Best effort: stay out of the build's way
+        purge_trash(trash_dir);
+        ::_exit(0);
+    }
+
+    int status = 0;
+    while (::waitpid(child, &status, 0) < 0 && errno == EINTR) {}
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+bool remove_tree(const fs::path& path, size_t threads) {
+    int root_fd = ::open(path.c_str(), DIR_FLAGS);
+    if (root_fd < 0) {
+        // Not a directory (or a symlink to one): a single unlink
+        if (errno == ENOENT) return true;
+        return ::unlink(path.c_str()) == 0 || errno == ENOENT;
+    }
+
+    std::vector<std::string> subtrees;
+    if (threads > 1) {
+        collect_subtrees(root_fd, "", 0, subtrees);
+    }
+
+    if (subtrees.size() > 1) {
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t i = next++; i < subtrees.size(); i = next++) {
+                int fd = ::openat(root_fd, subtrees[i].c_str(), DIR_FLAGS);
+                if (fd < 0) continue;
+                remove_contents(fd);
+                ::close(fd);
+                ::unlinkat(root_fd, subtrees[i].c_str(), AT_REMOVEDIR);
+            }
+        };
+        std::vector<std::thread> pool;
+        size_t count = std::min(threads, subtrees.size());
+        for (size_t i = 1; i < count; ++i) pool.emplace_back(worker);
+        worker();
+        for (auto& thread : pool) thread.join();
+    }
+
+    // Whatever is left: files above the fan-out depth and emptied directories
+    remove_contents(root_fd);
+    ::close(root_fd);
+    return ::rmdir(path.c_str()) == 0 || errno == ENOENT;
+}
+
+} // namespace aria::make
@@ -9,8 +9,11 @@
 #include "glob/glob_bridge.hpp"
 #include <cstdlib>
 #include <algorithm>
+#include <cctype>
 #include <set>
 
+#ifdef ARIA_MAKE_HAS_AGLOB
+
 // Forward declarations of aglob C FFI (from aria_utils/aglob)
 extern "C" {
 
@@ -153,3 +156,261 @@ const char* error_string(GlobError error) {
 }
 
 } // namespace aria::make::glob
+
+#else // !ARIA_MAKE_HAS_AGLOB
+
+// =============================================================================
+// Built-in fallback (aglob not available)
+// =============================================================================
+// A std::filesystem walker implementing the same pattern syntax, so aria_make
+// still links and expands globs when aria_utils is not checked out alongside.
+
+namespace aria::make::glob {
+
+namespace {
+
+bool char_equal(char a, char b, bool case_sensitive) {
+    if (case_sensitive) return a == b;
+    return std::tolower(static_cast<unsigned char>(a)) ==
+           std::tolower(static_cast<unsigned char>(b));
+}
+
+// Match a [...] class starting at pattern[pi] (which is '[').
+// Returns the index just past ']' or npos if the class is malformed.
+size_t match_class(const std::string& pattern, size_t pi, char c,
+                   bool case_sensitive, bool& matched) {
+    size_t i = pi + 1;
+    bool negate = false;
+    if (i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^')) {
+        negate = true;
+        ++i;
+    }
+
+    bool found = false;
+    bool first = true;
+    while (i < pattern.size() && (first || pattern[i] != ']')) {
+        first = false;
+        char lo = pattern[i];
+        if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+            char hi = pattern[i + 2];
+            char cc = case_sensitive ? c : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (!case_sensitive) {
+                lo = static_cast<char>(std::tolower(static_cast<unsigned char>(lo)));
+                hi = static_cast<char>(std::tolower(static_cast<unsigned char>(hi)));
+            }
+            if (cc >= lo && cc <= hi) found = true;
+            i += 3;
+        } else {
+            if (char_equal(lo, c, case_sensitive)) found = true;
+            ++i;
+        }
+    }
+
+    if (i >= pattern.size()) return std::string::npos;
+    matched = (found != negate);
+    return i + 1;
+}
+
+// Recursive matcher over generic ('/'-separated) paths.
+bool match_from(const std::string& pattern, size_t pi,
+                const std::string& path, size_t si, bool case_sensitive) {
+    while (pi < pattern.size()) {
+        char pc = pattern[pi];
+
+        if (pc == '*') {
+            bool globstar = (pi + 1 < pattern.size() && pattern[pi + 1] == '*');
+            if (globstar) {
+                size_t next = pi + 2;
+                // "**/" may also match zero directories
+                if (next < pattern.size() && pattern[next] == '/') {
+                    if (match_from(pattern, next + 1, path, si, case_sensitive)) return true;
+                }
+                for (size_t k = si; k <= path.size(); ++k) {
+                    if (match_from(pattern, next, path, k, case_sensitive)) return true;
+                }
+                return false;
+            }
+            for (size_t k = si; k <= path.size(); ++k) {
+                if (match_from(pattern, pi + 1, path, k, case_sensitive)) return true;
+                if (k < path.size() && path[k] == '/') break;
+            }
+            return false;
+        }
+
+        if (si >= path.size()) return false;
+
+        if (pc == '?') {
+            if (path[si] == '/') return false;
+            ++pi;
+            ++si;
+            continue;
+        }
+
+        if (pc == '[') {
+            bool matched = false;
+            size_t end = match_class(pattern, pi, path[si], case_sensitive, matched);
+            if (end != std::string::npos) {
+                if (!matched || path[si] == '/') return false;
+                pi = end;
+                ++si;
+                continue;
+            }
+            // Malformed class: treat '[' literally
+        }
+
+        if (!char_equal(pc, path[si], case_sensitive)) return false;
+        ++pi;
+        ++si;
+    }
+    return si == path.size();
+}
+
+bool has_wildcard(const std::string& segment) {
+    return segment.find_first_of("*?[") != std::string::npos;
+}
+
+bool is_hidden(const fs::path& rel) {
+    for (const auto& part : rel) {
+        std::string s = part.string();
+        if (!s.empty() && s[0] == '.' && s != "." && s != "..") return true;
+    }
+    return false;
+}
+
+} // namespace
+
+GlobResult expand_pattern(
+    const fs::path& base_dir,
+    const std::string& pattern,
+    const GlobOptions& options
+) {
+    GlobResult result;
+
+    std::error_code ec;
+    if (!fs::is_directory(base_dir, ec)) {
+        result.error = GlobError::INVALID_BASE_DIR;
+        result.error_message = error_string(result.error);
+        return result;
+    }
+    if (!validate_pattern(pattern)) {
+        result.error = GlobError::PATTERN_SYNTAX_ERROR;
+        result.error_message = error_string(result.error);
+        return result;
+    }
+
+    // Walk only below the literal prefix of the pattern ("src/ffi/*.c" -> src/ffi)
+    std::string prefix;
+    size_t seg_start = 0;
+    while (seg_start < pattern.size()) {
+        size_t slash = pattern.find('/', seg_start);
+        if (slash == std::string::npos) break;
+        std::string segment = pattern.substr(seg_start, slash - seg_start);
+        if (has_wildcard(segment)) break;
+        prefix = pattern.substr(0, slash);
+        seg_start = slash + 1;
+    }
+
+    fs::path walk_root = prefix.empty() ? base_dir : base_dir / prefix;
+    if (!fs::is_directory(walk_root, ec)) {
+        return result;  // Nothing to match
+    }
+
+    auto dir_opts = fs::directory_options::skip_permission_denied;
+    if (options.follow_symlinks) {
+        dir_opts |= fs::directory_options::follow_directory_symlink;
+    }
+
+    fs::recursive_directory_iterator it(walk_root, dir_opts, ec);
+    fs::recursive_directory_iterator end;
+    if (ec) {
+        result.error = GlobError::ACCESS_DENIED;
+        result.error_message = ec.message();
+        return result;
+    }
+
+    for (; it != end; it.increment(ec)) {
+        if (ec) {
+            result.error = GlobError::FILESYSTEM_ERROR;
+            result.error_message = ec.message();
+            return result;
+        }
+        if (static_cast<size_t>(it.depth()) >= options.max_depth) {
+            it.disable_recursion_pending();
+        }
+
+        fs::path rel = it->path().lexically_relative(base_dir);
+        if (!options.include_hidden && is_hidden(rel)) {
+            if (it->is_directory(ec)) it.disable_recursion_pending();
+            continue;
+        }
+        if (options.files_only && !it->is_regular_file(ec)) continue;
+
+        if (match_from(pattern, 0, rel.generic_string(), 0, options.case_sensitive)) {
+            result.paths.push_back((base_dir / rel).string());
+        }
+    }
+
+    std::sort(result.paths.begin(), result.paths.end());
+    return result;
+}
+
+GlobResult expand_patterns(
+    const fs::path& base_dir,
+    const std::vector<std::string>& patterns,
+    const GlobOptions& options
+) {
+    GlobResult result;
+    std::set<std::string> seen;
+
+    for (const auto& pattern : patterns) {
+        GlobResult partial = expand_pattern(base_dir, pattern, options);
+        if (!partial.ok()) {
+            result.error = partial.error;
+            result.error_message = partial.error_message;
+            return result;
+        }
+        for (auto& path : partial.paths) {
+            if (seen.insert(path).second) {
+                result.paths.push_back(std::move(path));
+            }
+        }
+    }
+
+    std::sort(result.paths.begin(), result.paths.end());
+    return result;
+}
+
+bool path_matches(
+    const fs::path& path,
+    const std::string& pattern,
+    bool case_sensitive
+) {
+    return match_from(pattern, 0, path.generic_string(), 0, case_sensitive);
+}
+
+bool validate_pattern(const std::string& pattern) {
+    if (pattern.empty()) return false;
+    int depth = 0;
+    for (char c : pattern) {
+        if (c == '[') ++depth;
+        else if (c == ']' && depth > 0) --depth;
+    }
+    return depth == 0;
+}
+
+const char* error_string(GlobError error) {
+    switch (error) {
+        case GlobError::OK:                   return "ok";
+        case GlobError::INVALID_BASE_DIR:     return "invalid base directory";
+        case GlobError::PATTERN_SYNTAX_ERROR: return "pattern syntax error";
+        case GlobError::ACCESS_DENIED:        return "access denied";
+        case GlobError::FILESYSTEM_ERROR:     return "filesystem error";
+        case GlobError::SYMLINK_CYCLE:        return "symlink cycle";
+        case GlobError::MAX_DEPTH_EXCEEDED:   return "maximum depth exceeded";
+        default:                              return "unknown error";
+    }
+}
+
+} // namespace aria::make::glob
+
+#endif // ARIA_MAKE_HAS_AGLOB
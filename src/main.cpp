@@ -10,17 +10,39 @@
  *   clean       Remove build artifacts
  *   rebuild     Clean and rebuild
  *   check       Show what would be built (dry run)
+ *   test        Build and run test targets
  *   targets     List all targets
  *   deps        Show dependency graph
+ *   actions     Show the lowered action graph (JSON)
+ *   worker      Run a remote execution worker
+ *   cache       Export/import a portable cache bundle
+ *   simulate    Replay recorded build times under other -j/pools/policies
+ *   pgo         Instrument, train, merge the profile, build optimized
  *
  * Options:
  *   -C <dir>    Change to directory before building
  *   -f <file>   Use specified build file (default: build.abc)
  *   -j <N>      Use N parallel jobs (default: auto)
+ *   --pin-jobs <none|core|cache>  Pin local compiles to CPUs or L3 groups
  *   -v          Verbose output
  *   -q          Quiet mode
  *   --force     Force rebuild all targets
  *   --dry-run   Print commands without executing
+ *   --shard=i/n Run only the i-th of n test shards
+ *   --remote <endpoints>  Offload actions to workers
+ *   --path-prefix-map OLD=NEW  Rewrite a path prefix in cache keys
+ *   --no-git-index  Hash every source instead of trusting .git/index
+ *   --io <auto|uring|threads>  Batched I/O backend for dirty checking
+ *   --stats     Print hashing and artifact store statistics
+ *   --cas-chunking  Chunk large blobs in the artifact store
+ *   --lazy-outputs  Cache import leaves intermediate outputs in the store
+ *   --no-readahead  Don't read upcoming job inputs into the page cache
+ *   --variants=a,b  Build several [variant.*] configurations in one run
+ *   --pgo       Build the PGO-optimized instances with the existing profile
+ *   --linker <name>  Linker for binaries (auto, mold, lld, gold, bfd, default)
+ *   --policy <list>  Scheduling policies to simulate
+ *   --pool NAME=N   Override a pool depth when simulating
+ *   --mem-limit <size>  Memory budget when simulating
  *   --help      Show this help
  *   --version   Show version
  *
@@ -28,10 +50,18 @@
  */
 
 #include "core/build_orchestrator.hpp"
+#include "remote/worker.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
+#include <sstream>
 #include <vector>
+#include <cstdio>
 #include <cstring>
+#include <optional>
+#include <unordered_map>
 
 using namespace aria::make;
 
@@ -57,19 +87,71 @@ COMMANDS:
     clean       Remove build artifacts and state
     rebuild     Clean and rebuild from scratch
     check       Show what would be built (dry run)
+    test        Build everything and run test targets
     targets     List all available targets
     deps        Show dependency graph in DOT format
+    actions     Show the action graph (argv, inputs, outputs) as JSON
+    worker      Serve remote execution requests (see --listen)
+    cache export <file>   Pack build state and outputs into a bundle ("-" = stdout)
+    cache import <file>   Unpack a bundle into this checkout ("-" = stdin)
+    simulate    Predict clean-build time from recorded history for each
+                -j/policy combination (see SIMULATE OPTIONS)
+    pgo         Profile-guided build: instrumented build, [pgo] training run,
+                llvm-profdata merge, then the optimized build (<target>@pgo)
 
 OPTIONS:
     -C <dir>        Change to directory before building
     -f <file>       Use specified build file (default: build.abc)
-    -j, --jobs <N>  Use N parallel jobs (default: number of CPU cores)
+    -j, --jobs <N>  Use N parallel jobs (default: usable CPUs, honouring the
+                    affinity mask and cgroup cpu.max quota)
+    --pin-jobs <none|core|cache>
+                    Pin each local compile to one CPU (core) or to the CPUs
+                    sharing an L3 cache (cache); default: none
     -v, --verbose   Verbose output (show all commands)
     -q, --quiet     Quiet mode (minimal output)
     --force         Force rebuild all targets (ignore state)
     --dry-run       Print commands without executing
     --fail-fast     Stop on first error (default)
     --keep-going    Continue building as much as possible after errors
+    --shard=<i>/<n> Run only shard i of n (1-based) of the test targets
+    --test-timeout <sec>  Default per-test timeout (default: 300)
+    --remote <a,b,...>    Offload actions to workers (unix:/path or host:port)
+    --path-prefix-map <old>=<new>
+                          Treat paths under <old> as <new> in cache keys
+                          (repeatable; paths in the project are always relative)
+    --no-git-index        Hash every source file instead of taking unchanged
+                          files' hashes from .git/index
+    --io <auto|uring|threads>
+                          How dirty checking batches stat and read calls
+                          (default: auto = io_uring if available)
+    --stats               Print hashing and artifact store statistics
+                          (compression ratio, restore throughput)
+    --cas-chunking        Store large blobs (archives, binaries) as
+                          content-defined chunks shared between versions
+    --lazy-outputs        With `cache import`: keep objects and archives in
+                          the artifact store and place them only when an
+                          action that runs needs them
+    --no-readahead        Don't read the inputs of upcoming jobs into the
+                          page cache ahead of time
+    --variants=<a,b,...>  Build these [variant.<name>] configurations together:
+                          one analysis pass, one job pool, targets named
+                          <target>@<variant>
+    --pgo                 Build <target>@pgo with the profile from the last
+                          `aria_make pgo` (without training again)
+    --linker <name>       Linker for binaries and tests: auto (mold, else lld,
+                          else gold), mold, lld, gold, bfd or default
+                          (overrides [link] linker)
+
+SIMULATE OPTIONS:
+    -j <N,N,...>          Job counts to simulate (default: 1,2,4,...,2x usable CPUs)
+    --policy <list>       Any of fifo, critical-path, longest (default: all)
+    --pool <name>=<N>     Override a [pools] depth (repeatable)
+    --mem-limit <size>    Memory budget, e.g. 16G or 512M (default: none)
+
+WORKER OPTIONS:
+    --listen <addr>       Address to serve on (unix:/path or host:port)
+    --cache-dir <dir>     Blob store and scratch space (default: .aria_make/worker)
+    -j <N>                Concurrent actions (default: usable CPUs)
 
     -h, --help      Show this help message
     --version       Show version information
@@ -81,8 +163,16 @@ EXAMPLES:
     aria_make -C /path/to/project   Build project in another directory
     aria_make --force               Rebuild everything
     aria_make clean                 Remove build artifacts
+    aria_make test --shard=2/4      Run the second quarter of the tests
     aria_make targets               List all build targets
     aria_make deps > graph.dot      Export dependency graph
+    aria_make actions               Inspect every command aria_make would run
+    aria_make worker --listen unix:/tmp/w1.sock
+    aria_make --remote unix:/tmp/w1.sock,10.0.0.5:7070
+    aria_make cache export ci-cache.bundle
+    aria_make simulate -j 8,16,32 --policy fifo,critical-path
+    aria_make build --variants=debug,release,asan
+    aria_make pgo
 
 BUILD FILE FORMAT (build.abc):
     [project]
@@ -141,7 +231,11 @@ public:
                 if (!progress.current_target.empty()) {
                     std::cout << "[" << (progress.current + 1) << "/"
                               << progress.total << "] Building "
-                              << progress.current_target << "...\n";
+                              << progress.current_target << "...";
+                    if (progress.remaining) {
+                        std::cout << " (" << format_eta(*progress.remaining) << " left)";
+                    }
+                    std::cout << "\n";
                 }
                 break;
 
@@ -158,6 +252,20 @@ public:
     }
 
 private:
+    // "~1m05s", "~12s", "<1s"
+    static std::string format_eta(std::chrono::milliseconds remaining) {
+        auto seconds = (remaining.count() + 500) / 1000;
+        if (seconds < 1) return "<1s";
+        std::ostringstream out;
+        out << "~";
+        if (seconds >= 60) {
+            out << seconds / 60 << "m" << std::setw(2) << std::setfill('0') << seconds % 60 << "s";
+        } else {
+            out << seconds << "s";
+        }
+        return out.str();
+    }
+
     bool verbose_;
     bool quiet_;
 };
@@ -171,8 +279,14 @@ enum class Command {
     CLEAN,
     REBUILD,
     CHECK,
+    TEST,
     TARGETS,
-    DEPS
+    DEPS,
+    ACTIONS,
+    WORKER,
+    CACHE,
+    SIMULATE,
+    PGO
 };
 
 struct Options {
@@ -181,8 +295,41 @@ struct Options {
     std::vector<std::string> targets;
     bool show_help = false;
     bool show_version = false;
+    bool show_stats = false;
+
+    // Worker mode
+    std::string listen;
+    std::string cache_dir;
+
+    // Cache bundles: "export" or "import", and the bundle file
+    std::string cache_action;
+    std::string cache_file;
+
+    // Simulation: -j list, policies, pool overrides, memory budget
+    std::vector<size_t> sim_jobs;
+    std::vector<SchedulePolicy> sim_policies;
+    std::unordered_map<std::string, size_t> sim_pools;
+    uint64_t sim_memory_kb = 0;
 };
 
+// "16G", "512M", "2048K" or plain KiB
+std::optional<uint64_t> parse_memory_kb(const std::string& text) {
+    size_t used = 0;
+    double value = 0;
+    try {
+        value = std::stod(text, &used);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    std::string unit = text.substr(used);
+    double scale = 1;
+    if (unit == "G" || unit == "GiB") scale = 1024.0 * 1024.0;
+    else if (unit == "M" || unit == "MiB") scale = 1024.0;
+    else if (unit != "" && unit != "K" && unit != "KiB") return std::nullopt;
+    if (value <= 0) return std::nullopt;
+    return static_cast<uint64_t>(value * scale);
+}
+
 bool parse_args(int argc, char* argv[], Options& opts) {
     opts.config.project_root = fs::current_path();
 
@@ -216,6 +363,11 @@ bool parse_args(int argc, char* argv[], Options& opts) {
             opts.command = Command::CHECK;
             continue;
         }
+        if (arg == "test") {
+            opts.command = Command::TEST;
+            opts.config.run_tests = true;
+            continue;
+        }
         if (arg == "targets") {
             opts.command = Command::TARGETS;
             continue;
@@ -224,6 +376,26 @@ bool parse_args(int argc, char* argv[], Options& opts) {
             opts.command = Command::DEPS;
             continue;
         }
+        if (arg == "actions") {
+            opts.command = Command::ACTIONS;
+            continue;
+        }
+        if (arg == "worker") {
+            opts.command = Command::WORKER;
+            continue;
+        }
+        if (arg == "cache") {
+            opts.command = Command::CACHE;
+            continue;
+        }
+        if (arg == "simulate") {
+            opts.command = Command::SIMULATE;
+            continue;
+        }
+        if (arg == "pgo") {
+            opts.command = Command::PGO;
+            continue;
+        }
 
         // Options with arguments
         if (arg == "-C" && i + 1 < argc) {
@@ -235,7 +407,141 @@ bool parse_args(int argc, char* argv[], Options& opts) {
             continue;
         }
         if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
-            opts.config.num_threads = std::stoul(argv[++i]);
+            // A list ("8,16,32") is only meaningful for simulate
+            std::stringstream list(argv[++i]);
+            std::string count;
+            opts.sim_jobs.clear();
+            while (std::getline(list, count, ',')) {
+                if (!count.empty()) opts.sim_jobs.push_back(std::stoul(count));
+            }
+            if (opts.sim_jobs.empty()) {
+                std::cerr << "Invalid job count '" << argv[i] << "'\n";
+                return false;
+            }
+            opts.config.num_threads = opts.sim_jobs.front();
+            continue;
+        }
+        if (arg == "--policy" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                auto policy = parse_schedule_policy(name);
+                if (!policy) {
+                    std::cerr << "Invalid --policy '" << name
+                              << "' (expected fifo, critical-path or longest)\n";
+                    return false;
+                }
+                opts.sim_policies.push_back(*policy);
+            }
+            continue;
+        }
+        if (arg == "--pool" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            size_t depth = 0;
+            try {
+                if (eq != std::string::npos) depth = std::stoul(spec.substr(eq + 1));
+            } catch (const std::exception&) {
+                depth = 0;
+            }
+            if (eq == std::string::npos || eq == 0 || depth == 0) {
+                std::cerr << "Invalid --pool '" << spec << "' (expected NAME=DEPTH)\n";
+                return false;
+            }
+            opts.sim_pools[spec.substr(0, eq)] = depth;
+            continue;
+        }
+        if (arg == "--mem-limit" && i + 1 < argc) {
+            auto kb = parse_memory_kb(argv[++i]);
+            if (!kb) {
+                std::cerr << "Invalid --mem-limit '" << argv[i] << "' (expected e.g. 16G or 512M)\n";
+                return false;
+            }
+            opts.sim_memory_kb = *kb;
+            continue;
+        }
+        if (arg == "--io" && i + 1 < argc) {
+            auto backend = parse_io_backend(argv[++i]);
+            if (!backend) {
+                std::cerr << "Invalid --io '" << argv[i] << "' (expected auto, uring or threads)\n";
+                return false;
+            }
+            opts.config.io_backend = *backend;
+            continue;
+        }
+        if (arg == "--linker" && i + 1 < argc) {
+            opts.config.linker = argv[++i];
+            continue;
+        }
+        if (arg.rfind("--linker=", 0) == 0) {
+            opts.config.linker = arg.substr(9);
+            continue;
+        }
+        if (arg == "--pin-jobs" && i + 1 < argc) {
+            auto pinning = parse_cpu_pinning(argv[++i]);
+            if (!pinning) {
+                std::cerr << "Invalid --pin-jobs '" << argv[i] << "' (expected none, core or cache)\n";
+                return false;
+            }
+            opts.config.pin_jobs = *pinning;
+            continue;
+        }
+        if (arg == "--remote" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string endpoint;
+            while (std::getline(list, endpoint, ',')) {
+                if (!endpoint.empty()) opts.config.remote_workers.push_back(endpoint);
+            }
+            continue;
+        }
+        if (arg == "--path-prefix-map" && i + 1 < argc) {
+            auto mapping = PathRelocator::parse_mapping(argv[++i]);
+            if (!mapping) {
+                std::cerr << "Invalid path prefix map '" << argv[i] << "' (expected OLD=NEW)\n";
+                return false;
+            }
+            opts.config.path_prefix_map.push_back(*mapping);
+            continue;
+        }
+        if (arg == "--listen" && i + 1 < argc) {
+            opts.listen = argv[++i];
+            continue;
+        }
+        if (arg == "--cache-dir" && i + 1 < argc) {
+            opts.cache_dir = argv[++i];
+            continue;
+        }
+        if (arg == "--test-timeout" && i + 1 < argc) {
+            opts.config.test_timeout_sec = std::stoul(argv[++i]);
+            continue;
+        }
+        if (arg.rfind("--variants=", 0) == 0 || (arg == "--variants" && i + 1 < argc)) {
+            std::stringstream list(arg == "--variants" ? argv[++i] : arg.substr(11));
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                if (!name.empty()) opts.config.variants.push_back(name);
+            }
+            continue;
+        }
+        if (arg.rfind("--shard=", 0) == 0) {
+            // --shard=i/n with 1 <= i <= n
+            std::string spec = arg.substr(8);
+            size_t slash = spec.find('/');
+            size_t index = 0, count = 0;
+            try {
+                if (slash != std::string::npos) {
+                    index = std::stoul(spec.substr(0, slash));
+                    count = std::stoul(spec.substr(slash + 1));
+                }
+            } catch (const std::exception&) {
+                count = 0;
+            }
+            if (count == 0 || index == 0 || index > count) {
+                std::cerr << "Invalid shard '" << spec << "' (expected i/n with 1 <= i <= n)\n";
+                return false;
+            }
+            opts.config.test_shard_index = index - 1;
+            opts.config.test_shard_count = count;
             continue;
         }
 
@@ -252,6 +558,30 @@ bool parse_args(int argc, char* argv[], Options& opts) {
             opts.config.force_rebuild = true;
             continue;
         }
+        if (arg == "--no-git-index") {
+            opts.config.use_git_index = false;
+            continue;
+        }
+        if (arg == "--stats") {
+            opts.show_stats = true;
+            continue;
+        }
+        if (arg == "--pgo") {
+            opts.config.pgo = PgoPhase::OPTIMIZE;
+            continue;
+        }
+        if (arg == "--cas-chunking") {
+            opts.config.artifact_store.chunk_large = true;
+            continue;
+        }
+        if (arg == "--lazy-outputs") {
+            opts.config.lazy_outputs = true;
+            continue;
+        }
+        if (arg == "--no-readahead") {
+            opts.config.readahead = false;
+            continue;
+        }
         if (arg == "--dry-run") {
             opts.config.dry_run = true;
             continue;
@@ -267,13 +597,26 @@ bool parse_args(int argc, char* argv[], Options& opts) {
             continue;
         }
 
-        // Unknown option
-        if (arg[0] == '-') {
+        // Unknown option ("-" alone names stdin/stdout)
+        if (arg[0] == '-' && arg != "-") {
             std::cerr << "Unknown option: " << arg << "\n";
             std::cerr << "Try 'aria_make --help' for more information.\n";
             return false;
         }
 
+        // Cache subcommand and bundle file
+        if (opts.command == Command::CACHE) {
+            if (opts.cache_action.empty()) {
+                opts.cache_action = arg;
+            } else if (opts.cache_file.empty()) {
+                opts.cache_file = arg;
+            } else {
+                std::cerr << "Unexpected argument: " << arg << "\n";
+                return false;
+            }
+            continue;
+        }
+
         // Target name
         opts.targets.push_back(arg);
     }
@@ -282,6 +625,224 @@ bool parse_args(int argc, char* argv[], Options& opts) {
     return true;
 }
 
+// -----------------------------------------------------------------------------
+// Worker Mode
+// -----------------------------------------------------------------------------
+
+int run_worker(const Options& opts) {
+    auto endpoint = Endpoint::parse(opts.listen);
+    if (!endpoint) {
+        std::cerr << "worker needs --listen unix:/path or host:port\n";
+        return 1;
+    }
+
+    WorkerConfig config;
+    config.endpoint = *endpoint;
+    if (!opts.cache_dir.empty()) config.cache_dir = opts.cache_dir;
+    config.slots = opts.config.num_threads;
+    config.verbose = opts.config.verbose;
+    config.store = opts.config.artifact_store;
+
+    Worker worker(config);
+    std::string error;
+    if (!worker.start(error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    if (!opts.config.quiet) {
+        std::cout << "aria_make worker listening on " << worker.endpoint().to_string()
+                  << " (" << worker.slots() << " slots)" << std::endl;
+    }
+    worker.serve();
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Statistics (--stats)
+// -----------------------------------------------------------------------------
+
+void print_stats(BuildOrchestrator& orchestrator, std::ostream& out) {
+    auto mib = [](uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+
+    BuildStats hashing = orchestrator.state_manager().get_stats();
+    out << "\nStatistics:\n";
+    out << "  Inputs hashed:  " << hashing.files_hashed << " read, "
+        << hashing.git_index_hits << " from git index\n";
+
+    if (auto store = orchestrator.artifact_store_stats()) {
+        out << "  Artifact store: " << store->blobs << " blobs, " << mib(store->logical_bytes)
+            << " MiB in " << mib(store->stored_bytes) << " MiB on disk ("
+            << std::setprecision(2) << store->ratio() << "x)\n" << std::setprecision(1);
+        if (store->restored_bytes > 0) {
+            out << "  Restored:       " << mib(store->restored_bytes) << " MiB in "
+                << store->restore_seconds * 1000.0 << "ms ("
+                << store->restore_mb_per_sec() << " MiB/s)\n";
+        }
+    } else {
+        out << "  Artifact store: empty\n";
+    }
+    out.flags(flags);
+}
+
+// -----------------------------------------------------------------------------
+// Cache Bundles
+// -----------------------------------------------------------------------------
+
+int run_cache(BuildOrchestrator& orchestrator, const Options& opts) {
+    bool exporting = opts.cache_action == "export";
+    if ((!exporting && opts.cache_action != "import") || opts.cache_file.empty()) {
+        std::cerr << "usage: aria_make cache export|import <file>\n";
+        return 1;
+    }
+
+    BundleStats stats;
+    std::string error;
+    bool ok = false;
+    // Progress goes to stderr so "-" can stream the bundle through stdout
+    auto start = std::chrono::steady_clock::now();
+
+    if (exporting) {
+        orchestrator.check();
+        if (opts.cache_file == "-") {
+            ok = orchestrator.export_cache(std::cout, stats, error);
+        } else {
+            std::ofstream out(opts.cache_file, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "Error: cannot write " << opts.cache_file << "\n";
+                return 1;
+            }
+            ok = orchestrator.export_cache(out, stats, error);
+        }
+    } else {
+        if (opts.config.lazy_outputs) {
+            orchestrator.check();  // Which outputs are intermediate
+        }
+        if (opts.cache_file == "-") {
+            ok = orchestrator.import_cache(std::cin, stats, error);
+        } else {
+            std::ifstream in(opts.cache_file, std::ios::binary);
+            if (!in) {
+                std::cerr << "Error: cannot read " << opts.cache_file << "\n";
+                return 1;
+            }
+            ok = orchestrator.import_cache(in, stats, error);
+        }
+    }
+
+    if (!ok) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    if (!opts.config.quiet) {
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cerr << (exporting ? "Exported " : "Imported ") << stats.files << " files ("
+                  << stats.blobs << " distinct, " << stats.raw_bytes << " bytes, "
+                  << stats.stored_bytes << " in bundle";
+        if (stats.deferred > 0) {
+            std::cerr << ", " << stats.deferred << " left in the store";
+        }
+        std::cerr << ") in " << ms << "ms\n";
+    }
+    if (opts.show_stats) {
+        print_stats(orchestrator, std::cerr);
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Schedule Simulation
+// -----------------------------------------------------------------------------
+
+std::string format_ms(double ms) {
+    std::ostringstream out;
+    out << std::fixed;
+    if (ms >= 60000) {
+        out << std::setprecision(1) << ms / 60000.0 << "m";
+    } else if (ms >= 1000) {
+        out << std::setprecision(2) << ms / 1000.0 << "s";
+    } else {
+        out << std::setprecision(0) << ms << "ms";
+    }
+    return out.str();
+}
+
+int run_simulate(BuildOrchestrator& orchestrator, const Options& opts) {
+    orchestrator.check();
+
+    size_t missing = 0;
+    std::vector<SimTask> tasks = orchestrator.simulation_tasks(missing);
+    if (tasks.empty()) {
+        std::cerr << "Error: no targets to simulate\n";
+        return 1;
+    }
+    if (missing == tasks.size()) {
+        std::cerr << "Error: no recorded build history; build once first\n";
+        return 1;
+    }
+
+    std::vector<size_t> jobs = opts.sim_jobs;
+    if (jobs.empty()) {
+        size_t usable = default_job_count();
+        for (size_t j = 1; j < 2 * usable; j *= 2) jobs.push_back(j);
+        jobs.push_back(2 * usable);
+    }
+    std::vector<SchedulePolicy> policies = opts.sim_policies;
+    if (policies.empty()) {
+        policies = {SchedulePolicy::FIFO, SchedulePolicy::CRITICAL_PATH,
+                    SchedulePolicy::LONGEST_FIRST};
+    }
+
+    SimConfig config;
+    config.pool_depths = orchestrator.pool_depths();
+    for (const auto& [pool, depth] : opts.sim_pools) {
+        config.pool_depths[pool] = depth;
+    }
+    config.memory_limit_kb = opts.sim_memory_kb;
+
+    double total_cpu = 0;
+    double total_wall = 0;
+    for (const auto& task : tasks) {
+        total_cpu += std::max(task.cpu_ms, task.wall_ms);
+        total_wall += task.wall_ms;
+    }
+    CriticalPath path = critical_path(tasks);
+
+    std::cout << "Simulated clean build of " << tasks.size() << " targets";
+    if (missing > 0) {
+        // Targets without history were given the mean, so this is it too
+        std::cout << " (" << missing << " without history, assumed "
+                  << format_ms(total_wall / static_cast<double>(tasks.size())) << " each)";
+    }
+    std::cout << "\n";
+    std::cout << "Critical path:  " << format_ms(path.length_ms) << " (";
+    for (size_t k = 0; k < path.tasks.size(); ++k) {
+        std::cout << (k ? " -> " : "") << tasks[path.tasks[k]].name;
+    }
+    std::cout << ")\n";
+    std::cout << "Serial time:    " << format_ms(total_cpu) << "\n\n";
+
+    std::printf("%6s  %-14s %10s %7s %8s %10s\n",
+                "jobs", "policy", "makespan", "util", "speedup", "peak mem");
+    for (size_t j : jobs) {
+        for (SchedulePolicy policy : policies) {
+            config.jobs = j;
+            config.policy = policy;
+            SimResult result = simulate_build(tasks, config);
+            double speedup = result.makespan_ms > 0 ? total_cpu / result.makespan_ms : 0;
+            std::string memory = result.peak_memory_kb > 0
+                ? std::to_string(result.peak_memory_kb / 1024) + " MiB" : "-";
+            std::printf("%6zu  %-14s %10s %6.0f%% %7.2fx %10s\n", j,
+                        schedule_policy_to_string(policy), format_ms(result.makespan_ms).c_str(),
+                        result.utilization * 100.0, speedup, memory.c_str());
+        }
+    }
+    return 0;
+}
+
 // -----------------------------------------------------------------------------
 // Main
 // -----------------------------------------------------------------------------
@@ -303,6 +864,10 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    if (opts.command == Command::WORKER) {
+        return run_worker(opts);
+    }
+
     // Create orchestrator
     BuildOrchestrator orchestrator(opts.config);
     orchestrator.set_progress_callback(ConsoleProgress(opts.config.verbose, opts.config.quiet));
@@ -318,10 +883,26 @@ int main(int argc, char* argv[]) {
                     std::cout << "Build succeeded: "
                               << result.built_targets << " built, "
                               << result.skipped_targets << " up-to-date";
+                    if (result.cutoff_targets > 0) {
+                        std::cout << " (" << result.cutoff_targets << " via early cutoff)";
+                    }
+                    if (result.deduplicated_compiles > 0) {
+                        std::cout << ", " << result.deduplicated_compiles << " shared compiles";
+                    }
+                    if (result.remote_actions > 0) {
+                        std::cout << ", " << result.remote_actions << " actions remote";
+                    }
+                    if (result.fetched_outputs > 0) {
+                        std::cout << ", " << result.fetched_outputs << " outputs fetched";
+                    }
                     if (result.failed_targets > 0) {
                         std::cout << ", " << result.failed_targets << " failed";
                     }
-                    std::cout << " (" << result.total_time.count() << "ms)\n";
+                    std::cout << " (" << result.total_time.count() << "ms";
+                    if (result.link_time.count() > 0) {
+                        std::cout << ", " << result.link_time.count() << "ms linking";
+                    }
+                    std::cout << ")\n";
                 } else {
                     std::cout << "Build failed: "
                               << result.failed_targets << " targets failed\n";
@@ -330,6 +911,9 @@ int main(int argc, char* argv[]) {
                     }
                 }
             }
+            if (opts.show_stats) {
+                print_stats(orchestrator, std::cout);
+            }
 
             return result.success ? 0 : 1;
         }
@@ -365,6 +949,43 @@ int main(int argc, char* argv[]) {
             return result.success ? 0 : 1;
         }
 
+        case Command::TEST: {
+            BuildResult result = orchestrator.build();
+
+            if (!opts.config.quiet) {
+                std::cout << "\n";
+                for (const auto& test : result.test_results) {
+                    std::cout << "  " << test_status_to_string(test.status) << "  "
+                              << test.name;
+                    if (test.status != TestStatus::CACHED) {
+                        std::cout << " (" << test.duration.count() << "ms)";
+                    }
+                    std::cout << "\n";
+                    if (!test.output.empty()) {
+                        std::cout << test.output;
+                        if (test.output.back() != '\n') std::cout << "\n";
+                    }
+                }
+
+                size_t failed = result.tests_failed();
+                std::cout << "\nTests: " << (result.test_results.size() - failed)
+                          << " passed, " << failed << " failed";
+                if (opts.config.test_shard_count > 1) {
+                    std::cout << " (shard " << (opts.config.test_shard_index + 1)
+                              << "/" << opts.config.test_shard_count << ")";
+                }
+                std::cout << " (" << result.total_time.count() << "ms)\n";
+
+                if (result.failed_targets > 0) {
+                    for (const auto& err : result.errors) {
+                        std::cerr << "  Error: " << err << "\n";
+                    }
+                }
+            }
+
+            return result.success ? 0 : 1;
+        }
+
         case Command::CHECK: {
             BuildResult result = orchestrator.check();
 
@@ -400,6 +1021,53 @@ int main(int argc, char* argv[]) {
             std::cout << orchestrator.dependency_graph_dot();
             return 0;
         }
+
+        case Command::ACTIONS: {
+            // Parse to build graph, then lower every target
+            BuildResult dummy = orchestrator.check();
+
+            std::vector<std::string> errors;
+            std::cout << orchestrator.action_graph(errors).to_json();
+            for (const auto& err : errors) {
+                std::cerr << "Error: " << err << "\n";
+            }
+            return errors.empty() ? 0 : 1;
+        }
+
+        case Command::CACHE:
+            return run_cache(orchestrator, opts);
+
+        case Command::SIMULATE:
+            return run_simulate(orchestrator, opts);
+
+        case Command::PGO: {
+            BuildResult result = orchestrator.pgo();
+
+            if (!opts.config.quiet) {
+                std::cout << "\n";
+                for (const auto& test : result.test_results) {
+                    std::cout << "  Training: " << test.name << " "
+                              << test_status_to_string(test.status)
+                              << " (" << test.duration.count() << "ms)\n";
+                }
+                if (result.success) {
+                    std::cout << "PGO build succeeded: " << result.built_targets << " built, "
+                              << result.skipped_targets << " up-to-date with "
+                              << orchestrator.profile_path().string() << " ("
+                              << result.total_time.count() << "ms)\n";
+                } else {
+                    std::cout << "PGO build failed.\n";
+                    for (const auto& err : result.errors) {
+                        std::cerr << "  Error: " << err << "\n";
+                    }
+                }
+            }
+
+            return result.success ? 0 : 1;
+        }
+
+        case Command::WORKER:
+            break;  // Handled before the orchestrator is created
     }
 
     return 0;
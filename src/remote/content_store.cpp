@@ -0,0 +1,698 @@
+/**
+ * content_store.cpp
+ * Implementation of the content-addressable blob store
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "remote/content_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef ARIA_MAKE_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace aria::make {
+
+namespace {
+
+// Compressed blob: magic, dictionary id (zeros = none), zlib stream
+constexpr char COMPRESSED_MAGIC[4] = {'A', 'C', 'Z', '2'};
+constexpr size_t DICT_ID_LEN = 64;
+constexpr size_t COMPRESSED_HEADER = sizeof(COMPRESSED_MAGIC) + DICT_ID_LEN;
+const std::string NO_DICTIONARY(DICT_ID_LEN, '0');
+
+constexpr const char* CHUNK_MANIFEST_MAGIC = "ARIACDC1\n";
+
+// Small blobs are dictionary candidates; training starts once enough
+// have been seen
+constexpr size_t SMALL_BLOB_LIMIT = 128 * 1024;
+constexpr size_t MIN_COMPRESS_SIZE = 64;
+constexpr size_t DICT_TRAIN_SAMPLES = 32;
+constexpr size_t DICT_SAMPLE_BYTES = 2 * 1024 * 1024;
+
+// Content-defined chunking: 16 KiB minimum, ~64 KiB average, 256 KiB maximum
+constexpr size_t CHUNK_MIN = 16 * 1024;
+constexpr size_t CHUNK_MAX = 256 * 1024;
+constexpr uint64_t CHUNK_MASK = (1u << 16) - 1;
+
+// -----------------------------------------------------------------------------
+// SHA-256 (FIPS 180-4)
+// -----------------------------------------------------------------------------
+
+class Sha256 {
+public:
+    void update(const char* data, size_t len) {
+        total_ += len;
+        while (len > 0) {
+            size_t take = std::min(len, sizeof(block_) - used_);
+            std::memcpy(block_ + used_, data, take);
+            used_ += take;
+            data += take;
+            len -= take;
+            if (used_ == sizeof(block_)) {
+                transform();
+                used_ = 0;
+            }
+        }
+    }
+
+    std::string hex_digest() {
+        uint64_t bits = total_ * 8;
+        char pad = static_cast<char>(0x80);
+        update(&pad, 1);
+        char zero = 0;
+        while (used_ != 56) update(&zero, 1);
+        char length[8];
+        for (int i = 0; i < 8; ++i) length[i] = static_cast<char>(bits >> (56 - 8 * i));
+        update(length, 8);
+
+        static const char* digits = "0123456789abcdef";
+        std::string out(64, '0');
+        for (int i = 0; i < 8; ++i) {
+            for (int j = 0; j < 8; ++j) {
+                out[8 * i + j] = digits[(h_[i] >> (28 - 4 * j)) & 0xf];
+            }
+        }
+        return out;
+    }
+
+private:
+    static uint32_t ror(uint32_t v, int n) { return (v >> n) | (v << (32 - n)); }
+
+    void transform() {
+        static const uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            const auto* p = reinterpret_cast<const unsigned char*>(block_ + 4 * i);
+            w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = h_[0], b = h_[1], c = h_[2], d = h_[3];
+        uint32_t e = h_[4], f = h_[5], g = h_[6], h = h_[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        h_[0] += a; h_[1] += b; h_[2] += c; h_[3] += d;
+        h_[4] += e; h_[5] += f; h_[6] += g; h_[7] += h;
+    }
+
+    uint32_t h_[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    char block_[64];
+    size_t used_ = 0;
+    uint64_t total_ = 0;
+};
+
+std::string sha256_hex(const std::string& data) {
+    Sha256 sha;
+    sha.update(data.data(), data.size());
+    return sha.hex_digest();
+}
+
+std::optional<std::string> read_file(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::ostringstream data;
+    data << file.rdbuf();
+    return data.str();
+}
+
+// Write through a unique temp file and rename(); read-only, so an action
+// can never rewrite a hardlinked input in place
+bool write_atomic(const fs::path& dest, const std::string& data) {
+    std::error_code ec;
+    fs::create_directories(dest.parent_path(), ec);
+
+    static std::atomic<uint64_t> counter{0};
+    std::ostringstream tmp_name;
+    tmp_name << dest.filename().string() << ".tmp." << std::this_thread::get_id()
+             << "." << counter++;
+    fs::path tmp = dest.parent_path() / tmp_name.str();
+
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    fs::permissions(tmp, fs::perms::owner_read | fs::perms::group_read |
+                         fs::perms::others_read, ec);
+
+    fs::rename(tmp, dest, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return fs::exists(dest, ec);
+    }
+    return true;
+}
+
+// "<hash>-<size>" as written by Digest::key()
+std::optional<Digest> parse_key(const std::string& key) {
+    size_t dash = key.find('-');
+    if (dash == std::string::npos || dash == 0) return std::nullopt;
+    try {
+        size_t used = 0;
+        uint64_t size = std::stoull(key.substr(dash + 1), &used);
+        if (used != key.size() - dash - 1) return std::nullopt;
+        return Digest{key.substr(0, dash), size};
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+// Gear table for chunk boundaries (fixed, so boundaries are stable)
+const uint64_t* gear_table() {
+    static const auto table = [] {
+        std::array<uint64_t, 256> t{};
+        uint64_t x = 0x9E3779B97F4A7C15ULL;
+        for (auto& entry : t) {
+            x += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            entry = z ^ (z >> 31);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+std::vector<std::pair<size_t, size_t>> chunk_boundaries(const std::string& data) {
+    std::vector<std::pair<size_t, size_t>> chunks;
+    const uint64_t* gear = gear_table();
+    size_t start = 0;
+    while (start < data.size()) {
+        size_t end = std::min(start + CHUNK_MAX, data.size());
+        size_t cut = end;
+        uint64_t hash = 0;
+        for (size_t i = start + std::min(CHUNK_MIN, end - start); i < end; ++i) {
+            hash = (hash << 1) + gear[static_cast<unsigned char>(data[i])];
+            if ((hash & CHUNK_MASK) == 0) {
+                cut = i + 1;
+                break;
+            }
+        }
+        chunks.emplace_back(start, cut - start);
+        start = cut;
+    }
+    return chunks;
+}
+
+#ifdef ARIA_MAKE_HAS_ZLIB
+
+bool deflate_bytes(const std::string& data, const std::string* dictionary, int level,
+                   std::string& out) {
+    z_stream zs{};
+    if (deflateInit(&zs, level) != Z_OK) return false;
+    if (dictionary && deflateSetDictionary(
+            &zs, reinterpret_cast<const Bytef*>(dictionary->data()),
+            static_cast<uInt>(dictionary->size())) != Z_OK) {
+        deflateEnd(&zs);
+        return false;
+    }
+    out.resize(deflateBound(&zs, static_cast<uLong>(data.size())));
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+
+bool inflate_bytes(const char* data, size_t size, const std::string* dictionary,
+                   uint64_t raw_size, std::string& out) {
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK) return false;
+    out.resize(raw_size);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs.avail_in = static_cast<uInt>(size);
+    zs.next_out = reinterpret_cast<Bytef*>(out.empty() ? nullptr : &out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    int rc = inflate(&zs, Z_FINISH);
+    if (rc == Z_NEED_DICT && dictionary) {
+        if (inflateSetDictionary(&zs, reinterpret_cast<const Bytef*>(dictionary->data()),
+                                 static_cast<uInt>(dictionary->size())) == Z_OK) {
+            rc = inflate(&zs, Z_FINISH);
+        }
+    }
+    bool ok = rc == Z_STREAM_END && zs.total_out == raw_size;
+    inflateEnd(&zs);
+    return ok;
+}
+
+#endif // ARIA_MAKE_HAS_ZLIB
+
+} // namespace
+
+// Shared by copies of a store: loaded dictionaries, training samples and
+// restore counters
+struct ContentStore::Shared {
+    std::mutex mutex;
+    bool dictionary_loaded = false;
+    std::string current_dictionary;      // Id for new small blobs ("" = none)
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> dictionaries;
+    std::vector<std::string> samples;
+    size_t sample_bytes = 0;
+
+    std::atomic<uint64_t> restored_bytes{0};
+    std::atomic<uint64_t> restore_ns{0};
+};
+
+ContentStore::ContentStore(fs::path root, StoreOptions options)
+    : root_(std::move(root))
+    , options_(options)
+    , shared_(std::make_shared<Shared>())
+{
+    std::error_code ec;
+    fs::create_directories(root_, ec);
+}
+
+Digest ContentStore::digest_bytes(const std::string& data) {
+    return Digest{sha256_hex(data), data.size()};
+}
+
+Digest ContentStore::digest_file(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+
+    Sha256 sha;
+    uint64_t size = 0;
+    char buffer[8192];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        std::streamsize n = file.gcount();
+        sha.update(buffer, static_cast<size_t>(n));
+        size += static_cast<uint64_t>(n);
+    }
+    return Digest{sha.hex_digest(), size};
+}
+
+fs::path ContentStore::path_for(const Digest& digest) const {
+    return root_ / digest.hash.substr(0, 2) / digest.key();
+}
+
+std::optional<std::pair<fs::path, ContentStore::Encoding>> ContentStore::locate(
+    const fs::path& base, const Digest& digest) const {
+    if (digest.empty()) return std::nullopt;
+
+    std::error_code ec;
+    fs::path raw = base / digest.hash.substr(0, 2) / digest.key();
+    if (fs::exists(raw, ec)) return std::make_pair(raw, Encoding::RAW);
+    fs::path compressed = raw;
+    compressed += ".z";
+    if (fs::exists(compressed, ec)) return std::make_pair(compressed, Encoding::COMPRESSED);
+    fs::path chunked = raw;
+    chunked += ".cdc";
+    if (fs::exists(chunked, ec)) return std::make_pair(chunked, Encoding::CHUNKED);
+    return std::nullopt;
+}
+
+bool ContentStore::contains(const Digest& digest) const {
+    return locate(root_, digest).has_value();
+}
+
+bool ContentStore::put(const Digest& digest, const std::string& data) {
+    if (digest_bytes(data) != digest) {
+        return false;
+    }
+    if (contains(digest)) {
+        return true;
+    }
+
+    if (!options_.chunk_large || data.size() < options_.chunk_threshold) {
+        bool small = data.size() <= SMALL_BLOB_LIMIT;
+        if (small) sample_for_dictionary(data);
+        return store_blob(root_, digest, data, small);
+    }
+
+    // Chunks first, manifest last: a visible manifest is always complete
+    fs::path chunk_root = root_ / "chunks";
+    std::string manifest = CHUNK_MANIFEST_MAGIC;
+    for (const auto& [offset, length] : chunk_boundaries(data)) {
+        std::string chunk = data.substr(offset, length);
+        Digest chunk_digest = digest_bytes(chunk);
+        if (!locate(chunk_root, chunk_digest) &&
+            !store_blob(chunk_root, chunk_digest, chunk, false)) {
+            return false;
+        }
+        manifest += chunk_digest.key() + "\n";
+    }
+    fs::path dest = path_for(digest);
+    dest += ".cdc";
+    return write_atomic(dest, manifest);
+}
+
+bool ContentStore::store_blob(const fs::path& base, const Digest& digest,
+                              const std::string& data, bool use_dictionary) {
+    fs::path dest = base / digest.hash.substr(0, 2) / digest.key();
+
+#ifdef ARIA_MAKE_HAS_ZLIB
+    if (options_.compress && data.size() >= MIN_COMPRESS_SIZE) {
+        std::string dict_id = NO_DICTIONARY;
+        std::shared_ptr<const std::string> dict;
+        if (use_dictionary) {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            if (!shared_->current_dictionary.empty()) {
+                dict_id = shared_->current_dictionary;
+                dict = shared_->dictionaries[dict_id];
+            }
+        }
+
+        // Big blobs favour write speed; decompression costs the same
+        int level = data.size() > SMALL_BLOB_LIMIT ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION;
+        std::string compressed;
+        if (deflate_bytes(data, dict.get(), level, compressed) &&
+            COMPRESSED_HEADER + compressed.size() < data.size() - data.size() / 10) {
+            std::string encoded(COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+            encoded += dict_id;
+            encoded += compressed;
+            fs::path z = dest;
+            z += ".z";
+            return write_atomic(z, encoded);
+        }
+    }
+#else
+    (void)use_dictionary;
+#endif
+
+    // Incompressible (or compression off): as is, so it can be hardlinked
+    return write_atomic(dest, data);
+}
+
+void ContentStore::sample_for_dictionary(const std::string& data) {
+#ifdef ARIA_MAKE_HAS_ZLIB
+    if (!options_.compress || data.size() < MIN_COMPRESS_SIZE) return;
+
+    std::vector<std::string> samples;
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        if (!shared_->dictionary_loaded) {
+            shared_->dictionary_loaded = true;
+            std::string id = read_file(root_ / "dict" / "current").value_or("");
+            auto bytes = id.size() == DICT_ID_LEN ? read_file(root_ / "dict" / id)
+                                                  : std::nullopt;
+            if (bytes) {
+                shared_->current_dictionary = id;
+                shared_->dictionaries[id] = std::make_shared<const std::string>(std::move(*bytes));
+            }
+        }
+        if (!shared_->current_dictionary.empty()) return;
+
+        shared_->samples.push_back(data.substr(0, std::min(data.size(), DICT_SAMPLE_BYTES / 8)));
+        shared_->sample_bytes += shared_->samples.back().size();
+        if (shared_->samples.size() < DICT_TRAIN_SAMPLES &&
+            shared_->sample_bytes < DICT_SAMPLE_BYTES) {
+            return;
+        }
+        samples.swap(shared_->samples);
+        shared_->sample_bytes = 0;
+    }
+
+    std::string dict = train_dictionary(samples);
+    if (dict.empty()) return;
+    std::string id = sha256_hex(dict);
+
+    // Dictionaries are never removed: older blobs still refer to theirs
+    if (!write_atomic(root_ / "dict" / id, dict) ||
+        !write_atomic(root_ / "dict" / "current", id)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->dictionaries[id] = std::make_shared<const std::string>(std::move(dict));
+    shared_->current_dictionary = id;
+#else
+    (void)data;
+#endif
+}
+
+std::shared_ptr<const std::string> ContentStore::dictionary(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    auto it = shared_->dictionaries.find(id);
+    if (it != shared_->dictionaries.end()) return it->second;
+
+    auto bytes = read_file(root_ / "dict" / id);
+    if (!bytes) return nullptr;
+    auto dict = std::make_shared<const std::string>(std::move(*bytes));
+    shared_->dictionaries[id] = dict;
+    return dict;
+}
+
+std::optional<std::string> ContentStore::load_blob(const fs::path& base,
+                                                   const Digest& digest) const {
+    auto found = locate(base, digest);
+    if (!found) return std::nullopt;
+    auto bytes = read_file(found->first);
+    if (!bytes) return std::nullopt;
+
+    switch (found->second) {
+        case Encoding::RAW:
+            return bytes;
+
+        case Encoding::COMPRESSED: {
+#ifdef ARIA_MAKE_HAS_ZLIB
+            if (bytes->size() < COMPRESSED_HEADER ||
+                bytes->compare(0, sizeof(COMPRESSED_MAGIC), COMPRESSED_MAGIC,
+                               sizeof(COMPRESSED_MAGIC)) != 0) {
+                return std::nullopt;
+            }
+            std::string dict_id = bytes->substr(sizeof(COMPRESSED_MAGIC), DICT_ID_LEN);
+            std::shared_ptr<const std::string> dict;
+            if (dict_id != NO_DICTIONARY) {
+                dict = dictionary(dict_id);
+                if (!dict) return std::nullopt;
+            }
+            std::string raw;
+            if (!inflate_bytes(bytes->data() + COMPRESSED_HEADER,
+                               bytes->size() - COMPRESSED_HEADER, dict.get(),
+                               digest.size, raw)) {
+                return std::nullopt;
+            }
+            return raw;
+#else
+            return std::nullopt;    // Written by a build with zlib
+#endif
+        }
+
+        case Encoding::CHUNKED: {
+            std::string magic = CHUNK_MANIFEST_MAGIC;
+            if (bytes->compare(0, magic.size(), magic) != 0) return std::nullopt;
+            std::string raw;
+            raw.reserve(digest.size);
+            std::istringstream lines(bytes->substr(magic.size()));
+            std::string key;
+            while (std::getline(lines, key)) {
+                auto chunk_digest = parse_key(key);
+                if (!chunk_digest) return std::nullopt;
+                auto chunk = load_blob(root_ / "chunks", *chunk_digest);
+                if (!chunk) return std::nullopt;
+                raw += *chunk;
+            }
+            if (raw.size() != digest.size) return std::nullopt;
+            return raw;
+        }
+    }
+    return std::nullopt;
+}
+
+Digest ContentStore::put_file(const fs::path& path) {
+    auto bytes = read_file(path);
+    if (!bytes) {
+        return {};
+    }
+    Digest digest = digest_bytes(*bytes);
+    return put(digest, *bytes) ? digest : Digest{};
+}
+
+std::optional<std::string> ContentStore::read(const Digest& digest) const {
+    return load_blob(root_, digest);
+}
+
+bool ContentStore::materialize(const Digest& digest, const fs::path& dest,
+                               bool executable) const {
+    auto start = std::chrono::steady_clock::now();
+    std::error_code ec;
+    fs::create_directories(dest.parent_path(), ec);
+    fs::remove(dest, ec);
+
+    auto found = locate(root_, digest);
+    if (!found) return false;
+
+    bool placed = false;
+    if (found->second == Encoding::RAW) {
+        // Hardlinks share permission bits with the store copy, so
+        // executables get their own copy instead
+        if (!executable) {
+            fs::create_hard_link(found->first, dest, ec);
+            if (!ec) placed = true;
+        }
+        if (!placed) {
+            fs::copy_file(found->first, dest, fs::copy_options::overwrite_existing, ec);
+            if (ec) return false;
+        }
+    } else {
+        auto data = load_blob(root_, digest);
+        if (!data) return false;
+        std::ofstream out(dest, std::ios::binary | std::ios::trunc);
+        out.write(data->data(), static_cast<std::streamsize>(data->size()));
+        if (!out) return false;
+    }
+
+    if (!placed) {
+        fs::perms perms = fs::perms::owner_read | fs::perms::owner_write |
+                          fs::perms::group_read | fs::perms::others_read;
+        if (executable) {
+            perms |= fs::perms::owner_exec | fs::perms::group_exec | fs::perms::others_exec;
+        }
+        fs::permissions(dest, perms, ec);
+    }
+
+    shared_->restored_bytes += digest.size;
+    shared_->restore_ns += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    return true;
+}
+
+StoreStats ContentStore::stats() const {
+    StoreStats stats;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root_, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        std::string name = it->path().filename().string();
+        if (name.find(".tmp.") != std::string::npos) continue;
+
+        uint64_t size = it->file_size(ec);
+        stats.stored_bytes += size;
+
+        // Chunks and dictionaries are storage, not blobs
+        std::string top = it->path().lexically_relative(root_).begin()->string();
+        if (top == "chunks" || top == "dict") continue;
+
+        if (auto digest = parse_key(name.substr(0, name.find('.')))) {
+            stats.blobs++;
+            stats.logical_bytes += digest->size;
+        }
+    }
+
+    stats.restored_bytes = shared_->restored_bytes;
+    stats.restore_seconds = static_cast<double>(shared_->restore_ns) / 1e9;
+    return stats;
+}
+
+std::string ContentStore::train_dictionary(const std::vector<std::string>& samples,
+                                           size_t max_size) {
+    constexpr size_t K = 8;             // Substring length scored
+    constexpr size_t SEGMENT = 64;      // Dictionary building block
+    constexpr size_t STEP = 32;
+
+    auto kmer = [](const std::string& s, size_t i) {
+        uint64_t v;
+        std::memcpy(&v, s.data() + i, K);
+        return v;
+    };
+
+    // In how many samples each substring occurs
+    std::unordered_map<uint64_t, uint32_t> frequency;
+    for (const auto& sample : samples) {
+        if (sample.size() < K) continue;
+        std::unordered_set<uint64_t> seen;
+        for (size_t i = 0; i + K <= sample.size(); ++i) {
+            uint64_t v = kmer(sample, i);
+            if (seen.insert(v).second) frequency[v]++;
+        }
+    }
+
+    auto score = [&](const std::string& sample, size_t offset) {
+        uint64_t total = 0;
+        size_t end = std::min(offset + SEGMENT, sample.size());
+        for (size_t i = offset; i + K <= end; ++i) {
+            auto it = frequency.find(kmer(sample, i));
+            if (it != frequency.end() && it->second >= 2) total += it->second;
+        }
+        return total;
+    };
+
+    struct Candidate {
+        uint64_t score;
+        size_t sample;
+        size_t offset;
+        bool operator<(const Candidate& other) const { return score < other.score; }
+    };
+    std::priority_queue<Candidate> queue;
+    for (size_t s = 0; s < samples.size(); ++s) {
+        for (size_t offset = 0; offset + K <= samples[s].size(); offset += STEP) {
+            uint64_t value = score(samples[s], offset);
+            if (value > 0) queue.push(Candidate{value, s, offset});
+        }
+    }
+
+    // Greedy cover: take the best segment, then stop counting what it
+    // already contains (scores are re-evaluated lazily)
+    std::vector<std::string> chosen;
+    size_t total = 0;
+    while (!queue.empty() && total < max_size) {
+        Candidate top = queue.top();
+        queue.pop();
+        uint64_t current = score(samples[top.sample], top.offset);
+        if (current == 0) continue;
+        if (current < top.score && !queue.empty() && current < queue.top().score) {
+            queue.push(Candidate{current, top.sample, top.offset});
+            continue;
+        }
+
+        const std::string& sample = samples[top.sample];
+        std::string segment = sample.substr(top.offset, std::min(SEGMENT, max_size - total));
+        for (size_t i = 0; i + K <= segment.size(); ++i) {
+            frequency.erase(kmer(segment, i));
+        }
+        total += segment.size();
+        chosen.push_back(std::move(segment));
+    }
+
+    std::string dict;
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) dict += *it;
+    return dict;
+}
+
+} // namespace aria::make
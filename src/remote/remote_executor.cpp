@@ -0,0 +1,421 @@
+/**
+ * remote_executor.cpp
+ * Implementation of the remote execution client
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "remote/remote_executor.hpp"
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace aria::make {
+
+namespace {
+
+// Uploads smaller than this are latency-dominated; don't learn bandwidth from them
+constexpr uint64_t BANDWIDTH_SAMPLE_MIN_BYTES = 64 * 1024;
+
+double elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - since).count();
+}
+
+bool read_file(const fs::path& path, std::string& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    data = oss.str();
+    return true;
+}
+
+bool expect_reply(int fd, MessageType expected, std::string& payload) {
+    MessageType type;
+    return recv_message(fd, type, payload) && type == expected;
+}
+
+} // namespace
+
+RemoteExecutor::RemoteExecutor(std::vector<Endpoint> endpoints, fs::path exec_root)
+    : exec_root_(fs::absolute(exec_root).lexically_normal())
+{
+    exec_root_prefix_ = exec_root_.string();
+    if (!exec_root_prefix_.empty() && exec_root_prefix_.back() != '/') {
+        exec_root_prefix_ += "/";
+    }
+
+    for (auto& endpoint : endpoints) {
+        auto worker = std::make_unique<WorkerState>();
+        worker->endpoint = std::move(endpoint);
+        workers_.push_back(std::move(worker));
+    }
+}
+
+RemoteExecutor::~RemoteExecutor() {
+    for (auto& worker : workers_) {
+        for (int fd : worker->idle_fds) close(fd);
+    }
+}
+
+size_t RemoteExecutor::connect(std::vector<std::string>& errors) {
+    size_t total = 0;
+
+    for (auto& worker : workers_) {
+        std::string error;
+        auto start = std::chrono::steady_clock::now();
+        int fd = connect_endpoint(worker->endpoint, error);
+        if (fd < 0) {
+            errors.push_back(error);
+            continue;
+        }
+
+        std::string payload;
+        if (!send_message(fd, MessageType::HELLO, "") ||
+            !expect_reply(fd, MessageType::HELLO_REPLY, payload)) {
+            errors.push_back("handshake with " + worker->endpoint.to_string() + " failed");
+            close(fd);
+            continue;
+        }
+
+        try {
+            WireReader r(payload);
+            uint32_t version = r.u32();
+            if (version != REMOTE_PROTOCOL_VERSION) {
+                errors.push_back(worker->endpoint.to_string() + " speaks protocol " +
+                                 std::to_string(version));
+                close(fd);
+                continue;
+            }
+            worker->slots = r.u32();
+        } catch (const std::exception& e) {
+            errors.push_back(worker->endpoint.to_string() + ": " + e.what());
+            close(fd);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        worker->rtt_ms = std::max(elapsed_ms(start), 0.05);
+        worker->alive = worker->slots > 0;
+        worker->idle_fds.push_back(fd);
+        total += worker->slots;
+    }
+
+    return total;
+}
+
+size_t RemoteExecutor::slots() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto& worker : workers_) {
+        if (worker->alive) total += worker->slots;
+    }
+    return total;
+}
+
+RemoteStats RemoteExecutor::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string RemoteExecutor::relativize(const std::string& path) const {
+    fs::path p = fs::path(path);
+    if (p.is_relative()) {
+        p = p.lexically_normal();
+        std::string rel = p.string();
+        return rel.rfind("../", 0) == 0 || rel == ".." ? "" : rel;
+    }
+    std::string abs = p.lexically_normal().string();
+    if (abs.rfind(exec_root_prefix_, 0) != 0) return "";
+    return abs.substr(exec_root_prefix_.size());
+}
+
+std::string RemoteExecutor::rewrite_arg(const std::string& arg) const {
+    if (arg + "/" == exec_root_prefix_) return ".";
+
+    // Covers plain paths as well as joined forms such as -L/root/lib
+    std::string out;
+    size_t pos = 0;
+    while (true) {
+        size_t hit = arg.find(exec_root_prefix_, pos);
+        if (hit == std::string::npos) break;
+        out.append(arg, pos, hit - pos);
+        pos = hit + exec_root_prefix_.size();
+    }
+    out.append(arg, pos, std::string::npos);
+    return out;
+}
+
+Digest RemoteExecutor::cached_digest(const fs::path& path) {
+    std::error_code ec;
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec) return {};
+    uint64_t size = fs::file_size(path, ec);
+    if (ec) return {};
+
+    std::string key = path.string();
+    {
+        std::lock_guard<std::mutex> lock(digest_mutex_);
+        auto it = digest_cache_.find(key);
+        if (it != digest_cache_.end() && it->second.mtime == mtime &&
+            it->second.size == size) {
+            return it->second.digest;
+        }
+    }
+
+    Digest digest = ContentStore::digest_file(path);
+    std::lock_guard<std::mutex> lock(digest_mutex_);
+    digest_cache_[key] = DigestEntry{mtime, size, digest};
+    return digest;
+}
+
+bool RemoteExecutor::prepare(const Action& action, RemoteRequest& request,
+                             std::vector<PreparedInput>& inputs,
+                             std::vector<std::pair<std::string, std::string>>& outputs) {
+    if (action.kind == ActionKind::TEST) {
+        return false;  // Tests may touch anything; always local
+    }
+
+    for (const auto& arg : action.argv) {
+        request.argv.push_back(rewrite_arg(arg));
+    }
+    request.env = action.env;
+    request.timeout_ms = static_cast<uint64_t>(action.timeout.count());
+
+    if (!action.working_dir.empty()) {
+        std::string rel = relativize(fs::absolute(action.working_dir).string());
+        if (rel.empty() && fs::absolute(action.working_dir).lexically_normal() != exec_root_) {
+            return false;
+        }
+        request.working_dir = rel == "." ? "" : rel;
+    }
+
+    for (const auto& input : action.inputs) {
+        std::string rel = relativize(input);
+        if (rel.empty()) return false;
+
+        std::error_code ec;
+        fs::path local = fs::path(input);
+        if (!fs::is_regular_file(local, ec)) return false;
+
+        PreparedInput prepared;
+        prepared.local_path = local;
+        prepared.file.path = rel;
+        prepared.file.digest = cached_digest(local);
+        if (prepared.file.digest.empty()) return false;
+        auto perms = fs::status(local, ec).permissions();
+        prepared.file.executable = (perms & fs::perms::owner_exec) != fs::perms::none;
+
+        request.inputs.push_back(prepared.file);
+        inputs.push_back(std::move(prepared));
+    }
+
+    for (const auto& output : action.outputs) {
+        std::string rel = relativize(output);
+        if (rel.empty()) return false;
+        request.outputs.push_back(rel);
+        outputs.emplace_back(rel, output);
+    }
+    return true;
+}
+
+std::optional<ProcessResult> RemoteExecutor::try_execute(const Action& action,
+                                                         double local_wait_ms) {
+    RemoteRequest request;
+    std::vector<PreparedInput> inputs;
+    std::vector<std::pair<std::string, std::string>> outputs;
+    if (!prepare(action, request, inputs, outputs)) {
+        return std::nullopt;
+    }
+
+    // Pick the cheapest worker with a free slot
+    WorkerState* chosen = nullptr;
+    int fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double best = std::numeric_limits<double>::max();
+        for (auto& worker : workers_) {
+            if (!worker->alive || worker->in_flight >= worker->slots) continue;
+
+            uint64_t missing = 0;
+            for (const auto& input : inputs) {
+                if (!worker->known.count(input.file.digest.key())) {
+                    missing += input.file.digest.size;
+                }
+            }
+            double cost = worker->rtt_ms + static_cast<double>(missing) / worker->bytes_per_ms;
+            if (cost < best) {
+                best = cost;
+                chosen = worker.get();
+            }
+        }
+        if (!chosen || best > local_wait_ms) {
+            return std::nullopt;
+        }
+
+        chosen->in_flight++;
+        if (!chosen->idle_fds.empty()) {
+            fd = chosen->idle_fds.back();
+            chosen->idle_fds.pop_back();
+        }
+    }
+
+    if (fd < 0) {
+        std::string error;
+        fd = connect_endpoint(chosen->endpoint, error);
+    }
+
+    bool transport_ok = fd >= 0;
+    std::optional<ProcessResult> result;
+    if (transport_ok) {
+        result = run_on(*chosen, fd, request, inputs, outputs, transport_ok);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    chosen->in_flight--;
+    if (transport_ok) {
+        chosen->idle_fds.push_back(fd);
+        if (result) stats_.remote_actions++;
+    } else {
+        if (fd >= 0) close(fd);
+        chosen->alive = false;  // Retire it; the action falls back to local
+        result.reset();
+    }
+    return result;
+}
+
+std::optional<ProcessResult> RemoteExecutor::run_on(
+    WorkerState& worker, int fd, RemoteRequest& request,
+    const std::vector<PreparedInput>& inputs,
+    const std::vector<std::pair<std::string, std::string>>& outputs,
+    bool& transport_ok) {
+
+    transport_ok = false;
+
+    // Ask which blobs the worker lacks
+    auto rtt_start = std::chrono::steady_clock::now();
+    WireWriter query;
+    query.u32(static_cast<uint32_t>(inputs.size()));
+    for (const auto& input : inputs) query.digest(input.file.digest);
+
+    std::string payload;
+    if (!send_message(fd, MessageType::FIND_MISSING, query.data()) ||
+        !expect_reply(fd, MessageType::MISSING, payload)) {
+        return std::nullopt;
+    }
+    double rtt = elapsed_ms(rtt_start);
+
+    std::unordered_set<std::string> missing;
+    {
+        WireReader r(payload);
+        uint32_t count = r.u32();
+        for (uint32_t i = 0; i < count; ++i) missing.insert(r.digest().key());
+    }
+
+    // Upload only what is missing (each distinct blob once)
+    auto upload_start = std::chrono::steady_clock::now();
+    uint64_t uploaded_bytes = 0;
+    size_t uploaded_blobs = 0;
+    for (const auto& input : inputs) {
+        const std::string key = input.file.digest.key();
+        if (!missing.count(key)) continue;
+        missing.erase(key);
+
+        std::string data;
+        if (!read_file(input.local_path, data) ||
+            ContentStore::digest_bytes(data) != input.file.digest) {
+            transport_ok = true;  // Local file changed under us; not the worker's fault
+            return std::nullopt;
+        }
+
+        WireWriter upload;
+        upload.digest(input.file.digest);
+        upload.str(data);
+        if (!send_message(fd, MessageType::UPLOAD, upload.data()) ||
+            !expect_reply(fd, MessageType::UPLOAD_OK, payload)) {
+            return std::nullopt;
+        }
+        uploaded_bytes += data.size();
+        uploaded_blobs++;
+    }
+    double upload_ms = elapsed_ms(upload_start);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        worker.rtt_ms = 0.8 * worker.rtt_ms + 0.2 * rtt;
+        if (uploaded_bytes >= BANDWIDTH_SAMPLE_MIN_BYTES && upload_ms > 0) {
+            worker.bytes_per_ms = 0.7 * worker.bytes_per_ms +
+                                  0.3 * (static_cast<double>(uploaded_bytes) / upload_ms);
+        }
+        for (const auto& input : inputs) worker.known.insert(input.file.digest.key());
+        stats_.blobs_uploaded += uploaded_blobs;
+        stats_.bytes_uploaded += uploaded_bytes;
+        stats_.blobs_present += inputs.size() - uploaded_blobs;
+    }
+
+    // Execute
+    if (!send_message(fd, MessageType::EXECUTE, request.encode()) ||
+        !expect_reply(fd, MessageType::EXECUTE_REPLY, payload)) {
+        return std::nullopt;
+    }
+    transport_ok = true;
+
+    RemoteResponse response;
+    try {
+        response = RemoteResponse::decode(payload);
+    } catch (const std::exception&) {
+        transport_ok = false;
+        return std::nullopt;
+    }
+
+    ProcessResult result;
+    result.exit_code = response.exit_code;
+    result.timed_out = response.timed_out;
+    result.stdout_output = std::move(response.stdout_output);
+    result.stderr_output = std::move(response.stderr_output);
+    result.duration = std::chrono::milliseconds(response.duration_ms);
+
+    // Write returned outputs back to their local paths
+    for (size_t i = 0; i < response.outputs.size(); ++i) {
+        const RemoteFile& file = response.outputs[i];
+        const std::string& data = response.output_data[i];
+        if (ContentStore::digest_bytes(data) != file.digest) {
+            transport_ok = false;
+            return std::nullopt;
+        }
+
+        auto local = std::find_if(outputs.begin(), outputs.end(),
+                                  [&](const auto& o) { return o.first == file.path; });
+        if (local == outputs.end()) continue;
+
+        fs::path dest = local->second;
+        std::error_code ec;
+        fs::create_directories(dest.parent_path(), ec);
+        fs::path tmp = dest;
+        tmp += ".remote-tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!out) return std::nullopt;
+        }
+        if (file.executable) {
+            fs::permissions(tmp, fs::perms::owner_exec | fs::perms::group_exec |
+                                 fs::perms::others_exec, fs::perm_options::add, ec);
+        }
+        fs::rename(tmp, dest, ec);
+        if (ec) return std::nullopt;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& file : response.outputs) worker.known.insert(file.digest.key());
+    }
+    return result;
+}
+
+} // namespace aria::make
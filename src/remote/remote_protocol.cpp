@@ -0,0 +1,401 @@
+/**
+ * remote_protocol.cpp
+ * Sockets, framing and message encoding for remote execution
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "remote/remote_protocol.hpp"
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace aria::make {
+
+namespace {
+
+// Refuse absurd frames instead of trying to allocate them
+constexpr uint64_t MAX_MESSAGE_SIZE = 1ULL << 32;  // 4GB
+
+bool write_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool read_all(int fd, char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = recv(fd, data, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return false;  // Peer closed
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void put_le(std::string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+uint64_t get_le(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+void write_files(WireWriter& w, const std::vector<RemoteFile>& files) {
+    w.u32(static_cast<uint32_t>(files.size()));
+    for (const auto& file : files) {
+        w.str(file.path);
+        w.digest(file.digest);
+        w.u32(file.executable ? 1 : 0);
+    }
+}
+
+std::vector<RemoteFile> read_files(WireReader& r) {
+    std::vector<RemoteFile> files(r.u32());
+    for (auto& file : files) {
+        file.path = r.str();
+        file.digest = r.digest();
+        file.executable = r.u32() != 0;
+    }
+    return files;
+}
+
+} // namespace
+
+// =============================================================================
+// Endpoints
+// =============================================================================
+
+std::optional<Endpoint> Endpoint::parse(const std::string& spec) {
+    Endpoint ep;
+
+    if (spec.rfind("unix:", 0) == 0) {
+        ep.kind = Kind::UNIX;
+        ep.path = spec.substr(5);
+        if (ep.path.empty()) return std::nullopt;
+        return ep;
+    }
+
+    std::string rest = spec.rfind("tcp:", 0) == 0 ? spec.substr(4) : spec;
+    size_t colon = rest.rfind(':');
+    if (colon == std::string::npos) return std::nullopt;
+
+    ep.kind = Kind::TCP;
+    ep.host = rest.substr(0, colon);
+    if (ep.host.empty()) ep.host = "127.0.0.1";
+    try {
+        unsigned long port = std::stoul(rest.substr(colon + 1));
+        if (port > 65535) return std::nullopt;
+        ep.port = static_cast<uint16_t>(port);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    return ep;
+}
+
+std::string Endpoint::to_string() const {
+    if (kind == Kind::UNIX) return "unix:" + path;
+    return "tcp:" + host + ":" + std::to_string(port);
+}
+
+int connect_endpoint(const Endpoint& endpoint, std::string& error) {
+    if (endpoint.kind == Endpoint::Kind::UNIX) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            error = std::string("socket: ") + strerror(errno);
+            return -1;
+        }
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (endpoint.path.size() >= sizeof(addr.sun_path)) {
+            close(fd);
+            error = "socket path too long: " + endpoint.path;
+            return -1;
+        }
+        std::strcpy(addr.sun_path, endpoint.path.c_str());
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            error = "connect " + endpoint.to_string() + ": " + strerror(errno);
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    int rc = getaddrinfo(endpoint.host.c_str(), std::to_string(endpoint.port).c_str(),
+                         &hints, &result);
+    if (rc != 0) {
+        error = "resolve " + endpoint.host + ": " + gai_strerror(rc);
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+
+    if (fd < 0) {
+        error = "connect " + endpoint.to_string() + ": " + strerror(errno);
+        return -1;
+    }
+
+    // Requests are small and latency-bound
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+int listen_endpoint(const Endpoint& endpoint, std::string& error) {
+    int fd;
+    if (endpoint.kind == Endpoint::Kind::UNIX) {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            error = std::string("socket: ") + strerror(errno);
+            return -1;
+        }
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (endpoint.path.size() >= sizeof(addr.sun_path)) {
+            close(fd);
+            error = "socket path too long: " + endpoint.path;
+            return -1;
+        }
+        std::strcpy(addr.sun_path, endpoint.path.c_str());
+        unlink(endpoint.path.c_str());  // Stale socket from a previous run
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            error = "bind " + endpoint.to_string() + ": " + strerror(errno);
+            close(fd);
+            return -1;
+        }
+    } else {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo* result = nullptr;
+        int rc = getaddrinfo(endpoint.host.c_str(), std::to_string(endpoint.port).c_str(),
+                             &hints, &result);
+        if (rc != 0) {
+            error = "resolve " + endpoint.host + ": " + gai_strerror(rc);
+            return -1;
+        }
+        fd = socket(result->ai_family, result->ai_socktype | SOCK_CLOEXEC,
+                    result->ai_protocol);
+        if (fd < 0) {
+            freeaddrinfo(result);
+            error = std::string("socket: ") + strerror(errno);
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, result->ai_addr, result->ai_addrlen) != 0) {
+            error = "bind " + endpoint.to_string() + ": " + strerror(errno);
+            freeaddrinfo(result);
+            close(fd);
+            return -1;
+        }
+        freeaddrinfo(result);
+    }
+
+    if (listen(fd, 64) != 0) {
+        error = "listen " + endpoint.to_string() + ": " + strerror(errno);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+uint16_t bound_port(int listen_fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    if (getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        addr.sin_family != AF_INET) {
+        return 0;
+    }
+    return ntohs(addr.sin_port);
+}
+
+// =============================================================================
+// Framing
+// =============================================================================
+
+bool send_message(int fd, MessageType type, const std::string& payload) {
+    std::string header;
+    put_le(header, static_cast<uint32_t>(type), 4);
+    put_le(header, payload.size(), 8);
+    return write_all(fd, header.data(), header.size()) &&
+           write_all(fd, payload.data(), payload.size());
+}
+
+bool recv_message(int fd, MessageType& type, std::string& payload) {
+    char header[12];
+    if (!read_all(fd, header, sizeof(header))) {
+        return false;
+    }
+    type = static_cast<MessageType>(get_le(header, 4));
+    uint64_t size = get_le(header + 4, 8);
+    if (size > MAX_MESSAGE_SIZE) {
+        return false;
+    }
+    payload.resize(size);
+    return size == 0 || read_all(fd, payload.data(), size);
+}
+
+void WireWriter::u32(uint32_t value) { put_le(data_, value, 4); }
+void WireWriter::u64(uint64_t value) { put_le(data_, value, 8); }
+
+void WireWriter::str(const std::string& value) {
+    u64(value.size());
+    data_ += value;
+}
+
+void WireWriter::strings(const std::vector<std::string>& values) {
+    u32(static_cast<uint32_t>(values.size()));
+    for (const auto& value : values) str(value);
+}
+
+void WireWriter::digest(const Digest& value) {
+    str(value.hash);
+    u64(value.size);
+}
+
+void WireReader::need(size_t n) const {
+    if (data_.size() - pos_ < n) {
+        throw std::runtime_error("truncated remote message");
+    }
+}
+
+uint32_t WireReader::u32() {
+    need(4);
+    uint32_t value = static_cast<uint32_t>(get_le(data_.data() + pos_, 4));
+    pos_ += 4;
+    return value;
+}
+
+uint64_t WireReader::u64() {
+    need(8);
+    uint64_t value = get_le(data_.data() + pos_, 8);
+    pos_ += 8;
+    return value;
+}
+
+std::string WireReader::str() {
+    uint64_t len = u64();
+    need(len);
+    std::string value = data_.substr(pos_, len);
+    pos_ += len;
+    return value;
+}
+
+std::vector<std::string> WireReader::strings() {
+    uint32_t count = u32();
+    std::vector<std::string> values;
+    values.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) values.push_back(str());
+    return values;
+}
+
+Digest WireReader::digest() {
+    Digest value;
+    value.hash = str();
+    value.size = u64();
+    return value;
+}
+
+// =============================================================================
+// Messages
+// =============================================================================
+
+std::string RemoteRequest::encode() const {
+    WireWriter w;
+    w.strings(argv);
+    w.u32(static_cast<uint32_t>(env.size()));
+    for (const auto& [key, value] : env) {
+        w.str(key);
+        w.str(value);
+    }
+    w.str(working_dir);
+    w.u64(timeout_ms);
+    write_files(w, inputs);
+    w.strings(outputs);
+    return w.data();
+}
+
+RemoteRequest RemoteRequest::decode(const std::string& payload) {
+    WireReader r(payload);
+    RemoteRequest req;
+    req.argv = r.strings();
+    uint32_t env_count = r.u32();
+    for (uint32_t i = 0; i < env_count; ++i) {
+        std::string key = r.str();
+        req.env.emplace_back(key, r.str());
+    }
+    req.working_dir = r.str();
+    req.timeout_ms = r.u64();
+    req.inputs = read_files(r);
+    req.outputs = r.strings();
+    return req;
+}
+
+std::string RemoteResponse::encode() const {
+    WireWriter w;
+    w.u32(static_cast<uint32_t>(exit_code));
+    w.u32(timed_out ? 1 : 0);
+    w.str(stdout_output);
+    w.str(stderr_output);
+    w.u64(duration_ms);
+    write_files(w, outputs);
+    w.strings(output_data);
+    return w.data();
+}
+
+RemoteResponse RemoteResponse::decode(const std::string& payload) {
+    WireReader r(payload);
+    RemoteResponse resp;
+    resp.exit_code = static_cast<int32_t>(r.u32());
+    resp.timed_out = r.u32() != 0;
+    resp.stdout_output = r.str();
+    resp.stderr_output = r.str();
+    resp.duration_ms = r.u64();
+    resp.outputs = read_files(r);
+    resp.output_data = r.strings();
+    if (resp.output_data.size() != resp.outputs.size()) {
+        throw std::runtime_error("remote response output count mismatch");
+    }
+    return resp;
+}
+
+} // namespace aria::make
@@ -0,0 +1,295 @@
+/**
+ * worker.cpp
+ * Implementation of the remote execution worker
+ *
+ * Copyright (c) 2025 Aria Language Project
+ */
+
+#include "remote/worker.hpp"
+#include "core/cpu_topology.hpp"
+#include "core/process_runner.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace aria::make {
+
+namespace {
+
+// Scratch-relative paths only: no absolute paths, no escaping via ".."
+bool safe_relative(const std::string& path) {
+    fs::path p(path);
+    if (p.empty() || p.is_absolute()) return false;
+    for (const auto& part : p) {
+        if (part == "..") return false;
+    }
+    return true;
+}
+
+void send_error(int fd, const std::string& message) {
+    WireWriter w;
+    w.str(message);
+    send_message(fd, MessageType::ERROR, w.data());
+}
+
+} // namespace
+
+Worker::Worker(WorkerConfig config)
+    : config_(std::move(config))
+    , store_(config_.cache_dir / "cas", config_.store)
+{
+    if (config_.slots == 0) {
+        config_.slots = default_job_count();
+    }
+}
+
+Worker::~Worker() {
+    stop();
+
+    // Join outside the lock: exiting connection threads take it to deregister
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        threads.swap(connections_);
+    }
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+bool Worker::start(std::string& error) {
+    listen_fd_ = listen_endpoint(config_.endpoint, error);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+    if (config_.endpoint.kind == Endpoint::Kind::TCP && config_.endpoint.port == 0) {
+        config_.endpoint.port = bound_port(listen_fd_);
+    }
+    return true;
+}
+
+Endpoint Worker::endpoint() const {
+    return config_.endpoint;
+}
+
+void Worker::serve() {
+    while (!stopping_) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;  // Listener shut down (stop()) or fatal error
+        }
+
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        if (stopping_) {
+            close(fd);
+            break;
+        }
+        connection_fds_.push_back(fd);
+        connections_.emplace_back([this, fd] { handle_connection(fd); });
+    }
+}
+
+void Worker::stop() {
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    if (listen_fd_ >= 0) {
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    if (config_.endpoint.kind == Endpoint::Kind::UNIX) {
+        unlink(config_.endpoint.path.c_str());
+    }
+
+    // Wake connection threads blocked in recv()
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (int fd : connection_fds_) {
+        shutdown(fd, SHUT_RDWR);
+    }
+}
+
+void Worker::handle_connection(int fd) {
+    MessageType type;
+    std::string payload;
+
+    while (!stopping_ && recv_message(fd, type, payload)) {
+        try {
+            switch (type) {
+                case MessageType::HELLO: {
+                    WireWriter w;
+                    w.u32(REMOTE_PROTOCOL_VERSION);
+                    w.u32(static_cast<uint32_t>(config_.slots));
+                    send_message(fd, MessageType::HELLO_REPLY, w.data());
+                    break;
+                }
+
+                case MessageType::FIND_MISSING: {
+                    WireReader r(payload);
+                    uint32_t count = r.u32();
+                    std::vector<Digest> missing;
+                    for (uint32_t i = 0; i < count; ++i) {
+                        Digest digest = r.digest();
+                        if (!store_.contains(digest)) missing.push_back(digest);
+                    }
+                    WireWriter w;
+                    w.u32(static_cast<uint32_t>(missing.size()));
+                    for (const auto& digest : missing) w.digest(digest);
+                    send_message(fd, MessageType::MISSING, w.data());
+                    break;
+                }
+
+                case MessageType::UPLOAD: {
+                    WireReader r(payload);
+                    Digest digest = r.digest();
+                    std::string data = r.str();
+                    if (store_.put(digest, data)) {
+                        send_message(fd, MessageType::UPLOAD_OK, "");
+                    } else {
+                        send_error(fd, "blob does not match digest " + digest.key());
+                    }
+                    break;
+                }
+
+                case MessageType::EXECUTE: {
+                    RemoteResponse response = execute(RemoteRequest::decode(payload));
+                    send_message(fd, MessageType::EXECUTE_REPLY, response.encode());
+                    break;
+                }
+
+                default:
+                    send_error(fd, "unexpected message type " +
+                                   std::to_string(static_cast<uint32_t>(type)));
+                    break;
+            }
+        } catch (const std::exception& e) {
+            send_error(fd, e.what());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connection_fds_.erase(
+            std::remove(connection_fds_.begin(), connection_fds_.end(), fd),
+            connection_fds_.end());
+    }
+    close(fd);
+}
+
+RemoteResponse Worker::execute(const RemoteRequest& request) {
+    RemoteResponse response;
+
+    {
+        std::unique_lock<std::mutex> lock(slot_mutex_);
+        slot_cv_.wait(lock, [this] { return running_ < config_.slots; });
+        ++running_;
+    }
+    struct SlotGuard {
+        Worker* worker;
+        ~SlotGuard() {
+            {
+                std::lock_guard<std::mutex> lock(worker->slot_mutex_);
+                --worker->running_;
+            }
+            worker->slot_cv_.notify_one();
+        }
+    } slot_guard{this};
+
+    std::ostringstream scratch_name;
+    scratch_name << getpid() << "-" << next_scratch_++;
+    fs::path scratch = fs::absolute(config_.cache_dir / "scratch" / scratch_name.str());
+    std::error_code ec;
+    fs::create_directories(scratch, ec);
+
+    struct ScratchGuard {
+        fs::path dir;
+        ~ScratchGuard() {
+            std::error_code ec;
+            fs::remove_all(dir, ec);
+        }
+    } scratch_guard{scratch};
+
+    // Materialize inputs
+    for (const auto& input : request.inputs) {
+        if (!safe_relative(input.path)) {
+            response.stderr_output = "refusing input path " + input.path;
+            return response;
+        }
+        if (!store_.materialize(input.digest, scratch / input.path, input.executable)) {
+            response.stderr_output = "missing input blob " + input.digest.key() +
+                                     " for " + input.path;
+            return response;
+        }
+    }
+    for (const auto& output : request.outputs) {
+        if (!safe_relative(output)) {
+            response.stderr_output = "refusing output path " + output;
+            return response;
+        }
+        fs::create_directories((scratch / output).parent_path(), ec);
+    }
+    if (!request.working_dir.empty() && !safe_relative(request.working_dir)) {
+        response.stderr_output = "refusing working directory " + request.working_dir;
+        return response;
+    }
+
+    if (config_.verbose) {
+        std::cout << "[worker]";
+        for (const auto& arg : request.argv) std::cout << " " << arg;
+        std::cout << "\n";
+    }
+
+    ProcessSpec spec;
+    spec.argv = request.argv;
+    spec.env = request.env;
+    spec.working_dir = request.working_dir.empty() ? scratch : scratch / request.working_dir;
+    spec.timeout = std::chrono::milliseconds(request.timeout_ms);
+
+    ProcessResult run;
+    try {
+        run = run_process(spec);
+    } catch (const std::exception& e) {
+        response.stderr_output = std::string("worker failed to run action: ") + e.what();
+        return response;
+    }
+
+    response.exit_code = run.exit_code;
+    response.timed_out = run.timed_out;
+    response.stdout_output = run.stdout_output;
+    response.stderr_output = run.stderr_output;
+    response.duration_ms = static_cast<uint64_t>(run.duration.count());
+
+    if (!run.success()) {
+        return response;
+    }
+
+    // Collect outputs (missing ones are left for the client to report)
+    for (const auto& output : request.outputs) {
+        fs::path produced = scratch / output;
+        std::ifstream file(produced, std::ios::binary);
+        if (!file) continue;
+        std::ostringstream data;
+        data << file.rdbuf();
+
+        RemoteFile out;
+        out.path = output;
+        out.digest = ContentStore::digest_bytes(data.str());
+        auto perms = fs::status(produced, ec).permissions();
+        out.executable = (perms & fs::perms::owner_exec) != fs::perms::none;
+        store_.put(out.digest, data.str());
+
+        response.outputs.push_back(std::move(out));
+        response.output_data.push_back(data.str());
+    }
+
+    return response;
+}
+
+} // namespace aria::make
@@ -0,0 +1,473 @@
+// batch_io.cpp - io_uring and thread-pool implementations of BatchReader
+// Part of aria_make - Aria Build System
+//
+// The io_uring backend talks to the kernel through the raw syscalls and
+// ring mappings rather than liburing, so there is no extra dependency.
+
+#include "state/batch_io.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define ARIA_MAKE_HAS_IO_URING 1
+#endif
+
+namespace aria::make {
+
+namespace {
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+
+FileStat from_stat(const struct stat& st) {
+    FileStat out;
+    out.exists = true;
+    out.regular = S_ISREG(st.st_mode);
+    out.size = static_cast<uint64_t>(st.st_size);
+    out.mtime_sec = st.st_mtim.tv_sec;
+    out.mtime_nsec = static_cast<uint32_t>(st.st_mtim.tv_nsec);
+    out.ctime_sec = st.st_ctim.tv_sec;
+    out.ctime_nsec = static_cast<uint32_t>(st.st_ctim.tv_nsec);
+    out.ino = static_cast<uint64_t>(st.st_ino);
+    return out;
+}
+
+FileStat stat_path(const std::string& path) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) return FileStat{};
+    return from_stat(st);
+}
+
+// Blocking read of a whole file in READ_CHUNK pieces
+bool read_file(const std::string& path, size_t index, std::vector<char>& buffer,
+               const BatchReader::ContentSink& sink) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = true;
+    while (true) {
+        ssize_t n = ::read(fd, buffer.data(), buffer.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+        if (n == 0) break;
+        sink(index, buffer.data(), static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Thread pool backend
+// -----------------------------------------------------------------------------
+
+class ThreadBatchReader : public BatchReader {
+public:
+    const char* name() const override { return "threads"; }
+
+    std::vector<FileStat> stat_all(const std::vector<std::string>& paths) override {
+        std::vector<FileStat> result(paths.size());
+        parallel_for(paths.size(), [&](size_t i, std::vector<char>&) {
+            result[i] = stat_path(paths[i]);
+        });
+        return result;
+    }
+
+    std::vector<bool> read_all(const std::vector<std::string>& paths,
+                               const std::vector<size_t>& selected,
+                               const ContentSink& sink) override {
+        // vector<bool> packs bits; collect into bytes and convert
+        std::vector<char> ok(selected.size(), 0);
+        parallel_for(selected.size(), [&](size_t k, std::vector<char>& buffer) {
+            ok[k] = read_file(paths[selected[k]], selected[k], buffer, sink) ? 1 : 0;
+        });
+        return std::vector<bool>(ok.begin(), ok.end());
+    }
+
+private:
+    // I/O bound: more workers than cores still helps hide device latency
+    static constexpr size_t WORKERS = 16;
+
+    template <typename Fn>
+    void parallel_for(size_t count, Fn fn) {
+        size_t workers = std::min(WORKERS, count);
+        std::atomic<size_t> next{0};
+        auto work = [&] {
+            std::vector<char> buffer(READ_CHUNK);
+            for (size_t i = next++; i < count; i = next++) fn(i, buffer);
+        };
+        if (workers <= 1) {
+            work();
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < workers; ++t) threads.emplace_back(work);
+        work();
+        for (auto& thread : threads) thread.join();
+    }
+};
+
+// -----------------------------------------------------------------------------
+// io_uring backend
+// -----------------------------------------------------------------------------
+
+#ifdef ARIA_MAKE_HAS_IO_URING
+
+class Ring {
+public:
+    bool init(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) return false;
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+        sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED) { sq_ptr_ = nullptr; return false; }
+        cq_ptr_ = single ? sq_ptr_
+                         : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) { cq_ptr_ = nullptr; return false; }
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+        if (sqes_ == MAP_FAILED) { sqes_ = nullptr; return false; }
+
+        auto* sq = static_cast<char*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+
+        auto* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    ~Ring() {
+        if (sqes_) munmap(sqes_, sqes_size_);
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_size_);
+        if (sq_ptr_) munmap(sq_ptr_, sq_size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    unsigned capacity() const { return sq_entries_; }
+
+    // Next free SQE (caller keeps in-flight requests within capacity())
+    io_uring_sqe* next_sqe(uint64_t user_data) {
+        unsigned tail = *sq_tail_;
+        unsigned slot = tail & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[slot];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->user_data = user_data;
+        sq_array_[slot] = slot;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+        return sqe;
+    }
+
+    // Submit queued SQEs and wait for at least one completion
+    bool submit_and_wait() {
+        while (true) {
+            long rc = syscall(__NR_io_uring_enter, fd_, pending_, 1u,
+                              IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (rc >= 0) {
+                pending_ -= static_cast<unsigned>(rc);
+                return true;
+            }
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+        }
+    }
+
+    // After a failed submit: wait for the requests the kernel already took
+    // (`in_flight` minus those never submitted) and pass their completions
+    // to `fn`. False if they cannot be waited for; the memory they target
+    // must then outlive the process.
+    template <typename Fn>
+    bool drain(size_t in_flight, Fn fn) {
+        size_t outstanding = in_flight - pending_;
+        while (true) {
+            reap([&](uint64_t user_data, int res) {
+                fn(user_data, res);
+                --outstanding;
+            });
+            if (outstanding == 0) return true;
+            long rc = syscall(__NR_io_uring_enter, fd_, 0u, 1u, IORING_ENTER_GETEVENTS,
+                              nullptr, 0);
+            if (rc < 0 && errno != EINTR) return false;
+        }
+    }
+
+    // Visit and consume every available completion
+    template <typename Fn>
+    void reap(Fn fn) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            fn(cqe.user_data, cqe.res);
+            ++head;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    int fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned pending_ = 0;
+};
+
+// Once a submit fails the ring is torn down and every later call goes to
+// the thread pool: requests already queued in it cannot be trusted to
+// complete, let alone into buffers this reader still owns
+class UringBatchReader : public BatchReader {
+public:
+    bool init() {
+        ring_ = std::make_unique<Ring>();
+        return ring_->init(QUEUE_DEPTH);
+    }
+
+    const char* name() const override { return ring_ ? "io_uring" : threads_.name(); }
+
+    std::vector<FileStat> stat_all(const std::vector<std::string>& paths) override {
+        if (!ring_) return threads_.stat_all(paths);
+
+        std::vector<FileStat> result(paths.size());
+        std::vector<bool> done(paths.size(), false);
+        auto buffers = std::make_unique<std::vector<struct statx>>(ring_->capacity());
+        std::vector<size_t> owner(ring_->capacity());
+        std::vector<unsigned> free_slots;
+        for (unsigned s = 0; s < ring_->capacity(); ++s) free_slots.push_back(s);
+
+        size_t next = 0;
+        size_t in_flight = 0;
+        while (next < paths.size() || in_flight > 0) {
+            while (next < paths.size() && !free_slots.empty()) {
+                unsigned slot = free_slots.back();
+                free_slots.pop_back();
+                owner[slot] = next;
+                io_uring_sqe* sqe = ring_->next_sqe(slot);
+                sqe->opcode = IORING_OP_STATX;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = reinterpret_cast<uint64_t>(paths[next].c_str());
+                sqe->len = STATX_BASIC_STATS;
+                sqe->off = reinterpret_cast<uint64_t>(&(*buffers)[slot]);
+                ++next;
+                ++in_flight;
+            }
+            if (!ring_->submit_and_wait()) {
+                // Results still in flight are discarded; the pool stats
+                // everything not completed yet
+                if (!ring_->drain(in_flight, [](uint64_t, int) {})) {
+                    static_cast<void>(buffers.release());   // The kernel may still write it
+                }
+                ring_.reset();
+                std::vector<std::string> rest;
+                std::vector<size_t> rest_index;
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    if (done[i]) continue;
+                    rest.push_back(paths[i]);
+                    rest_index.push_back(i);
+                }
+                std::vector<FileStat> rest_result = threads_.stat_all(rest);
+                for (size_t k = 0; k < rest.size(); ++k) result[rest_index[k]] = rest_result[k];
+                return result;
+            }
+            ring_->reap([&](uint64_t slot, int res) {
+                size_t i = owner[slot];
+                done[i] = true;
+                if (res == 0) {
+                    const struct statx& stx = (*buffers)[slot];
+                    FileStat& st = result[i];
+                    st.exists = true;
+                    st.regular = S_ISREG(stx.stx_mode);
+                    st.size = stx.stx_size;
+                    st.mtime_sec = stx.stx_mtime.tv_sec;
+                    st.mtime_nsec = stx.stx_mtime.tv_nsec;
+                    st.ctime_sec = stx.stx_ctime.tv_sec;
+                    st.ctime_nsec = stx.stx_ctime.tv_nsec;
+                    st.ino = stx.stx_ino;
+                } else if (res == -EINVAL || res == -EOPNOTSUPP) {
+                    result[i] = stat_path(paths[i]);   // Kernel without IORING_OP_STATX
+                }
+                free_slots.push_back(static_cast<unsigned>(slot));
+                --in_flight;
+            });
+        }
+        return result;
+    }
+
+    std::vector<bool> read_all(const std::vector<std::string>& paths,
+                               const std::vector<size_t>& selected,
+                               const ContentSink& sink) override {
+        if (!ring_) return threads_.read_all(paths, selected, sink);
+
+        std::vector<bool> ok(selected.size(), false);
+
+        // One open file per slot, each with a single request in flight
+        struct Slot {
+            size_t k = 0;            // Position in `selected`
+            int fd = -1;
+            uint64_t offset = 0;
+            std::vector<char> buffer;
+        };
+        auto slots_owner = std::make_unique<std::vector<Slot>>(ring_->capacity());
+        std::vector<Slot>& slots = *slots_owner;
+        std::vector<unsigned> free_slots;
+        for (unsigned s = 0; s < slots.size(); ++s) free_slots.push_back(s);
+
+        auto queue_read = [&](unsigned s) {
+            Slot& slot = slots[s];
+            io_uring_sqe* sqe = ring_->next_sqe(s);
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = slot.fd;
+            sqe->addr = reinterpret_cast<uint64_t>(slot.buffer.data());
+            sqe->len = static_cast<uint32_t>(slot.buffer.size());
+            sqe->off = slot.offset;
+        };
+        auto finish = [&](unsigned s, bool success) {
+            Slot& slot = slots[s];
+            if (slot.fd >= 0) ::close(slot.fd);
+            slot.fd = -1;
+            ok[slot.k] = success;
+            free_slots.push_back(s);
+        };
+
+        size_t next = 0;
+        size_t in_flight = 0;
+        while (next < selected.size() || in_flight > 0) {
+            while (next < selected.size() && !free_slots.empty()) {
+                unsigned s = free_slots.back();
+                free_slots.pop_back();
+                Slot& slot = slots[s];
+                slot.k = next;
+                slot.fd = -1;
+                slot.offset = 0;
+                if (slot.buffer.empty()) slot.buffer.resize(READ_CHUNK);
+                io_uring_sqe* sqe = ring_->next_sqe(s);
+                sqe->opcode = IORING_OP_OPENAT;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = reinterpret_cast<uint64_t>(paths[selected[next]].c_str());
+                sqe->open_flags = O_RDONLY | O_CLOEXEC;
+                ++next;
+                ++in_flight;
+            }
+            if (!ring_->submit_and_wait()) {
+                // Files in flight stay failed (a partially fed file cannot
+                // be resumed); the pool reads those not started yet
+                bool drained = ring_->drain(in_flight, [&](uint64_t user_data, int res) {
+                    if (slots[user_data].fd < 0 && res >= 0) ::close(res);  // Late openat
+                });
+                for (auto& slot : slots) {
+                    if (slot.fd >= 0) ::close(slot.fd);
+                    slot.fd = -1;
+                }
+                if (!drained) {
+                    static_cast<void>(slots_owner.release());   // The kernel may still write it
+                }
+                ring_.reset();
+                std::vector<size_t> rest(selected.begin() + static_cast<std::ptrdiff_t>(next),
+                                         selected.end());
+                std::vector<bool> rest_ok = threads_.read_all(paths, rest, sink);
+                for (size_t k = 0; k < rest.size(); ++k) ok[next + k] = rest_ok[k];
+                return ok;
+            }
+            ring_->reap([&](uint64_t user_data, int res) {
+                unsigned s = static_cast<unsigned>(user_data);
+                Slot& slot = slots[s];
+                if (slot.fd < 0) {
+                    // openat completed
+                    if (res < 0) {
+                        finish(s, false);
+                        --in_flight;
+                        return;
+                    }
+                    slot.fd = res;
+                    queue_read(s);
+                    return;
+                }
+                if (res < 0) {
+                    if (res == -EINTR || res == -EAGAIN) {
+                        queue_read(s);
+                        return;
+                    }
+                    finish(s, false);
+                    --in_flight;
+                    return;
+                }
+                if (res == 0) {
+                    finish(s, true);
+                    --in_flight;
+                    return;
+                }
+                sink(selected[slot.k], slot.buffer.data(), static_cast<size_t>(res));
+                slot.offset += static_cast<uint64_t>(res);
+                queue_read(s);
+            });
+        }
+        return ok;
+    }
+
+private:
+    static constexpr unsigned QUEUE_DEPTH = 64;
+    std::unique_ptr<Ring> ring_;      // Null once it failed
+    ThreadBatchReader threads_;
+};
+
+#endif // ARIA_MAKE_HAS_IO_URING
+
+} // namespace
+
+std::optional<IoBackend> parse_io_backend(const std::string& name) {
+    if (name == "auto") return IoBackend::AUTO;
+    if (name == "uring" || name == "io_uring") return IoBackend::URING;
+    if (name == "threads") return IoBackend::THREADS;
+    return std::nullopt;
+}
+
+std::unique_ptr<BatchReader> BatchReader::create(IoBackend backend) {
+#ifdef ARIA_MAKE_HAS_IO_URING
+    if (backend != IoBackend::THREADS) {
+        auto reader = std::make_unique<UringBatchReader>();
+        if (reader->init()) return reader;
+    }
+#else
+    (void)backend;
+#endif
+    return std::make_unique<ThreadBatchReader>();
+}
+
+} // namespace aria::make
@@ -0,0 +1,386 @@
+// git_index.cpp - Git index reader implementation
+// Part of aria_make - Aria Build System
+
+#include "state/git_index.hpp"
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace aria::make {
+
+namespace {
+
+// Index entry flags
+constexpr uint16_t FLAG_ASSUME_VALID = 0x8000;
+constexpr uint16_t FLAG_EXTENDED = 0x4000;
+constexpr uint16_t FLAG_STAGE_MASK = 0x3000;
+constexpr uint16_t EXT_SKIP_WORKTREE = 0x4000;
+constexpr uint16_t EXT_INTENT_TO_ADD = 0x2000;
+
+constexpr size_t OID_BYTES = 20;
+constexpr size_t ENTRY_FIXED_BYTES = 40 + OID_BYTES + 2;   // Stat data, OID, flags
+
+uint32_t be32(const unsigned char* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+uint16_t be16(const unsigned char* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+std::string to_hex(const unsigned char* bytes, size_t n) {
+    static const char* digits = "0123456789abcdef";
+    std::string out(n * 2, '0');
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0xf];
+    }
+    return out;
+}
+
+bool read_all(const fs::path& path, std::string& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    data = oss.str();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// SHA-1 (for blob OIDs of files that no longer match the index)
+// -----------------------------------------------------------------------------
+
+class Sha1 {
+public:
+    void update(const unsigned char* data, size_t len) {
+        total_ += len;
+        while (len > 0) {
+            size_t take = std::min(len, sizeof(block_) - used_);
+            std::memcpy(block_ + used_, data, take);
+            used_ += take;
+            data += take;
+            len -= take;
+            if (used_ == sizeof(block_)) {
+                transform();
+                used_ = 0;
+            }
+        }
+    }
+
+    std::string hex_digest() {
+        uint64_t bits = total_ * 8;
+        unsigned char pad = 0x80;
+        update(&pad, 1);
+        unsigned char zero = 0;
+        while (used_ != 56) update(&zero, 1);
+        unsigned char length[8];
+        for (int i = 0; i < 8; ++i) length[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+        update(length, 8);
+
+        unsigned char out[20];
+        for (int i = 0; i < 5; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                out[4 * i + j] = static_cast<unsigned char>(h_[i] >> (24 - 8 * j));
+            }
+        }
+        return to_hex(out, sizeof(out));
+    }
+
+private:
+    static uint32_t rol(uint32_t v, int n) { return (v << n) | (v >> (32 - n)); }
+
+    void transform() {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) w[i] = be32(block_ + 4 * i);
+        for (int i = 16; i < 80; ++i) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h_[0], b = h_[1], c = h_[2], d = h_[3], e = h_[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            uint32_t t = rol(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rol(b, 30); b = a; a = t;
+        }
+        h_[0] += a; h_[1] += b; h_[2] += c; h_[3] += d; h_[4] += e;
+    }
+
+    uint32_t h_[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    unsigned char block_[64];
+    size_t used_ = 0;
+    uint64_t total_ = 0;
+};
+
+// Resolve the git directory of the worktree containing `dir`
+bool find_git_dir(const fs::path& dir, fs::path& worktree, fs::path& git_dir) {
+    std::error_code ec;
+    for (fs::path p = fs::absolute(dir, ec).lexically_normal(); ; p = p.parent_path()) {
+        fs::path dot_git = p / ".git";
+        if (fs::is_directory(dot_git, ec)) {
+            worktree = p;
+            git_dir = dot_git;
+            return true;
+        }
+        if (fs::is_regular_file(dot_git, ec)) {
+            // Linked worktree or submodule: "gitdir: <path>"
+            std::string content;
+            if (!read_all(dot_git, content) || content.rfind("gitdir: ", 0) != 0) return false;
+            std::string target = content.substr(8);
+            while (!target.empty() && (target.back() == '\n' || target.back() == '\r')) {
+                target.pop_back();
+            }
+            fs::path resolved(target);
+            worktree = p;
+            git_dir = resolved.is_absolute() ? resolved : (p / resolved).lexically_normal();
+            return true;
+        }
+        if (p == p.root_path() || p.parent_path() == p) return false;
+    }
+}
+
+bool uses_sha256(const fs::path& git_dir) {
+    // Linked worktrees keep their config in the common directory
+    fs::path config_dir = git_dir;
+    std::string common;
+    if (read_all(git_dir / "commondir", common)) {
+        while (!common.empty() && (common.back() == '\n' || common.back() == '\r')) common.pop_back();
+        fs::path c(common);
+        config_dir = c.is_absolute() ? c : (git_dir / c).lexically_normal();
+    }
+
+    std::string config;
+    if (!read_all(config_dir / "config", config)) return false;
+    std::istringstream lines(config);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::string compact;
+        for (char c : line) {
+            if (c != ' ' && c != '\t') compact += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        if (compact == "objectformat=sha256") return true;
+    }
+    return false;
+}
+
+} // namespace
+
+// =============================================================================
+// Loading
+// =============================================================================
+
+std::shared_ptr<const GitIndex> GitIndex::load(const fs::path& dir) {
+    fs::path worktree;
+    fs::path git_dir;
+    if (!find_git_dir(dir, worktree, git_dir) || uses_sha256(git_dir)) {
+        return nullptr;
+    }
+
+    fs::path index_path = git_dir / "index";
+    struct stat st {};
+    if (stat(index_path.c_str(), &st) != 0) {
+        return nullptr;
+    }
+
+    std::string data;
+    if (!read_all(index_path, data)) {
+        return nullptr;
+    }
+
+    auto index = std::make_shared<GitIndex>();
+    index->worktree_ = worktree;
+    index->index_mtime_sec_ = st.st_mtim.tv_sec;
+    index->index_mtime_nsec_ = st.st_mtim.tv_nsec;
+    if (!index->parse(data)) {
+        return nullptr;
+    }
+    return index;
+}
+
+bool GitIndex::parse(const std::string& data) {
+    const auto* base = reinterpret_cast<const unsigned char*>(data.data());
+    size_t size = data.size();
+    if (size < 12 || std::memcmp(base, "DIRC", 4) != 0) return false;
+
+    uint32_t version = be32(base + 4);
+    uint32_t count = be32(base + 8);
+    if (version < 2 || version > 4) return false;
+
+    size_t pos = 12;
+    std::string previous;   // v4 paths are prefix-compressed against it
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + ENTRY_FIXED_BYTES > size) return false;
+        const unsigned char* e = base + pos;
+
+        Entry entry;
+        entry.ctime_sec = be32(e);
+        entry.ctime_nsec = be32(e + 4);
+        entry.mtime_sec = be32(e + 8);
+        entry.mtime_nsec = be32(e + 12);
+        entry.ino = be32(e + 20);
+        uint32_t mode = be32(e + 24);
+        entry.size = be32(e + 36);
+        entry.oid = to_hex(e + 40, OID_BYTES);
+        uint16_t flags = be16(e + 40 + OID_BYTES);
+
+        size_t header = ENTRY_FIXED_BYTES;
+        uint16_t extended = 0;
+        if (flags & FLAG_EXTENDED) {
+            if (version < 3 || pos + header + 2 > size) return false;
+            extended = be16(e + header);
+            header += 2;
+        }
+
+        size_t name_start = pos + header;
+        std::string path;
+        if (version == 4) {
+            // Varint: bytes to drop from the previous path, then the suffix
+            size_t p = name_start;
+            if (p >= size) return false;
+            unsigned char c = base[p++];
+            uint64_t strip = c & 0x7f;
+            while (c & 0x80) {
+                if (p >= size) return false;
+                c = base[p++];
+                strip = ((strip + 1) << 7) | (c & 0x7f);
+            }
+            if (strip > previous.size()) return false;
+            const void* nul = std::memchr(base + p, '\0', size - p);
+            if (!nul) return false;
+            size_t end = static_cast<const unsigned char*>(nul) - base;
+            path = previous.substr(0, previous.size() - strip) +
+                   std::string(data, p, end - p);
+            pos = end + 1;
+        } else {
+            const void* nul = std::memchr(base + name_start, '\0', size - name_start);
+            if (!nul) return false;
+            size_t end = static_cast<const unsigned char*>(nul) - base;
+            path.assign(data, name_start, end - name_start);
+            // Entries are NUL-padded to a multiple of 8 bytes
+            size_t entry_len = (header + path.size() + 8) & ~size_t(7);
+            pos += entry_len;
+        }
+        previous = path;
+
+        bool regular = (mode & 0170000) == 0100000;
+        bool trusted = !(flags & (FLAG_ASSUME_VALID | FLAG_STAGE_MASK)) &&
+                       !(extended & (EXT_SKIP_WORKTREE | EXT_INTENT_TO_ADD));
+        if (regular && trusted) {
+            entries_[path] = std::move(entry);
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+std::optional<std::string> GitIndex::relative(const fs::path& path) const {
+    std::error_code ec;
+    fs::path rel = fs::absolute(path, ec).lexically_normal().lexically_relative(worktree_);
+    if (rel.empty() || *rel.begin() == "..") {
+        return std::nullopt;
+    }
+    return rel.generic_string();
+}
+
+bool GitIndex::contains(const fs::path& path) const {
+    return relative(path).has_value();
+}
+
+std::optional<std::string> GitIndex::clean_oid(const fs::path& path) const {
+    struct stat st {};
+    if (lstat(path.c_str(), &st) != 0) return std::nullopt;
+
+    FileStat file;
+    file.exists = true;
+    file.regular = S_ISREG(st.st_mode);
+    file.size = static_cast<uint64_t>(st.st_size);
+    file.mtime_sec = st.st_mtim.tv_sec;
+    file.mtime_nsec = static_cast<uint32_t>(st.st_mtim.tv_nsec);
+    file.ctime_sec = st.st_ctim.tv_sec;
+    file.ctime_nsec = static_cast<uint32_t>(st.st_ctim.tv_nsec);
+    file.ino = static_cast<uint64_t>(st.st_ino);
+    return clean_oid(path, file);
+}
+
+std::optional<std::string> GitIndex::clean_oid(const fs::path& path, const FileStat& st) const {
+    auto rel = relative(path);
+    if (!rel) return std::nullopt;
+
+    auto it = entries_.find(*rel);
+    if (it == entries_.end()) return std::nullopt;
+    const Entry& entry = it->second;
+
+    if (!st.exists || !st.regular) return std::nullopt;
+
+    bool stat_matches =
+        static_cast<uint32_t>(st.mtime_sec) == entry.mtime_sec &&
+        st.mtime_nsec == entry.mtime_nsec &&
+        static_cast<uint32_t>(st.ctime_sec) == entry.ctime_sec &&
+        st.ctime_nsec == entry.ctime_nsec &&
+        static_cast<uint32_t>(st.ino) == entry.ino &&
+        static_cast<uint32_t>(st.size) == entry.size;
+    if (!stat_matches) return std::nullopt;
+
+    // Racily clean: written in the same tick as (or after) the index
+    bool racy = entry.mtime_sec > index_mtime_sec_ ||
+                (entry.mtime_sec == index_mtime_sec_ && entry.mtime_nsec >= index_mtime_nsec_);
+    if (racy) return std::nullopt;
+
+    return entry.oid;
+}
+
+std::string GitIndex::blob_oid(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    if (!file || ec) return "";
+
+    BlobHasher hasher(size);
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        hasher.update(buffer, static_cast<size_t>(file.gcount()));
+    }
+    return hasher.finish();     // Empty if the file changed while reading
+}
+
+// -----------------------------------------------------------------------------
+// BlobHasher
+// -----------------------------------------------------------------------------
+
+struct GitIndex::BlobHasher::State {
+    Sha1 sha;
+    uint64_t expected = 0;
+    uint64_t fed = 0;
+};
+
+GitIndex::BlobHasher::BlobHasher(uint64_t size) : state_(std::make_unique<State>()) {
+    state_->expected = size;
+    std::string header = "blob " + std::to_string(size);
+    state_->sha.update(reinterpret_cast<const unsigned char*>(header.c_str()), header.size() + 1);
+}
+
+GitIndex::BlobHasher::~BlobHasher() = default;
+GitIndex::BlobHasher::BlobHasher(BlobHasher&&) noexcept = default;
+GitIndex::BlobHasher& GitIndex::BlobHasher::operator=(BlobHasher&&) noexcept = default;
+
+void GitIndex::BlobHasher::update(const char* data, size_t len) {
+    state_->fed += len;
+    state_->sha.update(reinterpret_cast<const unsigned char*>(data), len);
+}
+
+std::string GitIndex::BlobHasher::finish() {
+    if (state_->fed != state_->expected) return "";
+    return state_->sha.hex_digest();
+}
+
+} // namespace aria::make
@@ -3,6 +3,7 @@
 
 #include "state/state_manager.hpp"
 
+#include <sys/stat.h>
 #include <fstream>
 #include <sstream>
 #include <chrono>
@@ -10,6 +11,7 @@
 #include <algorithm>
 #include <cstring>
 #include <mutex>
+#include <unordered_set>
 
 // Simple JSON support (minimal implementation to avoid dependencies)
 // For production, consider nlohmann/json
@@ -40,6 +42,12 @@ StateManager::StateManager(StateManager&& other) noexcept
     , records_(std::move(other.records_))
     , hash_cache_(std::move(other.hash_cache_))
     , timestamp_cache_(std::move(other.timestamp_cache_))
+    , git_index_(std::move(other.git_index_))
+    , files_hashed_(other.files_hashed_)
+    , git_index_hits_(other.git_index_hits_)
+    , io_backend_(other.io_backend_)
+    , reader_(std::move(other.reader_))
+    , relocator_(std::move(other.relocator_))
     , stats_(std::move(other.stats_))
     , dirty_targets_(std::move(other.dirty_targets_)) {
 }
@@ -53,6 +61,12 @@ StateManager& StateManager::operator=(StateManager&& other) noexcept {
         records_ = std::move(other.records_);
         hash_cache_ = std::move(other.hash_cache_);
         timestamp_cache_ = std::move(other.timestamp_cache_);
+        git_index_ = std::move(other.git_index_);
+        files_hashed_ = other.files_hashed_;
+        git_index_hits_ = other.git_index_hits_;
+        io_backend_ = other.io_backend_;
+        reader_ = std::move(other.reader_);
+        relocator_ = std::move(other.relocator_);
         stats_ = std::move(other.stats_);
         dirty_targets_ = std::move(other.dirty_targets_);
     }
@@ -126,8 +140,8 @@ DirtyReason StateManager::check_dirty(
 
     std::shared_lock lock(mutex_);
 
-    // Rule 1: Output must exist
-    if (!fs::exists(output_path)) {
+    // Rule 1: Output must exist (in the tree or by digest)
+    if (!fs::exists(output_path) && !records_.count(lazy_record_name(output_path))) {
         return DirtyReason::MISSING_ARTIFACT;
     }
 
@@ -222,7 +236,9 @@ void StateManager::update_record(
     const std::vector<DependencyInfo>& resolved_deps,
     const std::vector<std::string>& implicit_deps,
     const std::vector<std::string>& flags,
-    uint64_t build_duration_ms) {
+    uint64_t build_duration_ms,
+    uint64_t cpu_time_ms,
+    uint64_t peak_rss_kb) {
 
     std::unique_lock lock(mutex_);
 
@@ -230,6 +246,12 @@ void StateManager::update_record(
     record.target_name = target_name;
     record.output_path = output_path;
 
+    // Outputs as last observed; update_output_hash() compares against this
+    auto previous = records_.find(target_name);
+    if (previous != records_.end()) {
+        record.output_hash = previous->second.output_hash;
+    }
+
     // Compute source hash (combined hash of all sources)
     std::string combined;
     for (const auto& source : source_files) {
@@ -248,6 +270,8 @@ void StateManager::update_record(
         now.time_since_epoch()).count();
 
     record.build_duration_ms = build_duration_ms;
+    record.cpu_time_ms = cpu_time_ms;
+    record.peak_rss_kb = peak_rss_kb;
 
     // Update source timestamp
     if (!source_files.empty()) {
@@ -262,6 +286,76 @@ void StateManager::update_record(
     stats_.total_targets = records_.size();
 }
 
+bool StateManager::update_output_hash(
+    const std::string& target_name,
+    const std::vector<std::string>& output_files) {
+
+    // Outputs were just rewritten - never trust cached hashes for them
+    for (const auto& output : output_files) {
+        invalidate_hash_cache(output);
+    }
+    std::string current = hash_files(output_files);
+
+    std::unique_lock lock(mutex_);
+    auto it = records_.find(target_name);
+    if (it == records_.end()) {
+        return true;
+    }
+
+    bool changed = it->second.output_hash != current;
+    it->second.output_hash = current;
+    return changed;
+}
+
+// =============================================================================
+// Lazy Outputs
+// =============================================================================
+
+std::string StateManager::lazy_record_name(const fs::path& path) const {
+    return "lazy:" + relocator_.map(fs::absolute(path).lexically_normal().string());
+}
+
+void StateManager::record_lazy_output(const LazyOutput& output) {
+    ArtifactRecord record;
+    record.target_name = lazy_record_name(output.path);
+    record.output_path = fs::absolute(output.path).lexically_normal();
+    record.source_hash = output.digest;
+    record.output_hash = output.digest;
+    record.command_hash = output.executable ? 1 : 0;
+    record.build_timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::unique_lock lock(mutex_);
+    records_[record.target_name] = std::move(record);
+}
+
+std::optional<LazyOutput> StateManager::lazy_output(const fs::path& path) const {
+    std::shared_lock lock(mutex_);
+    auto it = records_.find(lazy_record_name(path));
+    if (it == records_.end()) {
+        return std::nullopt;
+    }
+    return LazyOutput{it->second.output_path.string(), it->second.output_hash,
+                      it->second.command_hash != 0};
+}
+
+void StateManager::forget_lazy_output(const fs::path& path) {
+    std::unique_lock lock(mutex_);
+    records_.erase(lazy_record_name(path));
+}
+
+std::vector<LazyOutput> StateManager::lazy_outputs() const {
+    std::shared_lock lock(mutex_);
+    std::vector<LazyOutput> outputs;
+    for (const auto& [name, record] : records_) {
+        if (name.rfind("lazy:", 0) == 0) {
+            outputs.push_back({record.output_path.string(), record.output_hash,
+                               record.command_hash != 0});
+        }
+    }
+    return outputs;
+}
+
 void StateManager::invalidate(const std::string& target_name) {
     std::unique_lock lock(mutex_);
     records_.erase(target_name);
@@ -330,18 +424,147 @@ void StateManager::clear_hash_cache() {
     timestamp_cache_.clear();
 }
 
+bool StateManager::use_git_index(const fs::path& dir) {
+    auto index = GitIndex::load(dir);
+    if (!index) {
+        return false;
+    }
+
+    std::unique_lock cache_lock(cache_mutex_);
+    git_index_ = std::move(index);
+    hash_cache_.clear();        // Switches the hash scheme for worktree files
+    timestamp_cache_.clear();
+    return true;
+}
+
+std::shared_ptr<const GitIndex> StateManager::git_index() const {
+    std::shared_lock cache_lock(cache_mutex_);
+    return git_index_;
+}
+
+void StateManager::set_io_backend(IoBackend backend) {
+    std::lock_guard io_lock(io_mutex_);
+    io_backend_ = backend;
+    reader_.reset();
+}
+
+std::string StateManager::io_backend_name() const {
+    std::lock_guard io_lock(io_mutex_);
+    return reader_ ? reader_->name() : "";
+}
+
+size_t StateManager::prefetch_hashes(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    std::unordered_set<std::string> seen;
+    for (const auto& path : paths) {
+        if (!path.empty() && seen.insert(path).second) files.push_back(path);
+    }
+    if (files.empty()) return 0;
+
+    std::lock_guard io_lock(io_mutex_);
+    if (!reader_) reader_ = BatchReader::create(io_backend_);
+
+    std::shared_ptr<const GitIndex> index = git_index();
+    std::vector<FileStat> stats = reader_->stat_all(files);
+
+    // Per file: the hash if known without reading, else a running hasher
+    // of the same scheme get_cached_hash() would use
+    struct Pending {
+        std::string hash;
+        bool from_index = false;
+        uint64_t fnv = FNV_OFFSET_BASIS;
+        std::optional<GitIndex::BlobHasher> blob;
+    };
+    std::vector<Pending> pending(files.size());
+    std::vector<size_t> to_read;
+    {
+        std::shared_lock cache_lock(cache_mutex_);
+        for (size_t i = 0; i < files.size(); ++i) {
+            const FileStat& st = stats[i];
+            if (!st.exists || !st.regular) continue;   // Left to get_cached_hash()
+
+            auto cached = timestamp_cache_.find(files[i]);
+            if (cached != timestamp_cache_.end() &&
+                cached->second == static_cast<uint64_t>(st.mtime_sec) &&
+                hash_cache_.count(files[i]) > 0) {
+                continue;
+            }
+
+            if (index && index->contains(files[i])) {
+                if (auto oid = index->clean_oid(files[i], st)) {
+                    pending[i].hash = "git:" + *oid;
+                    pending[i].from_index = true;
+                    continue;
+                }
+                pending[i].blob.emplace(st.size);
+            }
+            to_read.push_back(i);
+        }
+    }
+
+    std::vector<bool> read_ok = reader_->read_all(files, to_read,
+        [&](size_t i, const char* data, size_t size) {
+            Pending& p = pending[i];
+            if (p.blob) {
+                p.blob->update(data, size);
+                return;
+            }
+            for (size_t b = 0; b < size; ++b) {
+                p.fnv ^= static_cast<uint64_t>(static_cast<unsigned char>(data[b]));
+                p.fnv *= FNV_PRIME;
+            }
+        });
+
+    for (size_t k = 0; k < to_read.size(); ++k) {
+        if (!read_ok[k]) continue;
+        Pending& p = pending[to_read[k]];
+        if (p.blob) {
+            std::string oid = p.blob->finish();
+            if (!oid.empty()) p.hash = "git:" + oid;    // Empty: changed mid-read
+        } else {
+            std::ostringstream oss;
+            oss << "fnv1a:" << std::hex << std::setfill('0') << std::setw(16) << p.fnv;
+            p.hash = oss.str();
+        }
+    }
+
+    // The timestamp is the one taken before reading, so a write racing the
+    // read makes the next check re-hash rather than trust stale content
+    size_t added = 0;
+    std::unique_lock cache_lock(cache_mutex_);
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (pending[i].hash.empty()) continue;
+        hash_cache_[files[i]] = pending[i].hash;
+        timestamp_cache_[files[i]] = static_cast<uint64_t>(stats[i].mtime_sec);
+        if (pending[i].from_index) {
+            git_index_hits_++;
+        } else {
+            files_hashed_++;
+        }
+        ++added;
+    }
+    return added;
+}
+
 // =============================================================================
 // Statistics
 // =============================================================================
 
 BuildStats StateManager::get_stats() const {
     std::shared_lock lock(mutex_);
-    return stats_;
+    BuildStats stats = stats_;
+    std::shared_lock cache_lock(cache_mutex_);
+    stats.files_hashed = files_hashed_;
+    stats.git_index_hits = git_index_hits_;
+    return stats;
 }
 
 void StateManager::reset_stats() {
     std::unique_lock lock(mutex_);
     stats_ = BuildStats{};
+    std::unique_lock cache_lock(cache_mutex_);
+    files_hashed_ = 0;
+    git_index_hits_ = 0;
 }
 
 // =============================================================================
@@ -367,8 +590,27 @@ std::string StateManager::get_cached_hash(const fs::path& path) const {
         }
     }
 
-    // Need to compute hash
-    std::string hash = sha256_file(path);
+    // Need to compute hash: free from the git index if the file is
+    // tracked and unchanged, otherwise by reading it
+    std::shared_ptr<const GitIndex> index;
+    {
+        std::shared_lock cache_lock(cache_mutex_);
+        index = git_index_;
+    }
+
+    std::string hash;
+    bool from_index = false;
+    if (index && index->contains(path)) {
+        if (auto indexed = index->clean_oid(path)) {
+            hash = "git:" + *indexed;
+            from_index = true;
+        } else {
+            std::string oid = GitIndex::blob_oid(path);
+            hash = oid.empty() ? "" : "git:" + oid;
+        }
+    } else {
+        hash = sha256_file(path);
+    }
     uint64_t timestamp = get_file_timestamp(path);
 
     // Update cache
@@ -376,6 +618,11 @@ std::string StateManager::get_cached_hash(const fs::path& path) const {
         std::unique_lock cache_lock(cache_mutex_);
         hash_cache_[path_str] = hash;
         timestamp_cache_[path_str] = timestamp;
+        if (from_index) {
+            git_index_hits_++;
+        } else {
+            files_hashed_++;
+        }
     }
 
     return hash;
@@ -450,24 +697,31 @@ std::string StateManager::sha256_file(const fs::path& path) {
 }
 
 uint64_t StateManager::get_file_timestamp(const fs::path& path) {
-    std::error_code ec;
-    auto ftime = fs::last_write_time(path, ec);
-    if (ec) {
+    // Seconds since the Unix epoch, like build_timestamp and the stat data
+    // prefetch_hashes() caches (fs::file_time_type's epoch is unspecified
+    // and, with libstdc++, lies in the future)
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) {
         return 0;
     }
-
-    // C++17 compatible: Use file_time_type directly
-    // Note: The epoch may differ from system_clock, but we only need
-    // consistent comparisons within the same build session
-    auto duration = ftime.time_since_epoch();
-    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
-    return static_cast<uint64_t>(seconds.count());
+    return static_cast<uint64_t>(st.st_mtim.tv_sec);
 }
 
 // =============================================================================
 // JSON Serialization (Simple implementation)
 // =============================================================================
 
+// Persisted paths are absolute, except under the relocator's root (stored
+// relative to it) and under a mapped prefix (stored with the replacement)
+std::string StateManager::portable_path(const fs::path& path) const {
+    if (path.empty()) return "";
+    return relocator_.map(fs::absolute(path).lexically_normal().string());
+}
+
+fs::path StateManager::local_path(const std::string& path) const {
+    return relocator_.resolve(path);
+}
+
 std::string StateManager::serialize() const {
     std::ostringstream oss;
     oss << "{\n";
@@ -488,12 +742,15 @@ std::string StateManager::serialize() const {
         first_target = false;
 
         oss << "    \"" << name << "\": {\n";
-        oss << "      \"artifact_path\": \"" << record.output_path.string() << "\",\n";
+        oss << "      \"artifact_path\": \"" << portable_path(record.output_path) << "\",\n";
         oss << "      \"source_hash\": \"" << record.source_hash << "\",\n";
         oss << "      \"command_hash\": " << record.command_hash << ",\n";
         oss << "      \"source_timestamp\": " << record.source_timestamp << ",\n";
         oss << "      \"build_timestamp\": " << record.build_timestamp << ",\n";
         oss << "      \"build_duration_ms\": " << record.build_duration_ms << ",\n";
+        oss << "      \"cpu_time_ms\": " << record.cpu_time_ms << ",\n";
+        oss << "      \"peak_rss_kb\": " << record.peak_rss_kb << ",\n";
+        oss << "      \"output_hash\": \"" << record.output_hash << "\",\n";
 
         // Dependencies
         oss << "      \"dependencies\": [";
@@ -501,7 +758,7 @@ std::string StateManager::serialize() const {
         for (const auto& dep : record.direct_dependencies) {
             if (!first_dep) oss << ", ";
             first_dep = false;
-            oss << "{\"path\": \"" << dep.path << "\", \"hash\": \"" << dep.hash << "\"}";
+            oss << "{\"path\": \"" << portable_path(dep.path) << "\", \"hash\": \"" << dep.hash << "\"}";
         }
         oss << "],\n";
 
@@ -511,7 +768,7 @@ std::string StateManager::serialize() const {
         for (const auto& impl : record.implicit_dependencies) {
             if (!first_impl) oss << ", ";
             first_impl = false;
-            oss << "\"" << impl << "\"";
+            oss << "\"" << portable_path(impl) << "\"";
         }
         oss << "]\n";
 
@@ -580,7 +837,7 @@ bool StateManager::deserialize(const std::string& json_str) {
         start = json_str.find('"', start) + 1;
         size_t end = json_str.find('"', start);
         if (start != std::string::npos && end != std::string::npos) {
-            record.output_path = json_str.substr(start, end - start);
+            record.output_path = local_path(json_str.substr(start, end - start));
         }
 
         // Parse source_hash
@@ -633,6 +890,54 @@ bool StateManager::deserialize(const std::string& json_str) {
             }
         }
 
+        // Fields added after 1.0 are looked up only within this record
+        size_t record_end = json_str.find("\"artifact_path\"", pos + 1);
+        if (record_end == std::string::npos) record_end = json_str.size();
+
+        auto read_number = [&](const char* key, uint64_t& value) {
+            size_t key_pos = json_str.find(key, pos);
+            if (key_pos == std::string::npos || key_pos >= record_end) return;
+            size_t num_start = json_str.find(':', key_pos) + 1;
+            while (num_start < json_str.size() && !std::isdigit(json_str[num_start])) num_start++;
+            size_t num_end = num_start;
+            while (num_end < json_str.size() && std::isdigit(json_str[num_end])) num_end++;
+            if (num_start < num_end) {
+                value = std::stoull(json_str.substr(num_start, num_end - num_start));
+            }
+        };
+        read_number("\"build_duration_ms\"", record.build_duration_ms);
+        read_number("\"cpu_time_ms\"", record.cpu_time_ms);
+        read_number("\"peak_rss_kb\"", record.peak_rss_kb);
+
+        size_t oh_pos = json_str.find("\"output_hash\"", pos);
+        if (oh_pos != std::string::npos && oh_pos < record_end) {
+            start = json_str.find(':', oh_pos) + 1;
+            start = json_str.find('"', start) + 1;
+            end = json_str.find('"', start);
+            if (start != std::string::npos && end != std::string::npos) {
+                record.output_hash = json_str.substr(start, end - start);
+            }
+        }
+
+        // Content-hashed dependencies: [{"path": "...", "hash": "..."}, ...]
+        size_t deps_pos = json_str.find("\"dependencies\"", pos);
+        if (deps_pos != std::string::npos && deps_pos < record_end) {
+            size_t deps_end = json_str.find(']', deps_pos);
+            size_t path_pos = deps_pos;
+            while ((path_pos = json_str.find("\"path\"", path_pos)) < deps_end) {
+                auto read_string = [&](size_t key_pos) {
+                    size_t value_start = json_str.find('"', json_str.find(':', key_pos)) + 1;
+                    return json_str.substr(value_start,
+                                           json_str.find('"', value_start) - value_start);
+                };
+                size_t hash_pos = json_str.find("\"hash\"", path_pos);
+                if (hash_pos >= deps_end) break;
+                record.direct_dependencies.emplace_back(
+                    local_path(read_string(path_pos)).string(), read_string(hash_pos));
+                path_pos = hash_pos;
+            }
+        }
+
         if (record.is_valid()) {
             records_[record.target_name] = std::move(record);
         }
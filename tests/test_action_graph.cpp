@@ -0,0 +1,230 @@
+// test_action_graph.cpp - Tests for the action graph and shared object compiles
+// Part of aria_make - Aria Build System
+
+#include "core/action_graph.hpp"
+#include "core/build_orchestrator.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+static BuildConfig make_project(const std::string& name, const std::string& targets) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", "[project]\nname = \"" + name + "\"\n\n" + targets);
+
+    // Stands in for ariac: creates the -o output
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\n"
+               "while [ $# -gt 0 ]; do [ \"$1\" = -o ] && : > \"$2\"; shift; done\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.quiet = true;
+    return config;
+}
+
+static size_t compile_of(const ActionGraph& graph, const std::string& target,
+                         const std::string& source) {
+    for (size_t id : graph.actions_for(target)) {
+        const Action& action = graph.get(id);
+        if (action.kind == ActionKind::COMPILE && action.inputs[0] == source) return id;
+    }
+    throw std::runtime_error("no compile of " + source + " in " + target);
+}
+
+// =============================================================================
+// ActionGraph Tests
+// =============================================================================
+
+static Action compile_action(const std::string& source, const std::string& object) {
+    Action action;
+    action.kind = ActionKind::COMPILE;
+    action.argv = {"cc", "-c", source, "-o", object};
+    action.inputs = {source};
+    action.outputs = {object};
+    return action;
+}
+
+void test_hash_is_stable_and_covers_definition() {
+    Action base = compile_action("/src/a.c", "/obj/a.o");
+    std::string hash = ActionGraph::compute_hash(base);
+    ASSERT_EQ(hash.size(), 16u);
+    ASSERT_EQ(hash, ActionGraph::compute_hash(compile_action("/src/a.c", "/obj/a.o")));
+
+    // Ids, owners, dependencies and resources are not part of the definition
+    Action owned = base;
+    owned.id = 7;
+    owned.targets = {"lib"};
+    owned.deps = {1, 2};
+    owned.resources.pool = "heavy";
+    ASSERT_EQ(ActionGraph::compute_hash(owned), hash);
+
+    auto differs = [&](const std::function<void(Action&)>& change) {
+        Action changed = base;
+        change(changed);
+        return ActionGraph::compute_hash(changed) != hash;
+    };
+    ASSERT(differs([](Action& a) { a.kind = ActionKind::LINK; }));
+    ASSERT(differs([](Action& a) { a.argv.push_back("-O2"); }));
+    ASSERT(differs([](Action& a) { a.env.emplace_back("LANG", "C"); }));
+    ASSERT(differs([](Action& a) { a.working_dir = "/src"; }));
+    ASSERT(differs([](Action& a) { a.inputs.push_back("/src/a.h"); }));
+    ASSERT(differs([](Action& a) { a.outputs.push_back("/obj/a.d"); }));
+    ASSERT(differs([](Action& a) { a.depfile = "/obj/a.d"; }));
+    ASSERT(differs([](Action& a) { a.timeout = std::chrono::seconds(60); }));
+
+    // Moving a string between sections changes the digest
+    Action moved = base;
+    moved.inputs.clear();
+    moved.outputs = {"/src/a.c", "/obj/a.o"};
+    ASSERT(ActionGraph::compute_hash(moved) != hash);
+}
+
+void test_identical_actions_are_merged() {
+    ActionGraph graph;
+    size_t first = graph.add(compile_action("/src/a.c", "/obj/a.o"), "one");
+    size_t again = graph.add(compile_action("/src/a.c", "/obj/a.o"), "two");
+    size_t twice = graph.add(compile_action("/src/a.c", "/obj/a.o"), "two");
+    ASSERT_EQ(first, again);
+    ASSERT_EQ(first, twice);
+    ASSERT_EQ(graph.size(), 1u);
+    ASSERT_EQ(graph.get(first).targets, (std::vector<std::string>{"one", "two"}));
+    ASSERT_EQ(graph.actions_for("two").size(), 1u);
+
+    // Test runs differing only in their timeout stay separate actions
+    Action quick;
+    quick.kind = ActionKind::TEST;
+    quick.argv = {"/bin/test"};
+    quick.timeout = std::chrono::seconds(10);
+    Action slow = quick;
+    slow.timeout = std::chrono::seconds(600);
+    size_t quick_id = graph.add(quick, "quick");
+    size_t slow_id = graph.add(slow, "slow");
+    ASSERT(quick_id != slow_id);
+    ASSERT_EQ(graph.get(slow_id).timeout, std::chrono::milliseconds(600000));
+}
+
+void test_producer_and_dependencies() {
+    ActionGraph graph;
+    size_t a = graph.add(compile_action("/src/a.c", "/obj/a.o"), "lib");
+    size_t b = graph.add(compile_action("/src/b.c", "/obj/b.o"), "lib");
+
+    Action archive;
+    archive.kind = ActionKind::ARCHIVE;
+    archive.argv = {"ar", "rcs", "/out/lib.a", "/obj/a.o", "/obj/b.o"};
+    archive.inputs = {"/obj/a.o", "/obj/b.o"};
+    archive.outputs = {"/out/lib.a"};
+    size_t ar = graph.add(archive, "lib");
+
+    ASSERT_EQ(*graph.producer("/obj/a.o"), a);
+    ASSERT_EQ(*graph.producer("/obj/b.o"), b);
+    ASSERT_EQ(*graph.producer("/out/lib.a"), ar);
+    ASSERT(!graph.producer("/src/a.c"));
+
+    graph.add_dependency(ar, a);
+    graph.add_dependency(ar, b);
+    graph.add_dependency(ar, a);
+    graph.add_dependency(ar, ar);
+    ASSERT_EQ(graph.get(ar).deps, (std::vector<size_t>{a, b}));
+    ASSERT_EQ(graph.actions_for("lib"), (std::vector<size_t>{a, b, ar}));
+    ASSERT(graph.actions_for("other").empty());
+
+    graph.clear();
+    ASSERT(graph.empty());
+    ASSERT(!graph.producer("/out/lib.a"));
+}
+
+// =============================================================================
+// Shared Compile Tests
+// =============================================================================
+
+static const char* SHARED_SOURCES = R"([target.first]
+type = "library"
+sources = ["src/common.aria", "src/first.aria"]
+flags = ["-O2"]
+
+[target.second]
+type = "library"
+sources = ["src/common.aria"]
+flags = ["-O2"]
+
+[target.debug]
+type = "library"
+sources = ["src/common.aria"]
+flags = ["-O0"]
+)";
+
+void test_identical_compiles_are_shared() {
+    BuildConfig config = make_project("shared", SHARED_SOURCES);
+    for (const char* source : {"common", "first"}) {
+        write_text(config.project_root / "src" / (std::string(source) + ".aria"), "// src\n");
+    }
+    std::string common = (config.project_root / "src" / "common.aria").string();
+
+    BuildOrchestrator orchestrator(config);
+    ASSERT(orchestrator.check().errors.empty());
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    ASSERT(errors.empty());
+
+    // Same compiler, flags and source: one action, one object, two owners
+    size_t first = compile_of(graph, "first", common);
+    ASSERT_EQ(first, compile_of(graph, "second", common));
+    ASSERT_EQ(graph.get(first).targets.size(), 2u);
+    ASSERT(graph.get(first).outputs[0].find("/obj/") != std::string::npos);
+
+    // Different flags: a separate object under a different key
+    size_t debug = compile_of(graph, "debug", common);
+    ASSERT(debug != first);
+    ASSERT(graph.get(debug).outputs[0] != graph.get(first).outputs[0]);
+    ASSERT(fs::path(graph.get(debug).outputs[0]).parent_path() !=
+           fs::path(graph.get(first).outputs[0]).parent_path());
+
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.built_targets, 3u);
+    ASSERT_EQ(result.deduplicated_compiles, 1u);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Action Graph Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("action_graph");
+
+    std::cout << "ActionGraph Tests:\n";
+    TEST(hash_is_stable_and_covers_definition);
+    TEST(identical_actions_are_merged);
+    TEST(producer_and_dependencies);
+
+    std::cout << "\nShared Compile Tests:\n";
+    TEST(identical_compiles_are_shared);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
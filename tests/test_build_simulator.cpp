@@ -0,0 +1,204 @@
+// test_build_simulator.cpp - Tests for the offline build schedule simulator
+// Part of aria_make - Aria Build System
+
+#include "core/build_simulator.hpp"
+#include "core/progress_estimator.hpp"
+#include "test_support.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aria::make;
+
+#define ASSERT_NEAR(a, b) \
+    if (std::fabs((a) - (b)) > 1e-6) { \
+        throw std::runtime_error("Assertion failed: " #a " ~= " #b); \
+    }
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static SimTask task(const std::string& name, double wall_ms,
+                    std::vector<size_t> deps = {}) {
+    SimTask t;
+    t.name = name;
+    t.wall_ms = wall_ms;
+    t.deps = std::move(deps);
+    return t;
+}
+
+// gen(10) -> mid(50) -> final(10), plus independent a(40) and b(40)
+static std::vector<SimTask> chain_and_leaves() {
+    return {task("gen", 10), task("mid", 50, {0}), task("final", 10, {1}),
+            task("a", 40), task("b", 40)};
+}
+
+static SimResult simulate(const std::vector<SimTask>& tasks, size_t jobs,
+                          SchedulePolicy policy = SchedulePolicy::FIFO) {
+    SimConfig config;
+    config.jobs = jobs;
+    config.policy = policy;
+    return simulate_build(tasks, config);
+}
+
+// =============================================================================
+// Graph Tests
+// =============================================================================
+
+void test_parse_policy() {
+    ASSERT(parse_schedule_policy("fifo") == SchedulePolicy::FIFO);
+    ASSERT(parse_schedule_policy("critical-path") == SchedulePolicy::CRITICAL_PATH);
+    ASSERT(parse_schedule_policy("longest") == SchedulePolicy::LONGEST_FIRST);
+    ASSERT(!parse_schedule_policy("random"));
+    ASSERT_EQ(std::string(schedule_policy_to_string(SchedulePolicy::CRITICAL_PATH)),
+              "critical-path");
+}
+
+void test_critical_path() {
+    auto tasks = chain_and_leaves();
+    CriticalPath path = critical_path(tasks);
+    ASSERT_NEAR(path.length_ms, 70.0);
+    ASSERT((path.tasks == std::vector<size_t>{0, 1, 2}));
+
+    ASSERT(critical_path({}).tasks.empty());
+}
+
+// =============================================================================
+// Scheduling Tests
+// =============================================================================
+
+void test_bounds() {
+    auto tasks = chain_and_leaves();
+
+    // One slot: everything in series, fully utilized
+    SimResult serial = simulate(tasks, 1);
+    ASSERT_NEAR(serial.makespan_ms, 150.0);
+    ASSERT_NEAR(serial.utilization, 1.0);
+
+    // Plenty of slots: the critical path
+    SimResult wide = simulate(tasks, 16);
+    ASSERT_NEAR(wide.makespan_ms, 70.0);
+    ASSERT_EQ(wide.peak_slots, 3u);
+}
+
+void test_policies() {
+    auto tasks = chain_and_leaves();
+
+    // FIFO hands the slot gen frees to b (ready earlier than mid), so the
+    // long chain waits behind both leaves
+    ASSERT_NEAR(simulate(tasks, 2, SchedulePolicy::FIFO).makespan_ms, 100.0);
+    // Critical-path keeps the chain moving and fills in with the leaves
+    ASSERT_NEAR(simulate(tasks, 2, SchedulePolicy::CRITICAL_PATH).makespan_ms, 80.0);
+}
+
+void test_pool_depth() {
+    std::vector<SimTask> tasks = {task("l1", 30), task("l2", 30), task("l3", 30)};
+    for (auto& t : tasks) t.pool = "link";
+
+    SimConfig config;
+    config.jobs = 8;
+    ASSERT_NEAR(simulate_build(tasks, config).makespan_ms, 30.0);
+
+    config.pool_depths["link"] = 1;
+    ASSERT_NEAR(simulate_build(tasks, config).makespan_ms, 90.0);
+}
+
+void test_parallel_task_width() {
+    // 100ms wall at 4 CPUs: stretched when fewer slots are available
+    SimTask wide = task("wide", 100);
+    wide.cpu_ms = 400;
+    ASSERT_NEAR(simulate({wide}, 8).makespan_ms, 100.0);
+    ASSERT_EQ(simulate({wide}, 8).peak_slots, 4u);
+    ASSERT_NEAR(simulate({wide}, 2).makespan_ms, 200.0);
+
+    // Two of them cannot share 4 slots
+    ASSERT_NEAR(simulate({wide, wide}, 4).makespan_ms, 200.0);
+}
+
+void test_memory_limit() {
+    std::vector<SimTask> tasks = {task("m1", 20), task("m2", 20)};
+    for (auto& t : tasks) t.peak_rss_kb = 600 * 1024;
+
+    SimConfig config;
+    config.jobs = 4;
+    SimResult unlimited = simulate_build(tasks, config);
+    ASSERT_NEAR(unlimited.makespan_ms, 20.0);
+    ASSERT_EQ(unlimited.peak_memory_kb, 1200u * 1024);
+
+    config.memory_limit_kb = 1024 * 1024;
+    SimResult limited = simulate_build(tasks, config);
+    ASSERT_NEAR(limited.makespan_ms, 40.0);
+    ASSERT_EQ(limited.peak_memory_kb, 600u * 1024);
+
+    // A task over the limit on its own still runs
+    config.memory_limit_kb = 100 * 1024;
+    ASSERT_NEAR(simulate_build(tasks, config).makespan_ms, 40.0);
+}
+
+// =============================================================================
+// Progress Estimate Tests
+// =============================================================================
+
+void test_estimate_without_history() {
+    SimConfig config;
+    ProgressEstimator estimator({task("a", 0), task("b", 0)}, {false, false}, config);
+    ASSERT(!estimator.remaining());
+}
+
+void test_estimate_tracks_build() {
+    using std::chrono::milliseconds;
+    auto t0 = ProgressEstimator::Clock::now();
+    SimConfig config;
+    ProgressEstimator estimator({task("a", 100), task("b", 100, {0})}, {true, true}, config);
+
+    ASSERT(estimator.remaining(t0) == milliseconds(200));
+
+    // a is overdue: assumed about to finish, b still ahead
+    estimator.started("a", t0);
+    ASSERT(estimator.remaining(t0 + milliseconds(300)) == milliseconds(100));
+
+    // a took 4x its recorded time, so b is expected to as well
+    estimator.finished("a", t0 + milliseconds(400));
+    ASSERT_NEAR(estimator.speed_factor(), 4.0);
+    ASSERT(estimator.remaining(t0 + milliseconds(700)) == milliseconds(400));
+
+    // Between refreshes the last estimate counts down
+    ASSERT(estimator.remaining(t0 + milliseconds(800)) == milliseconds(300));
+
+    estimator.started("b", t0 + milliseconds(800));
+    estimator.finished("b", t0 + milliseconds(900));
+    ASSERT(estimator.remaining(t0 + milliseconds(2000)) == milliseconds(0));
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Build Simulator Test Suite ===\n\n";
+
+    std::cout << "Graph Tests:\n";
+    TEST(parse_policy);
+    TEST(critical_path);
+
+    std::cout << "\nScheduling Tests:\n";
+    TEST(bounds);
+    TEST(policies);
+    TEST(pool_depth);
+    TEST(parallel_task_width);
+    TEST(memory_limit);
+
+    std::cout << "\nProgress Estimate Tests:\n";
+    TEST(estimate_without_history);
+    TEST(estimate_tracks_build);
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,386 @@
+// test_cache_bundle.cpp - Tests for portable cache bundles
+// Part of aria_make - Aria Build System
+
+#include "cache/cache_bundle.hpp"
+#include "core/build_orchestrator.hpp"
+#include "remote/remote_protocol.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// =============================================================================
+// Bundle Tests
+// =============================================================================
+
+void test_roundtrip() {
+    fs::path src = fixture->test_dir / "src";
+    write_text(src / "build/liba.a", "archive bytes");
+    write_text(src / "build/obj/k1/u.o", "shared object");
+    write_text(src / "build/obj/k2/u.o", "shared object");   // Same content
+    write_text(src / "build/app", "#!/bin/sh\n");
+    fs::permissions(src / "build/app", fs::perms::owner_exec, fs::perm_options::add);
+
+    std::vector<BundleFile> files = {
+        {"build/liba.a", src / "build/liba.a"},
+        {"build/obj/k1/u.o", src / "build/obj/k1/u.o"},
+        {"build/obj/k2/u.o", src / "build/obj/k2/u.o"},
+        {"build/app", src / "build/app"},
+        {"build/missing", src / "build/missing"},             // Skipped
+    };
+
+    std::stringstream bundle;
+    BundleStats out_stats;
+    std::string error;
+    ASSERT(CacheBundle::write(bundle, "{\"version\": \"1.0\"}", files, out_stats, error));
+    ASSERT_EQ(out_stats.files, 4u);
+    ASSERT_EQ(out_stats.blobs, 3u);
+
+    fs::path dest = fixture->test_dir / "dest";
+    ContentStore store(fixture->test_dir / "cas");
+    std::string state;
+    BundleStats in_stats;
+    ASSERT(CacheBundle::read(bundle, store, dest, state, in_stats, error));
+    ASSERT_EQ(state, "{\"version\": \"1.0\"}");
+    ASSERT_EQ(in_stats.files, 4u);
+    ASSERT_EQ(read_text(dest / "build/liba.a"), "archive bytes");
+    ASSERT_EQ(read_text(dest / "build/obj/k2/u.o"), "shared object");
+
+    auto perms = fs::status(dest / "build/app").permissions();
+    ASSERT((perms & fs::perms::owner_exec) != fs::perms::none);
+}
+
+void test_rejects_garbage_and_truncation() {
+    std::string error;
+    std::string state;
+    BundleStats stats;
+    ContentStore store(fixture->test_dir / "cas2");
+
+    std::stringstream garbage("definitely not a bundle");
+    ASSERT(!CacheBundle::read(garbage, store, fixture->test_dir / "g", state, stats, error));
+
+    std::stringstream bundle;
+    ASSERT(CacheBundle::write(bundle, "{}", {}, stats, error));
+    std::string bytes = bundle.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 4));
+    ASSERT(!CacheBundle::read(truncated, store, fixture->test_dir / "t", state, stats, error));
+}
+
+void test_rejects_oversized_frames() {
+    std::stringstream empty;
+    BundleStats stats;
+    std::string error;
+    ASSERT(CacheBundle::write(empty, "{}", {}, stats, error));
+    std::string header = empty.str().substr(0, 16);    // Magic, version, compression
+
+    const uint64_t huge = ~uint64_t(0);
+    const std::pair<uint64_t, uint64_t> sizes[] = {
+        {huge, huge},                   // Would throw length_error
+        {uint64_t(1) << 40, 1024},      // Would throw bad_alloc decompressing
+        {16, huge},                     // Stored larger than raw
+        {1 << 20, 1 << 20},             // Within limits, but the input ends
+    };
+    ContentStore store(fixture->test_dir / "cas_oversized");
+    for (const auto& [raw_size, stored_size] : sizes) {
+        WireWriter frame;
+        frame.u64(raw_size);
+        frame.u64(stored_size);
+        std::stringstream bundle(header + frame.data() + "short payload");
+
+        std::string state;
+        error.clear();
+        ASSERT(!CacheBundle::read(bundle, store, fixture->test_dir / "o", state, stats, error));
+        ASSERT_EQ(error, "truncated bundle");
+    }
+}
+
+void test_refuses_escaping_paths() {
+    fs::path src = fixture->test_dir / "esc";
+    write_text(src / "f", "x");
+
+    std::stringstream bundle;
+    BundleStats stats;
+    std::string error;
+    ASSERT(CacheBundle::write(bundle, "{}", {{"../outside", src / "f"}}, stats, error));
+
+    ContentStore store(fixture->test_dir / "cas3");
+    std::string state;
+    ASSERT(!CacheBundle::read(bundle, store, fixture->test_dir / "inside", state, stats, error));
+    ASSERT(!fs::exists(fixture->test_dir / "outside"));
+}
+
+void test_deferred_files_stay_in_store() {
+    fs::path src = fixture->test_dir / "defer";
+    write_text(src / "build/liba.a", "archive bytes");
+    write_text(src / "build/app", "binary bytes");
+
+    std::stringstream bundle;
+    BundleStats stats;
+    std::string error;
+    ASSERT(CacheBundle::write(bundle, "{}", {{"build/liba.a", src / "build/liba.a"},
+                                             {"build/app", src / "build/app"}},
+                              stats, error));
+
+    fs::path dest = fixture->test_dir / "defer_dest";
+    ContentStore store(fixture->test_dir / "cas4");
+    std::string state;
+    BundleStats in_stats;
+    std::vector<BundleEntry> deferred;
+    ASSERT(CacheBundle::read(bundle, store, dest, state, in_stats, error,
+                             [](const std::string& path) { return path == "build/liba.a"; },
+                             &deferred));
+    ASSERT_EQ(in_stats.files, 1u);
+    ASSERT_EQ(in_stats.deferred, 1u);
+    ASSERT(fs::exists(dest / "build/app"));
+    ASSERT(!fs::exists(dest / "build/liba.a"));
+
+    ASSERT_EQ(deferred.size(), 1u);
+    ASSERT_EQ(deferred[0].path, "build/liba.a");
+    ASSERT(store.contains(deferred[0].digest));
+    ASSERT(store.materialize(deferred[0].digest, dest / "build/liba.a", false));
+    ASSERT_EQ(read_text(dest / "build/liba.a"), "archive bytes");
+}
+
+// =============================================================================
+// Lazy Import Tests
+// =============================================================================
+
+static const char* LAZY_BUILD_FILE = R"([project]
+name = "lazy"
+
+[target.rt]
+type = "c_library"
+sources = ["src/a.c", "src/b.c"]
+compiler = "gcc"
+pch = "include/common.h"
+
+[target.app]
+type = "binary"
+sources = ["src/main.aria"]
+deps = ["rt"]
+)";
+
+static BuildConfig make_lazy_project(const fs::path& root) {
+    write_text(root / "build.abc", LAZY_BUILD_FILE);
+    write_text(root / "include" / "common.h", "#define BASE 1\n");
+    write_text(root / "src" / "a.c", "int a(void) { return BASE; }\n");
+    write_text(root / "src" / "b.c", "int b(void) { return BASE + 1; }\n");
+    write_text(root / "src" / "main.aria", "// main\n");
+
+    // Stands in for ariac: creates the -o output
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\n"
+               "while [ $# -gt 0 ]; do [ \"$1\" = -o ] && echo app > \"$2\"; shift; done\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.use_git_index = false;
+    config.quiet = true;
+    return config;
+}
+
+static size_t count_files(const fs::path& dir, const std::string& extension) {
+    size_t n = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.path().extension() == extension) ++n;
+    }
+    return n;
+}
+
+// Build and export, then import with lazy outputs into a fresh checkout
+// (or, with `in_place`, into the same one after a clean)
+static BuildConfig lazy_checkout(const std::string& name, std::vector<std::string> targets = {},
+                                 bool in_place = false) {
+    BuildConfig origin = make_lazy_project(fixture->test_dir / (name + "_origin"));
+    if (!BuildOrchestrator(origin).build().success) {
+        throw std::runtime_error("origin build failed");
+    }
+    std::stringstream bundle;
+    BundleStats stats;
+    std::string error;
+    BuildOrchestrator exporter(origin);
+    exporter.check();
+    if (!exporter.export_cache(bundle, stats, error)) throw std::runtime_error(error);
+
+    BuildConfig config = origin;
+    if (in_place) {
+        BuildOrchestrator(origin).clean();
+    } else {
+        config = make_lazy_project(fixture->test_dir / name);
+    }
+    config.lazy_outputs = true;
+    config.targets = std::move(targets);
+    BuildOrchestrator importer(config);
+    importer.check();
+    if (!importer.import_cache(bundle, stats, error)) throw std::runtime_error(error);
+    config.lazy_outputs = false;
+    return config;
+}
+
+void test_lazy_import_places_final_outputs_only() {
+    BuildConfig config = lazy_checkout("lazy_final");
+    ASSERT(fs::exists(config.output_dir / "app"));
+    ASSERT(!fs::exists(config.output_dir / "librt.a"));
+    ASSERT_EQ(count_files(config.output_dir, ".o"), 0u);
+    ASSERT_EQ(count_files(config.output_dir, ".gch"), 0u);
+
+    // Digests stand in for the missing files: nothing is dirty
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.built_targets, 0u);
+    ASSERT_EQ(result.fetched_outputs, 0u);
+    ASSERT(!fs::exists(config.output_dir / "librt.a"));
+
+    // Relinking the binary needs the archive, not the objects
+    write_text(config.project_root / "src" / "main.aria", "// edited\n");
+    BuildResult relink = BuildOrchestrator(config).build();
+    ASSERT(relink.success);
+    ASSERT_EQ(relink.built_targets, 1u);
+    ASSERT_EQ(relink.fetched_outputs, 1u);
+    ASSERT(fs::exists(config.output_dir / "librt.a"));
+    ASSERT_EQ(count_files(config.output_dir, ".o"), 0u);
+}
+
+void test_lazy_inputs_fetched_when_action_runs() {
+    BuildConfig config = lazy_checkout("lazy_inputs", {}, true);
+    ASSERT_EQ(count_files(config.output_dir, ".gch"), 0u);
+
+    // The PCH is up to date (so not rebuilt) but the recompiles include it
+    write_text(config.project_root / "src" / "a.c", "int a(void) { return BASE * 2; }\n");
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.built_targets, 2u);
+    ASSERT_EQ(result.fetched_outputs, 1u);
+    ASSERT_EQ(count_files(config.output_dir, ".gch"), 1u);
+    ASSERT(fs::exists(config.output_dir / "librt.a"));
+
+    BuildResult clean = BuildOrchestrator(config).build();
+    ASSERT(clean.success);
+    ASSERT_EQ(clean.built_targets, 0u);
+}
+
+void test_lazy_input_fetched_once_by_parallel_actions() {
+    BuildConfig config = lazy_checkout("lazy_parallel", {}, true);
+    config.num_threads = 4;
+
+    // Both recompiles need the PCH; one fetches it, the other waits
+    write_text(config.project_root / "src" / "a.c", "int a(void) { return BASE * 2; }\n");
+    write_text(config.project_root / "src" / "b.c", "int b(void) { return BASE * 3; }\n");
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.fetched_outputs, 1u);
+    ASSERT_EQ(count_files(config.output_dir, ".gch"), 1u);
+    ASSERT(fs::exists(config.output_dir / "librt.a"));
+}
+
+void test_lazy_requested_target_fetched() {
+    BuildConfig config = lazy_checkout("lazy_requested", {"rt"});
+    ASSERT(fs::exists(config.output_dir / "librt.a"));
+    ASSERT_EQ(count_files(config.output_dir, ".o"), 0u);
+
+    // The same happens when a build asks for it
+    BuildConfig later = lazy_checkout("lazy_requested_later");
+    later.targets = {"rt"};
+    BuildResult result = BuildOrchestrator(later).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.fetched_outputs, 1u);
+    ASSERT(fs::exists(later.output_dir / "librt.a"));
+}
+
+// =============================================================================
+// Import Tests
+// =============================================================================
+
+// The precompiled header pulls in include/abi.h, which only its depfile
+// lists. Both checkouts use one compiler, so the toolchain matches.
+static BuildConfig make_abi_project(const fs::path& root, int version) {
+    BuildConfig config = make_lazy_project(root);
+    fs::path compiler = fixture->test_dir / "abi_ariac";
+    if (!fs::exists(compiler)) fs::copy_file(root / "fake_ariac", compiler);
+    config.compiler = compiler.string();
+    write_text(root / "include" / "common.h", "#include \"abi.h\"\n#define BASE ABI_VERSION\n");
+    write_text(root / "include" / "abi.h", "#define ABI_VERSION " + std::to_string(version) + "\n");
+    return config;
+}
+
+void test_import_rebuilds_changed_header() {
+    BuildConfig origin = make_abi_project(fixture->test_dir / "abi_origin", 1);
+    ASSERT(BuildOrchestrator(origin).build().success);
+    std::stringstream bundle;
+    BundleStats stats;
+    std::string error;
+    BuildOrchestrator exporter(origin);
+    exporter.check();
+    ASSERT(exporter.export_cache(bundle, stats, error));
+
+    // Another checkout of the same project, with a newer header
+    BuildConfig config = make_abi_project(fixture->test_dir / "abi_checkout", 2);
+    BuildOrchestrator importer(config);
+    importer.check();
+    ASSERT(importer.import_cache(bundle, stats, error));
+    ASSERT_EQ(read_text(config.output_dir / "librt.a"), read_text(origin.output_dir / "librt.a"));
+
+    // Records are checked against this checkout's abi.h, not the origin's
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT(result.built_targets >= 1u);
+    ASSERT(read_text(config.output_dir / "librt.a") != read_text(origin.output_dir / "librt.a"));
+
+    BuildResult again = BuildOrchestrator(config).build();
+    ASSERT(again.success);
+    ASSERT_EQ(again.built_targets, 0u);
+
+    // The origin itself is still up to date
+    BuildResult unchanged = BuildOrchestrator(origin).build();
+    ASSERT_EQ(unchanged.built_targets, 0u);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Cache Bundle Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("bundle");
+
+    std::cout << "Bundle Tests:\n";
+    TEST(roundtrip);
+    TEST(rejects_garbage_and_truncation);
+    TEST(rejects_oversized_frames);
+    TEST(refuses_escaping_paths);
+    TEST(deferred_files_stay_in_store);
+
+    std::cout << "\nLazy Import Tests:\n";
+    TEST(lazy_import_places_final_outputs_only);
+    TEST(lazy_inputs_fetched_when_action_runs);
+    TEST(lazy_input_fetched_once_by_parallel_actions);
+    TEST(lazy_requested_target_fetched);
+
+    std::cout << "\nImport Tests:\n";
+    TEST(import_rebuilds_changed_header);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
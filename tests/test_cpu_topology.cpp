@@ -0,0 +1,150 @@
+// test_cpu_topology.cpp - Tests for usable-CPU detection and job placement
+// Part of aria_make - Aria Build System
+
+#include "core/cpu_topology.hpp"
+#include "core/process_runner.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// A sysfs cpu tree: `l3` lists each CPU's shared_cpu_list
+static fs::path make_sysfs(const std::string& name, const std::vector<std::string>& l3) {
+    fs::path root = fixture->test_dir / name;
+    for (size_t cpu = 0; cpu < l3.size(); ++cpu) {
+        fs::path cache = root / ("cpu" + std::to_string(cpu)) / "cache";
+        write_text(cache / "index0" / "level", "1\n");
+        write_text(cache / "index0" / "type", "Data\n");
+        write_text(cache / "index0" / "shared_cpu_list", std::to_string(cpu) + "\n");
+        write_text(cache / "index1" / "level", "3\n");
+        write_text(cache / "index1" / "type", "Unified\n");
+        write_text(cache / "index1" / "shared_cpu_list", l3[cpu] + "\n");
+    }
+    return root;
+}
+
+// =============================================================================
+// Usable CPU Tests
+// =============================================================================
+
+void test_parse_cpu_list() {
+    ASSERT((parse_cpu_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    ASSERT((parse_cpu_list("5") == std::vector<int>{5}));
+    ASSERT((parse_cpu_list("3-1,x,2") == std::vector<int>{2}));
+    ASSERT(parse_cpu_list("").empty());
+}
+
+void test_cgroup_quota() {
+    fs::path root = fixture->test_dir / "cgroup";
+    fs::path proc = fixture->test_dir / "proc_cgroup";
+    write_text(proc, "0::/kubepods/pod1/ctr\n");
+
+    // No cpu.max anywhere: no limit
+    fs::create_directories(root / "kubepods" / "pod1" / "ctr");
+    ASSERT(!cgroup_cpu_limit(root, proc));
+
+    // Unlimited leaf under a limited pod: the pod's quota applies
+    write_text(root / "kubepods" / "pod1" / "ctr" / "cpu.max", "max 100000\n");
+    write_text(root / "kubepods" / "pod1" / "cpu.max", "800000 100000\n");
+    auto limit = cgroup_cpu_limit(root, proc);
+    ASSERT(limit && *limit == 8.0);
+
+    // A tighter leaf wins
+    write_text(root / "kubepods" / "pod1" / "ctr" / "cpu.max", "150000 100000\n");
+    limit = cgroup_cpu_limit(root, proc);
+    ASSERT(limit && *limit == 1.5);
+
+    // cgroup v1 only (no "0::" line): no limit
+    write_text(proc, "4:cpu,cpuacct:/kubepods\n");
+    ASSERT(!cgroup_cpu_limit(root, proc));
+}
+
+void test_default_job_count() {
+    size_t jobs = default_job_count();
+    ASSERT(jobs >= 1);
+    size_t affinity = affinity_cpus().size();
+    if (affinity > 0) ASSERT(jobs <= affinity);
+}
+
+// =============================================================================
+// Placement Tests
+// =============================================================================
+
+void test_placement_groups() {
+    // Two L3 domains of four CPUs each
+    fs::path sysfs = make_sysfs("sysfs_two_l3",
+                                {"0-3", "0-3", "0-3", "0-3", "4-7", "4-7", "4-7", "4-7"});
+
+    ASSERT(cpu_placement_groups(CpuPinning::NONE, {0, 1, 2}, sysfs).empty());
+
+    auto cores = cpu_placement_groups(CpuPinning::CORE, {1, 5}, sysfs);
+    ASSERT((cores == std::vector<std::vector<int>>{{1}, {5}}));
+
+    auto caches = cpu_placement_groups(CpuPinning::CACHE, {0, 1, 2, 3, 4, 5, 6, 7}, sysfs);
+    ASSERT((caches == std::vector<std::vector<int>>{{0, 1, 2, 3}, {4, 5, 6, 7}}));
+
+    // Only usable CPUs end up in a group
+    caches = cpu_placement_groups(CpuPinning::CACHE, {2, 3, 6}, sysfs);
+    ASSERT((caches == std::vector<std::vector<int>>{{2, 3}, {6}}));
+
+    // Unknown topology: one group per CPU
+    caches = cpu_placement_groups(CpuPinning::CACHE, {0, 1},
+                                  fixture->test_dir / "no_such_sysfs");
+    ASSERT((caches == std::vector<std::vector<int>>{{0}, {1}}));
+
+    ASSERT(parse_cpu_pinning("cache") == CpuPinning::CACHE);
+    ASSERT(!parse_cpu_pinning("socket"));
+}
+
+void test_pinned_process() {
+    auto cpus = affinity_cpus();
+    if (cpus.empty()) return;  // No affinity support
+
+    ProcessSpec spec;
+    spec.argv = {"sh", "-c", "grep Cpus_allowed_list /proc/self/status"};
+    spec.cpu_affinity = {cpus.back()};
+    auto result = run_process(spec);
+    ASSERT(result.success());
+    size_t colon = result.stdout_output.find(':');
+    ASSERT(colon != std::string::npos);
+    ASSERT((parse_cpu_list(result.stdout_output.substr(colon + 1)) ==
+            std::vector<int>{cpus.back()}));
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== CPU Topology Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("cpu");
+
+    std::cout << "Usable CPU Tests:\n";
+    TEST(parse_cpu_list);
+    TEST(cgroup_quota);
+    TEST(default_job_count);
+
+    std::cout << "\nPlacement Tests:\n";
+    TEST(placement_groups);
+    TEST(pinned_process);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
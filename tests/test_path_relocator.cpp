@@ -0,0 +1,261 @@
+// test_path_relocator.cpp - Tests for checkout-independent cache key paths
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "core/path_relocator.hpp"
+#include "state/state_manager.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// =============================================================================
+// Mapping Tests
+// =============================================================================
+
+void test_paths_under_root_become_relative() {
+    PathRelocator relocator("/work/checkout/", {});
+    ASSERT_EQ(relocator.map("/work/checkout/src/a.c"), "src/a.c");
+    ASSERT_EQ(relocator.map("/work/checkout"), ".");
+    ASSERT_EQ(relocator.map("-I/work/checkout/include"), "-Iinclude");
+    ASSERT_EQ(relocator.map("cat /work/checkout/a /work/checkout/b"), "cat a b");
+
+    // A sibling sharing the root as a string prefix is not under the root
+    ASSERT_EQ(relocator.map("/work/checkout2/src/a.c"), "/work/checkout2/src/a.c");
+    ASSERT_EQ(relocator.map("/usr/include/stdio.h"), "/usr/include/stdio.h");
+
+    ASSERT_EQ(relocator.map(std::vector<std::string>{"/work/checkout/x", "-O2"}),
+              (std::vector<std::string>{"x", "-O2"}));
+
+    // Relative paths resolve against the root
+    ASSERT_EQ(relocator.resolve("src/a.c"), "/work/checkout/src/a.c");
+    ASSERT_EQ(relocator.resolve("."), "/work/checkout");
+    ASSERT_EQ(relocator.resolve("/usr/include/stdio.h"), "/usr/include/stdio.h");
+
+    // Without a root or mappings, text passes through
+    PathRelocator identity;
+    ASSERT_EQ(identity.map("/work/checkout/src/a.c"), "/work/checkout/src/a.c");
+    ASSERT_EQ(identity.resolve("src/a.c"), "src/a.c");
+}
+
+void test_longest_prefix_wins() {
+    PathRelocator relocator("/work/checkout", {
+        {"/opt", "/OPT"},
+        {"/opt/sdk-1.2", "/SDK"},
+        {"/work", "/WORK"},
+    });
+    ASSERT_EQ(relocator.map("/opt/sdk-1.2/include"), "/SDK/include");
+    ASSERT_EQ(relocator.map("/opt/other/include"), "/OPT/other/include");
+
+    // The project root is longer than "/work", so it is applied first
+    ASSERT_EQ(relocator.map("/work/checkout/src/a.c"), "src/a.c");
+    ASSERT_EQ(relocator.map("/work/elsewhere/a.c"), "/WORK/elsewhere/a.c");
+    ASSERT_EQ(relocator.map("-isystem/opt/sdk-1.2/include"), "-isystem/SDK/include");
+
+    ASSERT_EQ(relocator.resolve("/SDK/include"), "/opt/sdk-1.2/include");
+    ASSERT_EQ(relocator.resolve("/OPT/other/include"), "/opt/other/include");
+    ASSERT_EQ(relocator.resolve("/WORK/elsewhere/a.c"), "/work/elsewhere/a.c");
+}
+
+void test_parse_mapping() {
+    auto plain = PathRelocator::parse_mapping("/opt/sdk=/SDK");
+    ASSERT(plain);
+    ASSERT_EQ(plain->first, "/opt/sdk");
+    ASSERT_EQ(plain->second, "/SDK");
+
+    // The first '=' splits; NEW may be empty or contain '='
+    auto empty = PathRelocator::parse_mapping("/opt/sdk=");
+    ASSERT(empty);
+    ASSERT_EQ(empty->second, "");
+    auto nested = PathRelocator::parse_mapping("/a=/b=c");
+    ASSERT(nested);
+    ASSERT_EQ(nested->first, "/a");
+    ASSERT_EQ(nested->second, "/b=c");
+
+    ASSERT(!PathRelocator::parse_mapping("/opt/sdk"));
+    ASSERT(!PathRelocator::parse_mapping("=/SDK"));
+    ASSERT(!PathRelocator::parse_mapping(""));
+}
+
+// =============================================================================
+// Relocated Checkout Tests
+// =============================================================================
+
+static const char* BUILD_FILE = R"([project]
+name = "relocated"
+
+[target.gen]
+type = "command"
+inputs = ["proto/messages.txt"]
+outputs = ["gen/messages.aria"]
+argv = ["/bin/sh", "-c", "cp $0 $1", "$in", "$out"]
+
+[target.core]
+type = "library"
+sources = ["src/core.aria"]
+flags = ["-O2"]
+
+[target.rt]
+type = "c_library"
+sources = ["src/rt.c"]
+compiler = "gcc"
+pch = "include/common.h"
+
+[target.app]
+type = "binary"
+sources = ["gen/messages.aria", "src/main.aria"]
+deps = ["core", "rt"]
+)";
+
+static BuildConfig make_checkout(const std::string& name) {
+    fs::path root = fixture->test_dir / name / "project";
+    write_text(root / "build.abc", BUILD_FILE);
+    write_text(root / "proto" / "messages.txt", "// messages\n");
+    write_text(root / "src" / "core.aria", "// core\n");
+    write_text(root / "src" / "main.aria", "// main\n");
+    write_text(root / "include" / "common.h", "#include \"abi.h\"\n");
+    write_text(root / "include" / "abi.h", "#define ABI_VERSION 1\n");
+    write_text(root / "src" / "rt.c", "int rt(void) { return ABI_VERSION; }\n");
+
+    // Stands in for ariac: creates the -o output
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\n"
+               "while [ $# -gt 0 ]; do [ \"$1\" = -o ] && : > \"$2\"; shift; done\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.use_git_index = false;
+    config.quiet = true;
+    return config;
+}
+
+void test_checkouts_share_action_and_state_keys() {
+    BuildConfig first = make_checkout("first");
+    BuildConfig second = make_checkout("second_checkout");
+
+    BuildOrchestrator a(first);
+    BuildOrchestrator b(second);
+    ASSERT(a.check().errors.empty());
+    ASSERT(b.check().errors.empty());
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph_a = a.action_graph(errors);
+    const ActionGraph& graph_b = b.action_graph(errors);
+    ASSERT(errors.empty());
+    ASSERT_EQ(graph_a.size(), graph_b.size());
+    ASSERT(graph_a.size() >= 4u);
+    for (size_t id = 0; id < graph_a.size(); ++id) {
+        ASSERT_EQ(graph_a.get(id).hash, graph_b.get(id).hash);
+        // The commands themselves keep their absolute paths
+        ASSERT(graph_a.get(id).argv != graph_b.get(id).argv);
+    }
+
+    // Tracked flags end up in each target's command hash
+    ASSERT(BuildOrchestrator(first).build().success);
+    ASSERT(BuildOrchestrator(second).build().success);
+    StateManager state_a(first.state_dir);
+    StateManager state_b(second.state_dir);
+    ASSERT(state_a.load());
+    ASSERT(state_b.load());
+    for (const char* target : {"gen", "core", "rt", "app"}) {
+        auto record_a = state_a.get_record(target);
+        auto record_b = state_b.get_record(target);
+        ASSERT(record_a && record_b);
+        ASSERT_EQ(record_a->command_hash, record_b->command_hash);
+        ASSERT_EQ(record_a->source_hash, record_b->source_hash);
+        ASSERT_EQ(record_a->output_path, record_b->output_path);
+        ASSERT_EQ(record_a->direct_dependencies.size(), record_b->direct_dependencies.size());
+    }
+
+    // The precompiled header's record: same name, same depfile closure
+    const Action* pch = nullptr;
+    for (size_t id : graph_b.actions_for("rt")) {
+        if (!graph_b.get(id).depfile.empty()) pch = &graph_b.get(id);
+    }
+    ASSERT(pch);
+    std::string name = "action:" + PathRelocator(second.project_root, {}).map(pch->outputs[0]);
+    ASSERT_EQ(name.rfind("action:.aria_make/", 0), 0u);
+    auto pch_a = state_a.get_record(name);
+    auto pch_b = state_b.get_record(name);
+    ASSERT(pch_a && pch_b);
+    ASSERT_EQ(pch_a->output_path, pch_b->output_path);
+    ASSERT(!pch_a->direct_dependencies.empty());
+    ASSERT_EQ(pch_a->direct_dependencies.size(), pch_b->direct_dependencies.size());
+    bool saw_abi = false;
+    for (size_t i = 0; i < pch_a->direct_dependencies.size(); ++i) {
+        const auto& dep_a = pch_a->direct_dependencies[i];
+        const auto& dep_b = pch_b->direct_dependencies[i];
+        ASSERT_EQ(dep_a.path, dep_b.path);
+        ASSERT_EQ(dep_a.hash, dep_b.hash);
+        ASSERT(dep_a.path.find(fixture->test_dir.string()) == std::string::npos);
+        if (dep_a.path == "include/abi.h") saw_abi = true;
+    }
+    ASSERT(saw_abi);
+
+    // Read with a checkout's relocator, the records describe its files
+    StateManager local(first.state_dir);
+    local.set_relocator(PathRelocator(second.project_root, {}));
+    ASSERT(local.load());
+    auto resolved = local.get_record(name);
+    ASSERT(resolved);
+    ASSERT_EQ(resolved->output_path, fs::path(pch->outputs[0]).lexically_normal());
+    bool resolved_abi = false;
+    for (const auto& dep : resolved->direct_dependencies) {
+        if (dep.path == (second.project_root / "include" / "abi.h").lexically_normal().string()) {
+            resolved_abi = true;
+        }
+    }
+    ASSERT(resolved_abi);
+
+    // Prefix mappings feed the same keys: mapping the shell's directory
+    // changes the command target's action
+    BuildConfig mapped = second;
+    mapped.path_prefix_map = {{"/bin", "/usr/bin"}};
+    BuildOrchestrator c(mapped);
+    ASSERT(c.check().errors.empty());
+    const ActionGraph& graph_c = c.action_graph(errors);
+    ASSERT(errors.empty());
+    size_t gen = graph_c.actions_for("gen").at(0);
+    ASSERT(graph_c.get(gen).hash != graph_b.get(graph_b.actions_for("gen").at(0)).hash);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Path Relocator Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("path_relocator");
+
+    std::cout << "Mapping Tests:\n";
+    TEST(paths_under_root_become_relative);
+    TEST(longest_prefix_wins);
+    TEST(parse_mapping);
+
+    std::cout << "\nRelocated Checkout Tests:\n";
+    TEST(checkouts_share_action_and_state_keys);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+// test_pch.cpp - Tests for precompiled headers of c_library targets
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+static const char* BUILD_FILE = R"([project]
+name = "pch"
+
+[target.rt]
+type = "c_library"
+sources = ["src/a.c", "src/b.c"]
+compiler = "gcc"
+pch = "include/common.h"
+flags = ["-O2"]
+
+[target.ffi]
+type = "c_library"
+sources = ["src/c.c"]
+compiler = "gcc"
+pch = "include/common.h"
+flags = ["-O2"]
+
+[target.debug_rt]
+type = "c_library"
+sources = ["src/a.c"]
+compiler = "gcc"
+pch = "include/common.h"
+flags = ["-O0"]
+)";
+
+static BuildConfig make_project(const std::string& name) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", BUILD_FILE);
+    write_text(root / "include" / "common.h", "#pragma once\n#include \"abi.h\"\n");
+    write_text(root / "include" / "abi.h", "#define ABI_VERSION 1\n");
+    write_text(root / "src" / "a.c", "int a(void) { return ABI_VERSION; }\n");
+    write_text(root / "src" / "b.c", "int b(void) { return ABI_VERSION + 1; }\n");
+    write_text(root / "src" / "c.c", "int c(void) { return ABI_VERSION + 2; }\n");
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.quiet = true;
+    return config;
+}
+
+// The precompiled-header action of `target` (the one with a depfile)
+static const Action* find_pch(const ActionGraph& graph, const std::string& target) {
+    for (size_t id : graph.actions_for(target)) {
+        if (!graph.get(id).depfile.empty()) return &graph.get(id);
+    }
+    return nullptr;
+}
+
+static bool has_arg(const Action& action, const std::string& arg) {
+    return std::find(action.argv.begin(), action.argv.end(), arg) != action.argv.end();
+}
+
+// =============================================================================
+// PCH Tests
+// =============================================================================
+
+void test_pch_lowering() {
+    BuildConfig config = make_project("lowering");
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    ASSERT(errors.empty());
+
+    const Action* pch = find_pch(graph, "rt");
+    ASSERT(pch);
+    ASSERT(has_arg(*pch, "c-header"));
+    ASSERT(has_arg(*pch, "-O2"));
+    ASSERT_EQ(fs::path(pch->outputs[0]).filename(), "common.h.gch");
+    ASSERT(std::find(pch->outputs.begin(), pch->outputs.end(), pch->depfile) !=
+           pch->outputs.end());
+
+    // Every object includes the PCH and waits for it
+    std::string header = pch->outputs[0].substr(0, pch->outputs[0].size() - 4);
+    size_t objects = 0;
+    for (size_t id : graph.actions_for("rt")) {
+        const Action& action = graph.get(id);
+        if (action.kind != ActionKind::COMPILE || &action == pch) continue;
+        ++objects;
+        ASSERT(has_arg(action, "-include"));
+        ASSERT(has_arg(action, header));
+        ASSERT(std::find(action.deps.begin(), action.deps.end(), pch->id) != action.deps.end());
+    }
+    ASSERT_EQ(objects, 2u);
+}
+
+void test_pch_shared_per_flag_set() {
+    BuildConfig config = make_project("shared");
+    BuildOrchestrator orchestrator(config);
+    orchestrator.check();
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    ASSERT(errors.empty());
+
+    // Same header and flags: one action; other flags: a PCH of their own
+    const Action* rt = find_pch(graph, "rt");
+    const Action* ffi = find_pch(graph, "ffi");
+    const Action* debug = find_pch(graph, "debug_rt");
+    ASSERT(rt && ffi && debug);
+    ASSERT_EQ(rt->id, ffi->id);
+    ASSERT(debug->id != rt->id);
+    ASSERT(debug->outputs[0] != rt->outputs[0]);
+}
+
+void test_pch_only_for_c_library() {
+    BuildConfig config = make_project("invalid");
+    write_text(config.project_root / "build.abc",
+               "[target.app]\ntype = \"binary\"\nsources = [\"src/a.c\"]\n"
+               "pch = \"include/common.h\"\n");
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("pch") != std::string::npos);
+}
+
+void test_pch_rebuilt_on_closure_change() {
+    BuildConfig config = make_project("closure");
+    write_text(config.project_root / "build.abc",
+               "[target.rt]\ntype = \"c_library\"\nsources = [\"src/a.c\", \"src/b.c\"]\n"
+               "compiler = \"gcc\"\npch = \"include/common.h\"\n");
+
+    BuildResult first = BuildOrchestrator(config).build();
+    ASSERT(first.success);
+    ASSERT_EQ(first.built_targets, 1u);
+
+    fs::path gch;
+    for (const auto& entry : fs::recursive_directory_iterator(config.output_dir)) {
+        if (entry.path().extension() == ".gch") gch = entry.path();
+    }
+    ASSERT(!gch.empty());
+    auto built_at = fs::last_write_time(gch);
+
+    // A source edit rebuilds the target but reuses the PCH
+    write_text(config.project_root / "src" / "a.c", "int a(void) { return ABI_VERSION * 3; }\n");
+    BuildResult edited = BuildOrchestrator(config).build();
+    ASSERT(edited.success);
+    ASSERT_EQ(edited.built_targets, 1u);
+    ASSERT(fs::last_write_time(gch) == built_at);
+
+    // A header the PCH includes changes: target and PCH are rebuilt
+    write_text(config.project_root / "include" / "abi.h", "#define ABI_VERSION 2\n");
+    BuildResult header = BuildOrchestrator(config).build();
+    ASSERT(header.success);
+    ASSERT_EQ(header.built_targets, 1u);
+    ASSERT(fs::last_write_time(gch) != built_at);
+
+    BuildResult clean = BuildOrchestrator(config).build();
+    ASSERT(clean.success);
+    ASSERT_EQ(clean.built_targets, 0u);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== PCH Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("pch");
+
+    std::cout << "PCH Tests:\n";
+    TEST(pch_lowering);
+    TEST(pch_shared_per_flag_set);
+    TEST(pch_only_for_c_library);
+    TEST(pch_rebuilt_on_closure_change);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+// test_pools.cpp - Tests for resource pools ([pools] and per-target pool)
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// Independent command targets that log their start and end to `log`;
+// `pool_line` is added to each of them
+static BuildConfig make_project(const std::string& name, const std::string& pools,
+                                const std::string& pool_line) {
+    fs::path root = fixture->test_dir / name;
+    std::string build = "[project]\nname = \"" + name + "\"\n\n" + pools;
+    std::string log = (root / "log").string();
+    for (int i = 0; i < 3; ++i) {
+        std::string idx = std::to_string(i);
+        write_text(root / ("in" + idx + ".txt"), idx);
+        build += "[target.job" + idx + "]\ntype = \"command\"\n" + pool_line +
+                 "inputs = [\"in" + idx + ".txt\"]\noutputs = [\"out/" + idx + ".txt\"]\n"
+                 "argv = [\"/bin/sh\", \"-c\", \"echo start >> " + log +
+                 "; sleep 0.3; echo end >> " + log + "; cp $0 $1\", \"$in\", \"$out\"]\n\n";
+    }
+    write_text(root / "build.abc", build);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.num_threads = 4;
+    config.quiet = true;
+    return config;
+}
+
+// Largest number of logged jobs running at once
+static int max_overlap(const fs::path& log) {
+    std::ifstream in(log);
+    std::string line;
+    int running = 0;
+    int peak = 0;
+    while (std::getline(in, line)) {
+        running += line == "start" ? 1 : -1;
+        peak = std::max(peak, running);
+    }
+    return peak;
+}
+
+static bool has_error(const BuildResult& result, const std::string& text) {
+    for (const auto& error : result.errors) {
+        if (error.find(text) != std::string::npos) return true;
+    }
+    return false;
+}
+
+// =============================================================================
+// Pool Tests
+// =============================================================================
+
+void test_jobs_run_concurrently_without_pool() {
+    BuildConfig config = make_project("unpooled", "", "");
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.built_targets, 3u);
+    ASSERT(max_overlap(config.project_root / "log") > 1);
+}
+
+void test_pool_of_depth_one_serializes() {
+    BuildConfig config = make_project("pooled", "[pools]\nheavy = 1\n\n", "pool = \"heavy\"\n");
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.built_targets, 3u);
+    ASSERT_EQ(max_overlap(config.project_root / "log"), 1);
+}
+
+void test_kind_pool_applies_without_target_pool() {
+    BuildConfig config = make_project("kind", "[pools]\ncommand = 1\n\n", "");
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(max_overlap(config.project_root / "log"), 1);
+}
+
+void test_undeclared_pool_is_rejected() {
+    BuildConfig config = make_project("undeclared", "", "pool = \"heavy\"\n");
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(!result.success);
+    ASSERT(has_error(result, "undeclared pool 'heavy'"));
+    ASSERT(!fs::exists(config.project_root / "log"));
+}
+
+void test_zero_depth_is_rejected() {
+    for (const char* depth : {"0", "many"}) {
+        BuildConfig config = make_project(std::string("depth_") + depth,
+                                          std::string("[pools]\nheavy = ") + depth + "\n\n",
+                                          "pool = \"heavy\"\n");
+        BuildResult result = BuildOrchestrator(config).build();
+        ASSERT(!result.success);
+        ASSERT(has_error(result, "Invalid depth for pool 'heavy'"));
+    }
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Pool Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("pools");
+
+    std::cout << "Pool Tests:\n";
+    TEST(jobs_run_concurrently_without_pool);
+    TEST(pool_of_depth_one_serializes);
+    TEST(kind_pool_applies_without_target_pool);
+    TEST(undeclared_pool_is_rejected);
+    TEST(zero_depth_is_rejected);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// test_readahead.cpp - Tests for page-cache readahead of upcoming job inputs
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "core/readahead.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// =============================================================================
+// Readahead Tests
+// =============================================================================
+
+void test_hints_existing_files() {
+    fs::path dir = fixture->test_dir / "existing";
+    write_text(dir / "a.aria", std::string(100, 'a'));
+    write_text(dir / "b.aria", std::string(2000, 'b'));
+    fs::create_directories(dir / "subdir");
+
+    Readahead readahead;
+    readahead.hint({(dir / "a.aria").string(), (dir / "b.aria").string(),
+                    (dir / "subdir").string()});
+    readahead.drain();
+    ASSERT_EQ(readahead.files_advised(), 2u);
+    ASSERT_EQ(readahead.bytes_advised(), 2100u);
+}
+
+void test_skips_duplicates_and_missing_files() {
+    fs::path dir = fixture->test_dir / "missing";
+    write_text(dir / "a.aria", "a");
+    std::string later = (dir / "later.o").string();
+
+    Readahead readahead;
+    readahead.hint({(dir / "a.aria").string(), (dir / "a.aria").string(), later, ""});
+    readahead.drain();
+    ASSERT_EQ(readahead.files_advised(), 1u);
+
+    // A file that did not exist yet (an output still being built) may be
+    // hinted again; one already advised is not
+    write_text(later, "object");
+    readahead.hint({later, (dir / "a.aria").string()});
+    readahead.drain();
+    ASSERT_EQ(readahead.files_advised(), 2u);
+}
+
+// =============================================================================
+// Build Integration Tests
+// =============================================================================
+
+static BuildConfig make_project(const std::string& name) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc",
+               "[project]\nname = \"readahead\"\n\n"
+               "[target.a]\ntype = \"binary\"\nsources = [\"src/a.aria\"]\n\n"
+               "[target.b]\ntype = \"binary\"\nsources = [\"src/b.aria\"]\n\n"
+               "[target.c]\ntype = \"binary\"\nsources = [\"src/c.aria\"]\n");
+    write_text(root / "src" / "a.aria", "// a\n");
+    write_text(root / "src" / "b.aria", "// b\n");
+    write_text(root / "src" / "c.aria", "// c\n");
+
+    // Stands in for ariac: takes a moment, then creates the -o output
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\n"
+               "sleep 0.1\n"
+               "while [ $# -gt 0 ]; do [ \"$1\" = -o ] && : > \"$2\"; shift; done\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.num_threads = 1;
+    config.quiet = true;
+    return config;
+}
+
+void test_build_reads_ahead_upcoming_sources() {
+    BuildConfig config = make_project("build");
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.built_targets, 3u);
+    ASSERT(result.readahead_files >= 3u);
+
+    write_text(config.project_root / "src" / "a.aria", "// a, edited\n");
+    config.readahead = false;
+    BuildResult off = BuildOrchestrator(config).build();
+    ASSERT(off.success);
+    ASSERT_EQ(off.built_targets, 1u);
+    ASSERT_EQ(off.readahead_files, 0u);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Readahead Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("readahead");
+
+    std::cout << "Readahead Tests:\n";
+    TEST(hints_existing_files);
+    TEST(skips_duplicates_and_missing_files);
+
+    std::cout << "\nBuild Integration Tests:\n";
+    TEST(build_reads_ahead_upcoming_sources);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,499 @@
+// test_remote_execution.cpp - Tests for the remote execution backend
+// Part of aria_make - Aria Build System
+//
+// Spins up several workers on localhost Unix sockets inside this process
+// and drives them through RemoteExecutor.
+
+#include "core/build_orchestrator.hpp"
+#include "remote/content_store.hpp"
+#include "remote/remote_protocol.hpp"
+#include "remote/remote_executor.hpp"
+#include "remote/worker.hpp"
+#include "test_support.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+// A worker serving on its own thread
+struct LocalWorker {
+    std::unique_ptr<Worker> worker;
+    std::thread thread;
+
+    LocalWorker(const fs::path& dir, const std::string& name, size_t slots) {
+        WorkerConfig config;
+        config.endpoint = *Endpoint::parse("unix:" + (dir / (name + ".sock")).string());
+        config.cache_dir = dir / name;
+        config.slots = slots;
+        worker = std::make_unique<Worker>(config);
+
+        std::string error;
+        if (!worker->start(error)) {
+            throw std::runtime_error("worker failed to start: " + error);
+        }
+        thread = std::thread([this] { worker->serve(); });
+    }
+
+    ~LocalWorker() {
+        worker->stop();
+        thread.join();
+    }
+};
+
+class RemoteFixture : public TestFixture {
+public:
+    fs::path root;          // Client execution root
+
+    RemoteFixture() : TestFixture("remote"), root(test_dir / "project") {
+        fs::create_directories(root);
+    }
+
+    // sh action copying `input` to `output` (absolute paths under root)
+    Action copy_action(const std::string& input, const std::string& output) const {
+        Action action;
+        action.kind = ActionKind::COMMAND;
+        std::string in = (root / input).string();
+        std::string out = (root / output).string();
+        action.argv = {"/bin/sh", "-c", "cat " + in + " > " + out};
+        action.inputs = {in};
+        action.outputs = {out};
+        return action;
+    }
+};
+
+static std::unique_ptr<RemoteFixture> fixture;
+
+// =============================================================================
+// Content Store Tests
+// =============================================================================
+
+void test_content_store_roundtrip() {
+    ContentStore store(fixture->test_dir / "cas");
+    std::string data = "hello blobs";
+    Digest digest = ContentStore::digest_bytes(data);
+
+    ASSERT_EQ(digest.size, data.size());
+    ASSERT(!store.contains(digest));
+    ASSERT(store.put(digest, data));
+    ASSERT(store.contains(digest));
+    ASSERT(store.read(digest).value_or("") == data);
+
+    fs::path dest = fixture->test_dir / "materialized" / "a.txt";
+    ASSERT(store.materialize(digest, dest, false));
+    ASSERT_EQ(read_text(dest), data);
+}
+
+void test_content_store_digests_are_sha256() {
+    ASSERT_EQ(ContentStore::digest_bytes("").hash,
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    ASSERT_EQ(ContentStore::digest_bytes("abc").hash,
+              "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    // Spans two blocks; files hash the same as their bytes
+    std::string text = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    ASSERT_EQ(ContentStore::digest_bytes(text).hash,
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    std::string big(100000, 'x');
+    write_text(fixture->test_dir / "digest.bin", big);
+    ASSERT(ContentStore::digest_file(fixture->test_dir / "digest.bin") ==
+           ContentStore::digest_bytes(big));
+}
+
+void test_content_store_rejects_mismatch() {
+    ContentStore store(fixture->test_dir / "cas");
+    Digest digest = ContentStore::digest_bytes("expected");
+    ASSERT(!store.put(digest, "something else"));
+    ASSERT(!store.contains(digest));
+}
+
+// Object-file-like blob: shared boilerplate around a unique body
+static std::string fake_object(size_t i) {
+    std::string blob = "\x7f" "ELF header .text .data .bss .symtab .strtab __aria_rt_init "
+                       "__aria_rt_alloc __aria_rt_panic aria_string_concat ";
+    for (size_t line = 0; line < 40; ++line) {
+        blob += "func_" + std::to_string(i) + "_" + std::to_string(line) +
+                " mov rax, rbx; call __aria_rt_alloc; ret; ";
+    }
+    return blob;
+}
+
+void test_content_store_compression_and_dictionary() {
+    ContentStore store(fixture->test_dir / "cas_z");
+
+    std::vector<std::string> blobs;
+    for (size_t i = 0; i < 48; ++i) {
+        blobs.push_back(fake_object(i));
+        ASSERT(store.put(ContentStore::digest_bytes(blobs.back()), blobs.back()));
+    }
+    ASSERT(fs::exists(fixture->test_dir / "cas_z" / "dict" / "current"));
+
+    // Every blob decodes, with or without the dictionary it was written with
+    ContentStore reopened(fixture->test_dir / "cas_z");
+    for (const auto& blob : blobs) {
+        Digest digest = ContentStore::digest_bytes(blob);
+        ASSERT(reopened.read(digest).value_or("") == blob);
+    }
+    fs::path dest = fixture->test_dir / "restored" / "obj.o";
+    ASSERT(reopened.materialize(ContentStore::digest_bytes(blobs[40]), dest, true));
+    ASSERT_EQ(read_text(dest), blobs[40]);
+
+    StoreStats stats = reopened.stats();
+    ASSERT_EQ(stats.blobs, blobs.size());
+    ASSERT(stats.ratio() > 2.0);
+    ASSERT_EQ(stats.restored_bytes, blobs[40].size());
+
+    // The dictionary captures what the samples share
+    std::string dict = ContentStore::train_dictionary(blobs, 1024);
+    ASSERT(!dict.empty() && dict.size() <= 1024);
+    ASSERT(dict.find("__aria_rt_alloc") != std::string::npos);
+}
+
+void test_content_store_incompressible_stays_raw() {
+    ContentStore store(fixture->test_dir / "cas_raw");
+    std::string noise;
+    uint64_t x = 12345;
+    for (size_t i = 0; i < 4096; ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        noise += static_cast<char>(x >> 56);
+    }
+    Digest digest = ContentStore::digest_bytes(noise);
+    ASSERT(store.put(digest, noise));
+    ASSERT(fs::exists(store.path_for(digest)));     // Not ".z": hardlinkable
+
+    fs::path dest = fixture->test_dir / "restored" / "noise.bin";
+    ASSERT(store.materialize(digest, dest, false));
+    ASSERT_EQ(fs::hard_link_count(dest), 2u);
+}
+
+void test_content_store_chunking_dedups_versions() {
+    StoreOptions options;
+    options.chunk_large = true;
+    ContentStore store(fixture->test_dir / "cas_cdc", options);
+
+    // Two versions of an "archive" differing by an insertion in the middle
+    std::string v1;
+    uint64_t x = 99;
+    while (v1.size() < 4 * 1024 * 1024) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        v1 += static_cast<char>(x >> 56);
+    }
+    std::string v2 = v1;
+    v2.insert(v2.size() / 2, "a new archive member");
+
+    Digest d1 = ContentStore::digest_bytes(v1);
+    Digest d2 = ContentStore::digest_bytes(v2);
+    ASSERT(store.put(d1, v1));
+    uint64_t after_first = store.stats().stored_bytes;
+    ASSERT(store.put(d2, v2));
+    uint64_t added = store.stats().stored_bytes - after_first;
+
+    // Only the chunks around the edit are new
+    ASSERT(added < v2.size() / 8);
+    ASSERT(store.read(d1).value_or("") == v1);
+    ASSERT(store.read(d2).value_or("") == v2);
+    ASSERT_EQ(store.stats().blobs, 2u);
+
+    fs::path dest = fixture->test_dir / "restored" / "lib.a";
+    ASSERT(store.materialize(d2, dest, false));
+    ASSERT(read_text(dest) == v2);
+}
+
+// =============================================================================
+// Protocol Tests
+// =============================================================================
+
+void test_endpoint_parse() {
+    auto unix_ep = Endpoint::parse("unix:/tmp/w.sock");
+    ASSERT(unix_ep && unix_ep->kind == Endpoint::Kind::UNIX);
+    ASSERT_EQ(unix_ep->path, "/tmp/w.sock");
+
+    auto tcp_ep = Endpoint::parse("localhost:7070");
+    ASSERT(tcp_ep && tcp_ep->kind == Endpoint::Kind::TCP);
+    ASSERT_EQ(tcp_ep->host, "localhost");
+    ASSERT_EQ(tcp_ep->port, 7070);
+
+    ASSERT(!Endpoint::parse("no-port"));
+    ASSERT(!Endpoint::parse("host:99999"));
+}
+
+void test_request_roundtrip() {
+    RemoteRequest req;
+    req.argv = {"gcc", "-c", "a.c"};
+    req.env = {{"K", "V"}};
+    req.working_dir = "sub";
+    req.timeout_ms = 1234;
+    req.inputs.push_back(RemoteFile{"a.c", ContentStore::digest_bytes("x"), true});
+    req.outputs = {"a.o"};
+
+    RemoteRequest back = RemoteRequest::decode(req.encode());
+    ASSERT(back.argv == req.argv);
+    ASSERT(back.env == req.env);
+    ASSERT_EQ(back.working_dir, "sub");
+    ASSERT_EQ(back.timeout_ms, 1234ULL);
+    ASSERT_EQ(back.inputs.size(), 1u);
+    ASSERT(back.inputs[0].digest == req.inputs[0].digest);
+    ASSERT(back.inputs[0].executable);
+    ASSERT(back.outputs == req.outputs);
+
+    bool threw = false;
+    try {
+        RemoteRequest::decode(req.encode().substr(0, 10));
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    ASSERT(threw);
+}
+
+// =============================================================================
+// Remote Execution Tests
+// =============================================================================
+
+void test_remote_execute_and_upload_once() {
+    LocalWorker w1(fixture->test_dir, "w1", 2);
+    LocalWorker w2(fixture->test_dir, "w2", 2);
+
+    RemoteExecutor executor({w1.worker->endpoint(), w2.worker->endpoint()}, fixture->root);
+    std::vector<std::string> errors;
+    ASSERT_EQ(executor.connect(errors), 4u);
+    ASSERT(errors.empty());
+
+    // Large enough that transfer cost dominates worker choice
+    std::string big(1 << 20, 'a');
+    write_text(fixture->root / "in.txt", big);
+
+    auto first = executor.try_execute(fixture->copy_action("in.txt", "out/one.txt"), 1e9);
+    ASSERT(first && first->success());
+    ASSERT(read_text(fixture->root / "out/one.txt") == big);
+    ASSERT_EQ(executor.stats().blobs_uploaded, 1u);
+
+    // Same input again: sent to the worker that already has it, no upload
+    auto second = executor.try_execute(fixture->copy_action("in.txt", "out/two.txt"), 1e9);
+    ASSERT(second && second->success());
+    ASSERT(read_text(fixture->root / "out/two.txt") == big);
+    ASSERT_EQ(executor.stats().blobs_uploaded, 1u);
+    ASSERT_EQ(executor.stats().blobs_present, 1u);
+    ASSERT_EQ(executor.stats().remote_actions, 2u);
+}
+
+void test_remote_declines_when_local_is_cheaper() {
+    LocalWorker w1(fixture->test_dir, "w3", 1);
+
+    RemoteExecutor executor({w1.worker->endpoint()}, fixture->root);
+    std::vector<std::string> errors;
+    ASSERT_EQ(executor.connect(errors), 1u);
+
+    write_text(fixture->root / "fresh.txt", std::string(4 << 20, 'b'));
+    auto result = executor.try_execute(fixture->copy_action("fresh.txt", "out/fresh.txt"), 0.0);
+    ASSERT(!result);
+    ASSERT_EQ(executor.stats().blobs_uploaded, 0u);
+}
+
+void test_remote_ineligible_actions_stay_local() {
+    LocalWorker w1(fixture->test_dir, "w4", 1);
+
+    RemoteExecutor executor({w1.worker->endpoint()}, fixture->root);
+    std::vector<std::string> errors;
+    executor.connect(errors);
+
+    // Input outside the execution root
+    Action outside;
+    outside.kind = ActionKind::COMMAND;
+    outside.argv = {"/bin/true"};
+    outside.inputs = {"/etc/hostname"};
+    ASSERT(!executor.try_execute(outside, 1e9));
+
+    // Test runs never leave the machine
+    Action test = fixture->copy_action("in.txt", "out/test.txt");
+    test.kind = ActionKind::TEST;
+    ASSERT(!executor.try_execute(test, 1e9));
+}
+
+void test_remote_concurrent_workers() {
+    LocalWorker w1(fixture->test_dir, "w5", 2);
+    LocalWorker w2(fixture->test_dir, "w6", 2);
+
+    RemoteExecutor executor({w1.worker->endpoint(), w2.worker->endpoint()}, fixture->root);
+    std::vector<std::string> errors;
+    ASSERT_EQ(executor.connect(errors), 4u);
+
+    const int n = 4;
+    for (int i = 0; i < n; ++i) {
+        write_text(fixture->root / ("par" + std::to_string(i) + ".txt"),
+                   "payload " + std::to_string(i));
+    }
+
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n; ++i) {
+        threads.emplace_back([&, i] {
+            std::string idx = std::to_string(i);
+            auto r = executor.try_execute(
+                fixture->copy_action("par" + idx + ".txt", "out/par" + idx + ".txt"), 1e9);
+            if (r && r->success()) succeeded++;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    ASSERT_EQ(succeeded.load(), n);
+    for (int i = 0; i < n; ++i) {
+        std::string idx = std::to_string(i);
+        ASSERT_EQ(read_text(fixture->root / ("out/par" + idx + ".txt")), "payload " + idx);
+    }
+}
+
+void test_worker_rejects_escaping_paths() {
+    LocalWorker w1(fixture->test_dir, "w7", 1);
+
+    std::string error;
+    int fd = connect_endpoint(w1.worker->endpoint(), error);
+    ASSERT(fd >= 0);
+
+    RemoteRequest req;
+    req.argv = {"/bin/true"};
+    req.outputs = {"../escape.txt"};
+    ASSERT(send_message(fd, MessageType::EXECUTE, req.encode()));
+
+    MessageType type;
+    std::string payload;
+    ASSERT(recv_message(fd, type, payload));
+    ASSERT(type == MessageType::EXECUTE_REPLY);
+    RemoteResponse resp = RemoteResponse::decode(payload);
+    ASSERT(resp.exit_code != 0);
+    ASSERT(resp.stderr_output.find("refusing") != std::string::npos);
+    close(fd);
+}
+
+void test_build_outside_working_directory_goes_remote() {
+    LocalWorker w1(fixture->test_dir, "w8", 4);
+
+    // A checkout that is not the working directory (aria_make -C <dir>)
+    fs::path root = fixture->test_dir / "checkout";
+    std::string targets = "[project]\nname = \"remote\"\n\n";
+    for (int i = 0; i < 4; ++i) {
+        std::string idx = std::to_string(i);
+        write_text(root / ("in" + idx + ".txt"), "payload " + idx);
+        targets += "[target.copy" + idx + "]\ntype = \"command\"\n"
+                   "inputs = [\"in" + idx + ".txt\"]\noutputs = [\"out/" + idx + ".txt\"]\n"
+                   "argv = [\"/bin/sh\", \"-c\", \"sleep 0.3; cat $0 > $1\", \"$in\", \"$out\"]\n\n";
+    }
+    write_text(root / "build.abc", targets);
+    ASSERT(fs::current_path() != root);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.num_threads = 1;
+    config.remote_workers = {"unix:" + (fixture->test_dir / "w8.sock").string()};
+    config.quiet = true;
+
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT_EQ(result.built_targets, 4u);
+    ASSERT(result.remote_actions > 0);
+    for (int i = 0; i < 4; ++i) {
+        std::string idx = std::to_string(i);
+        ASSERT_EQ(read_text(root / "out" / (idx + ".txt")), "payload " + idx);
+    }
+}
+
+static std::string pch_targets() {
+    std::string targets = "[project]\nname = \"remote_pch\"\n\n";
+    for (int i = 0; i < 3; ++i) {
+        std::string idx = std::to_string(i);
+        targets += "[target.rt" + idx + "]\ntype = \"c_library\"\nsources = [\"src/a.c\"]\n"
+                   "compiler = \"gcc\"\nflags = [\"-O" + idx + "\"]\n"
+                   "pch = \"include/common.h\"\n\n";
+    }
+    return targets;
+}
+
+void test_remote_compile_ships_project_headers() {
+    LocalWorker w1(fixture->test_dir, "w9", 4);
+
+    // include/abi.h is only reached through the precompiled header
+    fs::path root = fixture->test_dir / "headers";
+    write_text(root / "build.abc", pch_targets());
+    write_text(root / "include" / "common.h", "#include \"abi.h\"\n");
+    write_text(root / "include" / "abi.h", "#define ENTRY entry_v1\n");
+    write_text(root / "src" / "a.c", "int ENTRY(void) { return 1; }\n");
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.num_threads = 1;
+    config.remote_workers = {"unix:" + (fixture->test_dir / "w9.sock").string()};
+    config.use_git_index = false;
+    config.quiet = true;
+
+    // No depfile recorded yet: every compile stays local
+    ContentStore worker_store(fixture->test_dir / "w9" / "cas");
+    ASSERT(BuildOrchestrator(config).build().success);
+    ASSERT(!worker_store.contains(ContentStore::digest_bytes("#include \"abi.h\"\n")));
+
+    // The precompiled headers are rebuilt; those sent to the worker
+    // carry the header closure their depfile listed
+    std::string abi = "#define ENTRY entry_v2\n";
+    write_text(root / "include" / "abi.h", abi);
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT(result.remote_actions > 0);
+    ASSERT(worker_store.contains(ContentStore::digest_bytes(abi)));
+    for (int i = 0; i < 3; ++i) {
+        std::string archive = read_text(config.output_dir / ("librt" + std::to_string(i) + ".a"));
+        ASSERT(archive.find("entry_v2") != std::string::npos);
+        ASSERT(archive.find("entry_v1") == std::string::npos);
+    }
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Remote Execution Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<RemoteFixture>();
+
+    std::cout << "ContentStore Tests:\n";
+    TEST(content_store_roundtrip);
+    TEST(content_store_digests_are_sha256);
+    TEST(content_store_rejects_mismatch);
+    TEST(content_store_compression_and_dictionary);
+    TEST(content_store_incompressible_stays_raw);
+    TEST(content_store_chunking_dedups_versions);
+
+    std::cout << "\nProtocol Tests:\n";
+    TEST(endpoint_parse);
+    TEST(request_roundtrip);
+
+    std::cout << "\nRemote Execution Tests:\n";
+    TEST(remote_execute_and_upload_once);
+    TEST(remote_declines_when_local_is_cheaper);
+    TEST(remote_ineligible_actions_stay_local);
+    TEST(remote_concurrent_workers);
+    TEST(worker_rejects_escaping_paths);
+    TEST(build_outside_working_directory_goes_remote);
+    TEST(remote_compile_ships_project_headers);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+// test_shared_library.cpp - Tests for shared_library targets and interface stubs
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "core/interface_stub.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// Build `source` into a shared library with gcc; returns its stub
+static std::string stub_of(const std::string& name, const std::string& source,
+                           const std::string& extra = "") {
+    fs::path dir = fixture->test_dir / "stubs";
+    write_text(dir / (name + ".c"), source);
+    fs::path library = dir / ("lib" + name + ".so");
+    std::string command = "gcc -shared -fPIC -Wl,-soname,lib" + name + ".so -o " +
+                          library.string() + " " + (dir / (name + ".c")).string() + " " + extra;
+    if (std::system(command.c_str()) != 0) {
+        throw std::runtime_error("gcc failed: " + command);
+    }
+    std::string error;
+    auto stub = read_interface_stub(library, error);
+    if (!stub) throw std::runtime_error(error);
+    return *stub;
+}
+
+static bool has_line(const std::string& stub, const std::string& line) {
+    return stub.find("\n" + line + "\n") != std::string::npos;
+}
+
+static const char* LIBRARY_FUNCTIONS =
+    "static int helper(int x) { return x * 2; }\n"
+    "__attribute__((visibility(\"hidden\"))) int internal(int x) { return x + 1; }\n"
+    "__attribute__((weak)) int hook(void) { return 0; }\n"
+    "int compute(int x) { return helper(x) + internal(x); }\n";
+static const std::string LIBRARY_SOURCE = std::string("int table[16];\n") + LIBRARY_FUNCTIONS;
+
+// =============================================================================
+// Interface Stub Tests
+// =============================================================================
+
+void test_stub_lists_exported_symbols() {
+    std::string stub = stub_of("exports", LIBRARY_SOURCE);
+    ASSERT_EQ(stub.rfind("soname libexports.so\n", 0), 0u);
+    ASSERT(has_line(stub, "func compute"));
+    ASSERT(has_line(stub, "func hook weak"));
+    ASSERT(has_line(stub, "object table 64"));
+    ASSERT(stub.find("helper") == std::string::npos);
+    ASSERT(stub.find("internal") == std::string::npos);
+
+    // Sorted by name
+    ASSERT(stub.find("compute") < stub.find("hook"));
+    ASSERT(stub.find("hook") < stub.find("table"));
+}
+
+void test_stub_ignores_implementation_changes() {
+    std::string before = stub_of("impl", LIBRARY_SOURCE);
+    std::string after = stub_of("impl",
+        "int table[16];\n"
+        "static int helper(int x) { return x * 3 - 1; }\n"
+        "static int other(int x) { return x ^ 5; }\n"
+        "__attribute__((visibility(\"hidden\"))) int internal(int x) { return other(x); }\n"
+        "__attribute__((weak)) int hook(void) { return 42; }\n"
+        "int compute(int x) { return helper(x) + internal(x) * 7; }\n");
+    ASSERT_EQ(before, after);
+
+    // A new export or a resized object is an interface change
+    std::string added = stub_of("impl", LIBRARY_SOURCE + "int extra(void) { return 1; }\n");
+    ASSERT(added != before);
+    ASSERT(has_line(added, "func extra"));
+    std::string resized = stub_of("impl", std::string("int table[32];\n") + LIBRARY_FUNCTIONS);
+    ASSERT(resized != before);
+    ASSERT(has_line(resized, "object table 128"));
+}
+
+void test_stub_records_symbol_versions() {
+    fs::path script = fixture->test_dir / "stubs" / "versions.map";
+    write_text(script, "V_1 { global: old_api; local: *; };\nV_2 { global: new_api; } V_1;\n");
+    std::string stub = stub_of("versioned",
+        "int old_api(void) { return 1; }\n"
+        "int new_api(void) { return 2; }\n"
+        "int unlisted(void) { return 3; }\n",
+        "-Wl,--version-script=" + script.string());
+    ASSERT(has_line(stub, "func old_api@@V_1"));
+    ASSERT(has_line(stub, "func new_api@@V_2"));
+    ASSERT(stub.find("unlisted") == std::string::npos);
+
+    std::string error;
+    ASSERT(!read_interface_stub(script, error));
+    ASSERT(!error.empty());
+}
+
+// =============================================================================
+// shared_library Target Tests
+// =============================================================================
+
+static const char* BUILD_FILE = R"([project]
+name = "shared"
+
+[target.core]
+type = "shared_library"
+sources = ["src/core.c"]
+compiler = "gcc"
+flags = ["-O1"]
+
+[target.app]
+type = "binary"
+sources = ["src/main.aria"]
+deps = ["core"]
+link_libraries = ["core"]
+link_paths = [".aria_make/build"]
+)";
+
+static BuildConfig make_project(const std::string& name) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", BUILD_FILE);
+    write_text(root / "src" / "core.c", "int core(int x) { return x + 1; }\n");
+    write_text(root / "src" / "main.aria", "// main\n");
+
+    // Stands in for ariac: creates the -o output
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\n"
+               "while [ $# -gt 0 ]; do [ \"$1\" = -o ] && : > \"$2\"; shift; done\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.quiet = true;
+    return config;
+}
+
+void test_shared_library_lowering() {
+    BuildConfig config = make_project("lowering");
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    ASSERT(errors.empty());
+
+    const auto& ids = graph.actions_for("core");
+    ASSERT_EQ(ids.size(), 2u);
+    const Action& link = graph.get(ids.back());
+    ASSERT(link.kind == ActionKind::LINK);
+    ASSERT(std::find(link.argv.begin(), link.argv.end(), "-shared") != link.argv.end());
+    ASSERT(std::find(link.argv.begin(), link.argv.end(), "-Wl,-soname,libcore.so") !=
+           link.argv.end());
+    ASSERT_EQ(fs::path(link.outputs[0]).filename(), "libcore.so");
+}
+
+void test_dependents_cut_off_by_stub() {
+    BuildConfig config = make_project("cutoff");
+
+    BuildResult first = BuildOrchestrator(config).build();
+    ASSERT(first.success);
+    ASSERT_EQ(first.built_targets, 2u);
+    ASSERT(fs::exists(config.output_dir / "libcore.so.stub"));
+
+    // New body, same interface: the library is rebuilt, the binary is not
+    write_text(config.project_root / "src" / "core.c", "int core(int x) { return x * 3; }\n");
+    BuildResult body = BuildOrchestrator(config).build();
+    ASSERT(body.success);
+    ASSERT_EQ(body.built_targets, 1u);
+    ASSERT_EQ(body.cutoff_targets, 1u);
+
+    // A new export changes the stub and relinks the binary
+    write_text(config.project_root / "src" / "core.c",
+               "int core(int x) { return x * 3; }\nint core_version(void) { return 2; }\n");
+    BuildResult api = BuildOrchestrator(config).build();
+    ASSERT(api.success);
+    ASSERT_EQ(api.built_targets, 2u);
+    ASSERT_EQ(api.cutoff_targets, 0u);
+
+    // A missing stub is rebuilt
+    fs::remove(config.output_dir / "libcore.so.stub");
+    BuildResult missing = BuildOrchestrator(config).build();
+    ASSERT(missing.success);
+    ASSERT(fs::exists(config.output_dir / "libcore.so.stub"));
+
+    BuildResult clean = BuildOrchestrator(config).build();
+    ASSERT(clean.success);
+    ASSERT_EQ(clean.built_targets, 0u);
+}
+
+static const char* TEST_BUILD_FILE = R"([project]
+name = "shared_test"
+
+[target.core]
+type = "shared_library"
+sources = ["src/core.c"]
+compiler = "gcc"
+
+[target.check]
+type = "test"
+sources = ["tests/check.aria"]
+deps = ["core"]
+link_libraries = ["core"]
+link_paths = [".aria_make/build"]
+)";
+
+static size_t count_status(const BuildResult& result, TestStatus status) {
+    return static_cast<size_t>(std::count_if(
+        result.test_results.begin(), result.test_results.end(),
+        [&](const TestOutcome& t) { return t.status == status; }));
+}
+
+void test_cut_off_test_reruns_against_new_library() {
+    fs::path root = fixture->test_dir / "test_cutoff";
+    write_text(root / "build.abc", TEST_BUILD_FILE);
+    write_text(root / "src" / "core.c", "int core(int x) { return x + 1; }\n");
+    write_text(root / "tests" / "check.aria", "#!/bin/sh\necho run >> runs.log\n");
+
+    // Stands in for ariac: the "test binary" is the shell script source
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\n"
+               "src=; out=\n"
+               "while [ $# -gt 0 ]; do\n"
+               "  case \"$1\" in -o) out=\"$2\"; shift ;; *.aria) src=\"$1\" ;; esac\n"
+               "  shift\n"
+               "done\n"
+               "cp \"$src\" \"$out\" && chmod +x \"$out\"\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.run_tests = true;
+    config.quiet = true;
+
+    BuildResult first = BuildOrchestrator(config).build();
+    ASSERT(first.success);
+    ASSERT_EQ(count_status(first, TestStatus::PASSED), 1u);
+    BuildResult cached = BuildOrchestrator(config).build();
+    ASSERT_EQ(count_status(cached, TestStatus::CACHED), 1u);
+
+    // Same interface: the test binary is cut off, but the library it
+    // loads changed, so its result is not reused
+    write_text(root / "src" / "core.c", "int core(int x) { return x * 3; }\n");
+    BuildResult body = BuildOrchestrator(config).build();
+    ASSERT(body.success);
+    ASSERT_EQ(body.cutoff_targets, 1u);
+    ASSERT_EQ(count_status(body, TestStatus::PASSED), 1u);
+
+    std::ifstream log(root / "runs.log");
+    std::string line;
+    size_t runs = 0;
+    while (std::getline(log, line)) runs++;
+    ASSERT_EQ(runs, 2u);
+
+    BuildResult again = BuildOrchestrator(config).build();
+    ASSERT_EQ(count_status(again, TestStatus::CACHED), 1u);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Shared Library Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("shared_library");
+
+    std::cout << "Interface Stub Tests:\n";
+    TEST(stub_lists_exported_symbols);
+    TEST(stub_ignores_implementation_changes);
+    TEST(stub_records_symbol_versions);
+
+    std::cout << "\nshared_library Target Tests:\n";
+    TEST(shared_library_lowering);
+    TEST(dependents_cut_off_by_stub);
+    TEST(cut_off_test_reruns_against_new_library);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -6,6 +6,8 @@
 
 #include <iostream>
 #include <fstream>
+#include <cstdio>
+#include <cstdlib>
 #include <cassert>
 #include <filesystem>
 #include <thread>
@@ -329,6 +331,74 @@ void test_state_manager_stats() {
     ASSERT_EQ(stats.rebuilt_targets, 0ULL);
 }
 
+void test_state_manager_output_hash() {
+    std::vector<std::string> sources = { fixture->source_file.string() };
+    std::vector<std::string> outputs = { fixture->output_file.string() };
+    std::vector<DependencyInfo> deps;
+    std::vector<std::string> impl_deps;
+
+    {
+        StateManager mgr(fixture->test_dir);
+        mgr.update_record("gen", fixture->output_file, sources, deps, impl_deps, {}, 5);
+
+        // First observation always counts as a change
+        ASSERT(mgr.update_output_hash("gen", outputs));
+
+        // Rebuild producing identical bytes: dependents may be cut off
+        mgr.update_record("gen", fixture->output_file, sources, deps, impl_deps, {}, 5, 12, 3400);
+        ASSERT(!mgr.update_output_hash("gen", outputs));
+        ASSERT(mgr.save());
+    }
+
+    // Output hash, duration and resource usage survive a save/load round trip
+    StateManager mgr(fixture->test_dir);
+    ASSERT(mgr.load());
+    auto record = mgr.get_record("gen");
+    ASSERT(record.has_value());
+    ASSERT(!record->output_hash.empty());
+    ASSERT_EQ(record->build_duration_ms, 5ULL);
+    ASSERT_EQ(record->cpu_time_ms, 12ULL);
+    ASSERT_EQ(record->peak_rss_kb, 3400ULL);
+
+    {
+        std::ofstream out(fixture->output_file);
+        out << "different object file\n";
+    }
+    mgr.update_record("gen", fixture->output_file, sources, deps, impl_deps, {}, 5);
+    ASSERT(mgr.update_output_hash("gen", outputs));
+}
+
+void test_state_manager_dependency_round_trip() {
+    fs::path profile = fixture->test_dir / "merged.profdata";
+    std::ofstream(profile) << "profile v1\n";
+    std::vector<std::string> sources = { fixture->source_file.string() };
+    std::vector<std::string> impl_deps;
+
+    {
+        StateManager mgr(fixture->test_dir);
+        std::vector<DependencyInfo> deps = { {profile.string(), mgr.hash_file(profile)} };
+        mgr.update_record("opt", fixture->output_file, sources, deps, impl_deps, {});
+        ASSERT(mgr.save());
+    }
+
+    // Content-hashed dependencies survive a save/load round trip
+    {
+        StateManager mgr(fixture->test_dir);
+        ASSERT(mgr.load());
+        auto record = mgr.get_record("opt");
+        ASSERT(record.has_value());
+        ASSERT_EQ(record->direct_dependencies.size(), 1u);
+        ASSERT_EQ(record->direct_dependencies[0].path, profile.string());
+        ASSERT_EQ(mgr.check_dirty("opt", fixture->output_file, sources, {}), DirtyReason::CLEAN);
+    }
+
+    std::ofstream(profile) << "profile v2\n";
+    StateManager mgr(fixture->test_dir);
+    ASSERT(mgr.load());
+    ASSERT_EQ(mgr.check_dirty("opt", fixture->output_file, sources, {}),
+              DirtyReason::DEPENDENCY_CHANGED);
+}
+
 // =============================================================================
 // Thread Safety Tests
 // =============================================================================
@@ -413,6 +483,163 @@ void test_state_manager_concurrent_write_read() {
     ASSERT(mgr.target_count() >= 50);
 }
 
+// =============================================================================
+// Git Index Tests
+// =============================================================================
+
+// Runs a shell command in `dir` and returns its trimmed stdout
+static std::string run_in(const fs::path& dir, const std::string& command) {
+    std::string full = "cd '" + dir.string() + "' && " + command + " 2>/dev/null";
+    FILE* pipe = popen(full.c_str(), "r");
+    if (!pipe) return "";
+    std::string out;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe)) out += buffer;
+    pclose(pipe);
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r')) out.pop_back();
+    return out;
+}
+
+// A fresh repository with one tracked file; empty path if git is unavailable
+static fs::path make_git_repo(const std::string& name) {
+    fs::path repo = fixture->test_dir / name;
+    fs::create_directories(repo / "src");
+    std::ofstream(repo / "src" / "main.aria") << "func:main = int8() { pass(0); };\n";
+    if (run_in(repo, "git init -q . && git add src/main.aria && echo ok") != "ok") {
+        return {};
+    }
+    return repo;
+}
+
+void test_git_blob_oid() {
+    fs::path repo = make_git_repo("git_oid");
+    if (repo.empty()) return;  // git not installed
+
+    fs::path file = repo / "src" / "main.aria";
+    ASSERT_EQ(GitIndex::blob_oid(file), run_in(repo, "git hash-object src/main.aria"));
+}
+
+void test_git_index_clean_hit() {
+    fs::path repo = make_git_repo("git_hit");
+    if (repo.empty()) return;
+
+    fs::path file = repo / "src" / "main.aria";
+    std::string oid = run_in(repo, "git hash-object src/main.aria");
+
+    // Later index write: the entry is not racily clean
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    run_in(repo, "touch .git/index");
+
+    StateManager mgr(repo / ".aria_make");
+    ASSERT(mgr.use_git_index(repo));
+    ASSERT_EQ(mgr.hash_file(file), "git:" + oid);
+    ASSERT_EQ(mgr.get_stats().git_index_hits, 1u);
+    ASSERT_EQ(mgr.get_stats().files_hashed, 0u);
+
+    // v4 (prefix-compressed paths) parses to the same result
+    run_in(repo, "git update-index --index-version 4");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    run_in(repo, "touch .git/index");
+    StateManager v4(repo / ".aria_make");
+    ASSERT(v4.use_git_index(repo));
+    ASSERT_EQ(v4.hash_file(file), "git:" + oid);
+    ASSERT_EQ(v4.get_stats().git_index_hits, 1u);
+}
+
+void test_git_index_modified_file() {
+    fs::path repo = make_git_repo("git_modified");
+    if (repo.empty()) return;
+
+    fs::path file = repo / "src" / "main.aria";
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::ofstream(file) << "func:main = int8() { pass(1); };\n";
+
+    StateManager mgr(repo / ".aria_make");
+    ASSERT(mgr.use_git_index(repo));
+    // Stat data no longer matches: hashed from content, same scheme
+    ASSERT_EQ(mgr.hash_file(file), "git:" + run_in(repo, "git hash-object src/main.aria"));
+    ASSERT_EQ(mgr.get_stats().git_index_hits, 0u);
+    ASSERT_EQ(mgr.get_stats().files_hashed, 1u);
+
+    // Untracked and outside-the-worktree files keep working
+    std::ofstream(repo / "src" / "new.aria") << "x\n";
+    ASSERT(!mgr.hash_file(repo / "src" / "new.aria").empty());
+    ASSERT(mgr.hash_file(fixture->source_file).rfind("fnv1a:", 0) == 0);
+}
+
+void test_git_index_absent() {
+    StateManager mgr(fixture->test_dir);
+    ASSERT(!mgr.use_git_index(fs::path("/")));
+    ASSERT(mgr.hash_file(fixture->source_file).rfind("fnv1a:", 0) == 0);
+}
+
+// =============================================================================
+// Batched I/O Tests
+// =============================================================================
+
+// Files of assorted sizes, including empty and multi-chunk ones
+static std::vector<std::string> make_prefetch_files(const fs::path& dir) {
+    fs::create_directories(dir);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 40; ++i) {
+        fs::path path = dir / ("f" + std::to_string(i) + ".aria");
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(i * i * 97, static_cast<char>('a' + i % 26));
+        paths.push_back(path.string());
+    }
+    return paths;
+}
+
+void test_prefetch_matches_hash_file() {
+    auto paths = make_prefetch_files(fixture->test_dir / "prefetch");
+    std::string missing = (fixture->test_dir / "prefetch" / "missing.aria").string();
+
+    StateManager reference(fixture->test_dir);
+    for (IoBackend backend : {IoBackend::URING, IoBackend::THREADS}) {
+        StateManager mgr(fixture->test_dir);
+        mgr.set_io_backend(backend);
+
+        auto request = paths;
+        request.push_back(missing);
+        request.push_back(paths[0]);    // Duplicates are hashed once
+        ASSERT_EQ(mgr.prefetch_hashes(request), paths.size());
+        ASSERT(!mgr.io_backend_name().empty());
+        ASSERT_EQ(mgr.get_stats().files_hashed, paths.size());
+
+        for (const auto& path : paths) {
+            ASSERT_EQ(mgr.hash_file(path), reference.hash_file(path));
+        }
+        // Served from the cache: nothing re-read
+        ASSERT_EQ(mgr.get_stats().files_hashed, paths.size());
+        ASSERT(mgr.hash_file(missing).empty());
+
+        // Already cached and unchanged: nothing to do
+        ASSERT_EQ(mgr.prefetch_hashes(paths), 0u);
+    }
+}
+
+void test_prefetch_git_blobs() {
+    fs::path repo = make_git_repo("git_prefetch");
+    if (repo.empty()) return;
+
+    auto paths = make_prefetch_files(repo / "gen");
+    run_in(repo, "git add gen");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    run_in(repo, "touch .git/index");
+    std::ofstream(paths[3], std::ios::app) << "changed";     // Stat no longer matches
+
+    for (IoBackend backend : {IoBackend::URING, IoBackend::THREADS}) {
+        StateManager mgr(repo / ".aria_make");
+        mgr.set_io_backend(backend);
+        ASSERT(mgr.use_git_index(repo));
+        ASSERT_EQ(mgr.prefetch_hashes(paths), paths.size());
+        ASSERT_EQ(mgr.get_stats().git_index_hits, paths.size() - 1);
+        ASSERT_EQ(mgr.get_stats().files_hashed, 1u);
+        ASSERT_EQ(mgr.hash_file(paths[3]),
+                  "git:" + run_in(repo, "git hash-object gen/f3.aria"));
+    }
+}
+
 // =============================================================================
 // Main
 // =============================================================================
@@ -447,11 +674,23 @@ int main() {
     TEST(state_manager_clear);
     TEST(state_manager_toolchain);
     TEST(state_manager_stats);
+    TEST(state_manager_output_hash);
+    TEST(state_manager_dependency_round_trip);
 
     std::cout << "\nThread Safety Tests:\n";
     TEST(state_manager_concurrent_reads);
     TEST(state_manager_concurrent_write_read);
 
+    std::cout << "\nGit Index Tests:\n";
+    TEST(git_blob_oid);
+    TEST(git_index_clean_hit);
+    TEST(git_index_modified_file);
+    TEST(git_index_absent);
+
+    std::cout << "\nBatched I/O Tests:\n";
+    TEST(prefetch_matches_hash_file);
+    TEST(prefetch_git_blobs);
+
     // Cleanup
     fixture.reset();
 
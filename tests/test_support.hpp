@@ -0,0 +1,86 @@
+// test_support.hpp - Shared harness for the aria_make test executables
+// Part of aria_make - Aria Build System
+//
+// Each test executable is a single translation unit: it defines
+// test_<name>() functions, runs them with TEST(name) from main() and
+// returns non-zero if any failed.
+
+#ifndef ARIA_MAKE_TEST_SUPPORT_HPP
+#define ARIA_MAKE_TEST_SUPPORT_HPP
+
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// Test counters
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) \
+    do { \
+        tests_run++; \
+        std::cout << "  Testing: " << #name << "... "; \
+        try { \
+            test_##name(); \
+            tests_passed++; \
+            std::cout << "PASS\n"; \
+        } catch (const std::exception& e) { \
+            std::cout << "FAIL: " << e.what() << "\n"; \
+        } \
+    } while(0)
+
+#define ASSERT(cond) \
+    if (!(cond)) { \
+        throw std::runtime_error("Assertion failed: " #cond); \
+    }
+
+#define ASSERT_EQ(a, b) \
+    if ((a) != (b)) { \
+        throw std::runtime_error("Assertion failed: " #a " == " #b); \
+    }
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+inline std::string read_text(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << in.rdbuf();
+    return oss.str();
+}
+
+// Creates parent directories as needed
+inline void write_text(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+// Scratch directory for one test executable, unique per process and
+// removed with its contents on destruction
+class TestFixture {
+public:
+    fs::path test_dir;
+
+    explicit TestFixture(const std::string& suite) {
+        test_dir = fs::temp_directory_path() /
+                   ("aria_make_" + suite + "_test_" + std::to_string(getpid()));
+        fs::create_directories(test_dir);
+    }
+
+    virtual ~TestFixture() {
+        std::error_code ec;
+        fs::remove_all(test_dir, ec);
+    }
+
+    TestFixture(const TestFixture&) = delete;
+    TestFixture& operator=(const TestFixture&) = delete;
+};
+
+#endif // ARIA_MAKE_TEST_SUPPORT_HPP
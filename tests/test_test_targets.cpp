@@ -0,0 +1,198 @@
+// test_test_targets.cpp - Tests for test targets: sharding, timeouts and result cache
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "core/process_runner.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <set>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// A project whose "Aria sources" are shell scripts: the fake compiler
+// copies the source to the -o output and makes it executable
+static BuildConfig make_project(const std::string& name, const std::string& targets) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", "[project]\nname = \"" + name + "\"\n\n" + targets);
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\n"
+               "src=; out=\n"
+               "while [ $# -gt 0 ]; do\n"
+               "  case \"$1\" in -o) out=\"$2\"; shift ;; *.aria) src=\"$1\" ;; esac\n"
+               "  shift\n"
+               "done\n"
+               "cp \"$src\" \"$out\" && chmod +x \"$out\"\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.run_tests = true;
+    config.quiet = true;
+    return config;
+}
+
+static std::string test_target(const std::string& name, const std::string& extra = "") {
+    return "[target." + name + "]\ntype = \"test\"\nsources = [\"tests/" + name +
+           ".aria\"]\n" + extra + "\n";
+}
+
+static size_t count_status(const BuildResult& result, TestStatus status) {
+    return static_cast<size_t>(std::count_if(
+        result.test_results.begin(), result.test_results.end(),
+        [&](const TestOutcome& t) { return t.status == status; }));
+}
+
+// =============================================================================
+// Process Runner Tests
+// =============================================================================
+
+void test_timeout_holds_after_output_closed() {
+    // The child drops its pipes and keeps running; the timeout must still
+    // end it instead of waiting for it to exit
+    ProcessSpec spec;
+    spec.argv = {"/bin/sh", "-c", "exec >/dev/null 2>&1; sleep 10"};
+    spec.timeout = std::chrono::milliseconds(300);
+
+    auto start = std::chrono::steady_clock::now();
+    ProcessResult result = run_process(spec);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT(result.timed_out);
+    ASSERT(!result.success());
+    ASSERT(elapsed < std::chrono::seconds(5));
+}
+
+// =============================================================================
+// Test Target Tests
+// =============================================================================
+
+void test_shards_partition_tests() {
+    std::string targets =
+        "[target.tool]\ntype = \"binary\"\nsources = [\"src/tool.aria\"]\n\n";
+    for (int i = 0; i < 5; ++i) {
+        targets += test_target("t" + std::to_string(i), "deps = [\"tool\"]");
+    }
+    BuildConfig config = make_project("shards", targets);
+    write_text(config.project_root / "src" / "tool.aria", "#!/bin/sh\nexit 0\n");
+    for (int i = 0; i < 5; ++i) {
+        write_text(config.project_root / "tests" / ("t" + std::to_string(i) + ".aria"),
+                   "#!/bin/sh\nexit 0\n");
+    }
+
+    auto run_shards = [&]() {
+        std::set<std::string> seen;
+        size_t total = 0;
+        for (size_t shard = 0; shard < 3; ++shard) {
+            BuildConfig cfg = config;
+            cfg.test_shard_index = shard;
+            cfg.test_shard_count = 3;
+            BuildResult result = BuildOrchestrator(cfg).build();
+            ASSERT(result.success);
+            ASSERT(result.skipped_targets <= result.total_targets);
+            for (const auto& outcome : result.test_results) {
+                ASSERT(outcome.status == TestStatus::PASSED ||
+                       outcome.status == TestStatus::CACHED);
+                seen.insert(outcome.name);
+            }
+            total += result.test_results.size();
+        }
+        ASSERT_EQ(seen.size(), 5u);
+        ASSERT_EQ(total, 5u);
+    };
+
+    run_shards();
+
+    // A rebuilt dependency must not pull other shards' tests into a shard
+    write_text(config.project_root / "src" / "tool.aria", "#!/bin/sh\nexit 0 # edited\n");
+    run_shards();
+}
+
+void test_timed_out_test_is_reported() {
+    BuildConfig config = make_project("timeout",
+        test_target("slow", "timeout = \"1\"") + test_target("quiet", "timeout = \"1\""));
+    write_text(config.project_root / "tests" / "slow.aria", "#!/bin/sh\nsleep 10\n");
+    write_text(config.project_root / "tests" / "quiet.aria",
+               "#!/bin/sh\nexec >/dev/null 2>&1\nsleep 10\n");
+    config.fail_fast = false;
+
+    auto start = std::chrono::steady_clock::now();
+    BuildResult result = BuildOrchestrator(config).build();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT(!result.success);
+    ASSERT_EQ(count_status(result, TestStatus::TIMED_OUT), 2u);
+    ASSERT_EQ(result.tests_failed(), 2u);
+    ASSERT(elapsed < std::chrono::seconds(8));
+
+    // A timed-out test is never cached
+    BuildResult again = BuildOrchestrator(config).build();
+    ASSERT_EQ(count_status(again, TestStatus::CACHED), 0u);
+}
+
+void test_passing_result_is_cached() {
+    BuildConfig config = make_project("cached",
+        test_target("check", "inputs = [\"tests/data.txt\"]\nargs = [\"tests/data.txt\"]"));
+    write_text(config.project_root / "tests" / "check.aria",
+               "#!/bin/sh\ngrep -q ok \"$1\"\n");
+    write_text(config.project_root / "tests" / "data.txt", "ok\n");
+
+    BuildResult first = BuildOrchestrator(config).build();
+    BuildResult second = BuildOrchestrator(config).build();
+
+    // A changed runtime input reruns the test
+    write_text(config.project_root / "tests" / "data.txt", "still ok\n");
+    BuildResult third = BuildOrchestrator(config).build();
+
+    write_text(config.project_root / "tests" / "data.txt", "bad\n");
+    BuildResult fourth = BuildOrchestrator(config).build();
+
+    ASSERT(first.success);
+    ASSERT_EQ(count_status(first, TestStatus::PASSED), 1u);
+    ASSERT(second.success);
+    ASSERT_EQ(count_status(second, TestStatus::CACHED), 1u);
+    ASSERT(third.success);
+    ASSERT_EQ(count_status(third, TestStatus::PASSED), 1u);
+    ASSERT(!fourth.success);
+    ASSERT_EQ(count_status(fourth, TestStatus::FAILED), 1u);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Test Target Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("test_targets");
+
+    std::cout << "Process Runner Tests:\n";
+    TEST(timeout_holds_after_output_closed);
+
+    std::cout << "\nTest Target Tests:\n";
+    TEST(shards_partition_tests);
+    TEST(timed_out_test_is_reported);
+    TEST(passing_result_is_cached);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+// test_trash.cpp - Tests for rename-to-trash and background tree deletion
+// Part of aria_make - Aria Build System
+
+#include "core/trash.hpp"
+#include "core/build_orchestrator.hpp"
+#include "test_support.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+// An output-like tree: obj/<target>/<n>.o plus a few top-level files
+static void make_tree(const fs::path& root, int targets, int files) {
+    for (int t = 0; t < targets; ++t) {
+        for (int f = 0; f < files; ++f) {
+            write_text(root / "obj" / ("t" + std::to_string(t)) / (std::to_string(f) + ".o"), "x");
+        }
+        write_text(root / "bin" / ("t" + std::to_string(t)), "bin");
+    }
+    write_text(root / "build.log", "log");
+}
+
+static size_t count_entries(const fs::path& dir) {
+    std::error_code ec;
+    size_t count = 0;
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); ++it) {
+        ++count;
+    }
+    return count;
+}
+
+static bool wait_until_empty(const fs::path& dir) {
+    for (int i = 0; i < 200; ++i) {
+        if (count_entries(dir) == 0) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+}
+
+// =============================================================================
+// Deletion Tests
+// =============================================================================
+
+void test_remove_tree() {
+    for (size_t threads : {size_t(1), size_t(4)}) {
+        fs::path root = fixture->test_dir / ("tree" + std::to_string(threads));
+        make_tree(root, 12, 20);
+        ASSERT(remove_tree(root, threads));
+        ASSERT(!fs::exists(root));
+    }
+    ASSERT(remove_tree(fixture->test_dir / "missing", 4));
+}
+
+void test_remove_tree_keeps_symlink_targets() {
+    fs::path outside = fixture->test_dir / "outside";
+    write_text(outside / "keep.txt", "keep");
+
+    fs::path root = fixture->test_dir / "links";
+    make_tree(root, 3, 2);
+    fs::create_directory_symlink(outside, root / "obj" / "t0" / "dirlink");
+    fs::create_symlink(outside / "keep.txt", root / "filelink");
+
+    ASSERT(remove_tree(root, 4));
+    ASSERT(!fs::exists(root));
+    ASSERT(fs::exists(outside / "keep.txt"));
+}
+
+// =============================================================================
+// Trash Tests
+// =============================================================================
+
+void test_move_to_trash() {
+    fs::path out = fixture->test_dir / "move" / "build";
+    fs::path trash = fixture->test_dir / "move" / "trash";
+    make_tree(out, 2, 2);
+
+    std::string error;
+    ASSERT(move_to_trash(out, trash, error));
+    ASSERT(!fs::exists(out));
+    ASSERT_EQ(count_entries(trash), 1u);
+
+    // Same name again gets its own slot
+    make_tree(out, 1, 1);
+    ASSERT(move_to_trash(out, trash, error));
+    ASSERT_EQ(count_entries(trash), 2u);
+
+    ASSERT(!move_to_trash(fixture->test_dir / "move" / "missing", trash, error));
+    ASSERT(!error.empty());
+}
+
+void test_purge_trash_async() {
+    fs::path trash = fixture->test_dir / "purge";
+    make_tree(trash / "a", 8, 10);
+    make_tree(trash / "b", 8, 10);
+
+    ASSERT(purge_trash_async(trash));
+    ASSERT(wait_until_empty(trash));
+    ASSERT(fs::exists(trash));
+}
+
+void test_clean_is_atomic() {
+    fs::path project = fixture->test_dir / "project";
+    BuildConfig config;
+    config.project_root = project;
+    config.state_dir = project / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    make_tree(config.output_dir, 6, 10);
+
+    BuildOrchestrator orchestrator(config);
+    ASSERT(orchestrator.clean());
+
+    // Gone at once; the tree itself is deleted in the background
+    ASSERT(!fs::exists(config.output_dir));
+    ASSERT(wait_until_empty(config.state_dir / "trash"));
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Trash Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("trash");
+
+    std::cout << "Deletion Tests:\n";
+    TEST(remove_tree);
+    TEST(remove_tree_keeps_symlink_targets);
+
+    std::cout << "\nTrash Tests:\n";
+    TEST(move_to_trash);
+    TEST(purge_trash_async);
+    TEST(clean_is_atomic);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
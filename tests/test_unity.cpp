@@ -0,0 +1,180 @@
+// test_unity.cpp - Tests for unity (batched) builds of c_library targets
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <map>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+static const char* BUILD_FILE = R"([project]
+name = "unity"
+
+[target.rt]
+type = "c_library"
+sources = ["src/*.c"]
+compiler = "gcc"
+unity = "on"
+unity_batch_ms = "500"
+)";
+
+static BuildConfig make_project(const std::string& name, int sources) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", BUILD_FILE);
+    for (int i = 1; i <= sources; ++i) {
+        write_text(root / "src" / ("f" + std::to_string(i) + ".c"),
+                   "int f" + std::to_string(i) + "(void) { return " + std::to_string(i) + "; }\n");
+    }
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.quiet = true;
+    return config;
+}
+
+// Generated batch files of target rt, by file name
+static std::map<std::string, std::string> unity_files(const BuildConfig& config) {
+    std::map<std::string, std::string> files;
+    for (const auto& entry : fs::directory_iterator(config.output_dir / "unity" / "rt")) {
+        files[entry.path().filename().string()] = read_text(entry.path());
+    }
+    return files;
+}
+
+static bool batched(const std::map<std::string, std::string>& files, const std::string& source) {
+    for (const auto& [name, content] : files) {
+        if (content.find("/src/" + source + "\"") != std::string::npos) return true;
+    }
+    return false;
+}
+
+static void touch_source(const BuildConfig& config, const std::string& name, int value) {
+    write_text(config.project_root / "src" / name,
+               "int edited(void) { return " + std::to_string(value) + "; }\n");
+}
+
+// =============================================================================
+// Unity Tests
+// =============================================================================
+
+void test_unity_batches_by_cost() {
+    BuildConfig config = make_project("batches", 6);
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    ASSERT(errors.empty());
+
+    // No history: each source is assumed to cost 250ms, two per 500ms batch
+    size_t compiles = 0;
+    size_t members = 0;
+    for (size_t id : graph.actions_for("rt")) {
+        const Action& action = graph.get(id);
+        if (action.kind != ActionKind::COMPILE) continue;
+        ++compiles;
+        ASSERT(!action.depfile.empty());
+        ASSERT_EQ(fs::path(action.inputs[0]).filename().string().rfind("unity_", 0), 0u);
+        members += action.inputs.size() - 1;
+    }
+    ASSERT_EQ(compiles, 3u);
+    ASSERT_EQ(members, 6u);
+}
+
+void test_unity_edited_source_drops_out() {
+    BuildConfig config = make_project("edited", 6);
+    ASSERT(BuildOrchestrator(config).build().success);
+    auto before = unity_files(config);
+    ASSERT(batched(before, "f3.c"));
+
+    // The edited source compiles alone; only its old batch changes
+    touch_source(config, "f3.c", 30);
+    ASSERT(BuildOrchestrator(config).build().success);
+    auto after = unity_files(config);
+    ASSERT(!batched(after, "f3.c"));
+    ASSERT_EQ(after.size(), before.size());
+    size_t changed = 0;
+    for (const auto& [name, content] : after) {
+        if (before[name] != content) ++changed;
+    }
+    ASSERT_EQ(changed, 1u);
+
+    // Further edits leave the batches alone
+    touch_source(config, "f3.c", 300);
+    ASSERT(BuildOrchestrator(config).build().success);
+    ASSERT(unity_files(config) == after);
+    ASSERT(fs::exists(config.output_dir / "librt.a"));
+}
+
+void test_unity_membership_stable() {
+    BuildConfig config = make_project("stable", 6);
+    ASSERT(BuildOrchestrator(config).build().success);
+    auto before = unity_files(config);
+
+    // A new source joins a batch; the others keep their files
+    write_text(config.project_root / "src" / "f7.c", "int f7(void) { return 7; }\n");
+    ASSERT(BuildOrchestrator(config).build().success);
+    auto added = unity_files(config);
+    ASSERT(batched(added, "f7.c"));
+    size_t unchanged = 0;
+    for (const auto& [name, content] : before) {
+        if (added.count(name) && added[name] == content) ++unchanged;
+    }
+    ASSERT(unchanged >= before.size() - 1);
+
+    // A removed source leaves its batch
+    fs::remove(config.project_root / "src" / "f1.c");
+    ASSERT(BuildOrchestrator(config).build().success);
+    ASSERT(!batched(unity_files(config), "f1.c"));
+}
+
+void test_unity_only_for_c_library() {
+    BuildConfig config = make_project("invalid", 1);
+    write_text(config.project_root / "build.abc",
+               "[target.app]\ntype = \"binary\"\nsources = [\"src/f1.c\"]\nunity = \"on\"\n");
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("unity") != std::string::npos);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Unity Build Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("unity");
+
+    std::cout << "Unity Tests:\n";
+    TEST(unity_batches_by_cost);
+    TEST(unity_edited_source_drops_out);
+    TEST(unity_membership_stable);
+    TEST(unity_only_for_c_library);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
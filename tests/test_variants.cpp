@@ -0,0 +1,587 @@
+// test_variants.cpp - Tests for multi-variant builds and the LTO, PGO and fast-link modes
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+static const char* BUILD_FILE = R"([project]
+name = "variants"
+
+[variant.debug]
+flags = ["-O0", "-g"]
+
+[variant.asan]
+c_flags = ["-fsanitize=address"]
+output_dir = "out/asan"
+
+[target.gen]
+type = "command"
+inputs = ["in.txt"]
+outputs = ["gen/g.txt"]
+argv = ["cp", "in.txt", "gen/g.txt"]
+
+[target.core]
+type = "c_library"
+sources = ["src/a.c"]
+compiler = "gcc"
+flags = ["-Wall"]
+
+[target.util]
+type = "c_library"
+sources = ["src/b.c"]
+inputs = ["gen/g.txt"]
+compiler = "gcc"
+deps = ["core"]
+)";
+
+static BuildConfig make_project(const std::string& name) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", BUILD_FILE);
+    write_text(root / "src" / "a.c", "int a(void) { return 1; }\n");
+    write_text(root / "src" / "b.c", "int b(void) { return 2; }\n");
+    write_text(root / "in.txt", "x\n");
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.quiet = true;
+    return config;
+}
+
+static const BuildTarget* find_target(const std::vector<BuildTarget>& targets,
+                                      const std::string& name) {
+    auto it = std::find_if(targets.begin(), targets.end(),
+                           [&](const BuildTarget& t) { return t.name == name; });
+    return it == targets.end() ? nullptr : &*it;
+}
+
+static bool has_flag(const BuildTarget& target, const std::string& flag) {
+    return std::find(target.flags.begin(), target.flags.end(), flag) != target.flags.end();
+}
+
+// =============================================================================
+// Variant Tests
+// =============================================================================
+
+void test_no_variants_requested() {
+    BuildConfig config = make_project("plain");
+    BuildOrchestrator orchestrator(config);
+    orchestrator.check();
+
+    auto targets = orchestrator.list_targets();
+    ASSERT_EQ(targets.size(), 3u);
+    ASSERT(find_target(targets, "core"));
+    ASSERT(targets[0].variant.empty());
+}
+
+void test_targets_per_variant() {
+    BuildConfig config = make_project("expanded");
+    config.variants = {"debug", "asan"};
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    // One shared command target plus core and util per variant
+    auto targets = orchestrator.list_targets();
+    ASSERT_EQ(targets.size(), 5u);
+    ASSERT_EQ(result.total_targets, 5u);
+    ASSERT(find_target(targets, "gen"));
+    ASSERT(!find_target(targets, "core"));
+
+    const BuildTarget* debug = find_target(targets, "core@debug");
+    const BuildTarget* asan = find_target(targets, "core@asan");
+    ASSERT(debug && asan);
+    ASSERT_EQ(debug->variant, "debug");
+    ASSERT(has_flag(*debug, "-Wall") && has_flag(*debug, "-g"));
+    ASSERT(has_flag(*asan, "-fsanitize=address") && !has_flag(*asan, "-g"));
+
+    // Default output directory is <output_dir>/<variant>; asan overrides it
+    ASSERT_EQ(debug->output_path, config.output_dir / "debug" / "libcore.a");
+    ASSERT_EQ(asan->output_path, config.project_root / "out" / "asan" / "libcore.a");
+}
+
+void test_variant_dependencies() {
+    BuildConfig config = make_project("deps");
+    config.variants = {"debug", "asan"};
+    BuildOrchestrator orchestrator(config);
+    orchestrator.check();
+
+    // Each instance depends on its own variant's deps and the shared command
+    std::string dot = orchestrator.dependency_graph_dot();
+    ASSERT(dot.find("\"util@debug\" -> \"core@debug\"") != std::string::npos);
+    ASSERT(dot.find("\"util@asan\" -> \"core@asan\"") != std::string::npos);
+    ASSERT(dot.find("\"util@asan\" -> \"gen\"") != std::string::npos);
+    ASSERT(dot.find("\"util@debug\" -> \"core@asan\"") == std::string::npos);
+}
+
+void test_unknown_variant() {
+    BuildConfig config = make_project("unknown");
+    config.variants = {"debug", "tsan"};
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("tsan") != std::string::npos);
+}
+
+// =============================================================================
+// LTO Tests
+// =============================================================================
+
+static const char* LTO_BUILD_FILE = R"([project]
+name = "lto"
+
+[variant.debug]
+flags = ["-O0"]
+
+[variant.release]
+flags = ["-O2"]
+lto = "thin"
+
+[target.core]
+type = "c_library"
+sources = ["src/a.c"]
+compiler = "gcc"
+
+[target.mod]
+type = "library"
+sources = ["src/m.aria"]
+lto = "thin"
+
+[target.app]
+type = "binary"
+sources = ["src/main.aria"]
+deps = ["core", "mod"]
+)";
+
+static BuildConfig make_lto_project(const std::string& name) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", LTO_BUILD_FILE);
+    write_text(root / "src" / "a.c", "int a(void) { return 1; }\n");
+    write_text(root / "src" / "m.aria", "// module\n");
+    write_text(root / "src" / "main.aria", "// main\n");
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = "/bin/true";
+    config.quiet = true;
+    return config;
+}
+
+static const Action* find_action(const ActionGraph& graph, const std::string& target,
+                                 ActionKind kind) {
+    for (size_t id : graph.actions_for(target)) {
+        if (graph.get(id).kind == kind) return &graph.get(id);
+    }
+    return nullptr;
+}
+
+static bool has_arg(const Action& action, const std::string& prefix) {
+    return std::any_of(action.argv.begin(), action.argv.end(),
+                       [&](const std::string& arg) { return arg.rfind(prefix, 0) == 0; });
+}
+
+void test_lto_per_target() {
+    BuildConfig config = make_lto_project("lto_target");
+    BuildOrchestrator orchestrator(config);
+    orchestrator.check();
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    ASSERT(errors.empty());
+
+    // Aria modules compile to bitcode, archived with an LLVM-aware ar
+    const Action* compile = find_action(graph, "mod", ActionKind::COMPILE);
+    ASSERT(compile);
+    ASSERT_EQ(fs::path(compile->outputs[0]).extension(), ".bc");
+    ASSERT(has_arg(*compile, "--emit-llvm-bc"));
+    const Action* archive = find_action(graph, "mod", ActionKind::ARCHIVE);
+    ASSERT(archive);
+    ASSERT_EQ(archive->argv[0], "llvm-ar");
+
+    // Targets without `lto` are untouched
+    const Action* c_compile = find_action(graph, "core", ActionKind::COMPILE);
+    ASSERT(c_compile);
+    ASSERT(!has_arg(*c_compile, "-flto"));
+    const Action* link = find_action(graph, "app", ActionKind::LINK);
+    ASSERT(link);
+    ASSERT(!has_arg(*link, "-flto"));
+}
+
+void test_lto_per_variant() {
+    BuildConfig config = make_lto_project("lto_variant");
+    config.variants = {"debug", "release"};
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    auto targets = orchestrator.list_targets();
+    ASSERT_EQ(find_target(targets, "core@release")->lto, "thin");
+    ASSERT(find_target(targets, "core@debug")->lto.empty());
+    ASSERT_EQ(find_target(targets, "mod@debug")->lto, "thin");
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    const Action* c_compile = find_action(graph, "core@release", ActionKind::COMPILE);
+    ASSERT(c_compile);
+    ASSERT(has_arg(*c_compile, "-flto"));
+    const Action* archive = find_action(graph, "core@release", ActionKind::ARCHIVE);
+    ASSERT(archive);
+    ASSERT_EQ(archive->argv[0], "gcc-ar");
+
+    // The link uses ThinLTO with the cache under the state directory
+    const Action* link = find_action(graph, "app@release", ActionKind::LINK);
+    ASSERT(link);
+    ASSERT(has_arg(*link, "-flto=thin"));
+    ASSERT(has_arg(*link, "-Wl,--thinlto-cache-dir=" +
+                              fs::absolute(config.state_dir / "lto-cache").string()));
+    ASSERT(!has_arg(*find_action(graph, "app@debug", ActionKind::LINK), "-flto"));
+
+    // Debug and release objects of the same source do not collide
+    const Action* debug_compile = find_action(graph, "core@debug", ActionKind::COMPILE);
+    ASSERT(debug_compile);
+    ASSERT(debug_compile->outputs[0] != c_compile->outputs[0]);
+}
+
+void test_invalid_lto() {
+    BuildConfig config = make_lto_project("lto_invalid");
+    write_text(config.project_root / "build.abc",
+               "[target.core]\ntype = \"c_library\"\nsources = [\"src/a.c\"]\nlto = \"full\"\n");
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("lto") != std::string::npos);
+}
+
+// =============================================================================
+// PGO Tests
+// =============================================================================
+
+static const char* PGO_BUILD_FILE = R"([project]
+name = "pgo"
+
+[pgo]
+training = "bench"
+flags = ["-O2"]
+
+[target.mod]
+type = "library"
+sources = ["src/m.aria"]
+
+[target.app]
+type = "binary"
+sources = ["src/main.aria"]
+deps = ["mod"]
+
+[target.bench]
+type = "test"
+sources = ["src/bench.aria"]
+
+[target.unit]
+type = "test"
+sources = ["src/unit.aria"]
+)";
+
+static BuildConfig make_pgo_project(const std::string& name) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", PGO_BUILD_FILE);
+    write_text(root / "src" / "m.aria", "// module\n");
+    write_text(root / "src" / "main.aria", "// main\n");
+    write_text(root / "src" / "bench.aria", "// bench\n");
+    write_text(root / "src" / "unit.aria", "// unit\n");
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = "/bin/true";
+    config.quiet = true;
+    return config;
+}
+
+static bool has_env(const Action& action, const std::string& name) {
+    return std::any_of(action.env.begin(), action.env.end(),
+                       [&](const auto& entry) { return entry.first == name; });
+}
+
+void test_pgo_instrument() {
+    BuildConfig config = make_pgo_project("pgo_instrument");
+    config.pgo = PgoPhase::INSTRUMENT;
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    auto targets = orchestrator.list_targets();
+    const BuildTarget* app = find_target(targets, "app@pgo-instrument");
+    ASSERT(app);
+    ASSERT_EQ(app->pgo, "generate");
+    ASSERT(has_flag(*app, "-O2"));
+    ASSERT_EQ(app->output_path, config.output_dir / "pgo-instrument" / "app");
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    const Action* compile = find_action(graph, "mod@pgo-instrument", ActionKind::COMPILE);
+    ASSERT(compile);
+    ASSERT(has_arg(*compile, "-fprofile-generate="));
+    const Action* run = find_action(graph, "bench@pgo-instrument", ActionKind::TEST);
+    ASSERT(run);
+    ASSERT(has_env(*run, "LLVM_PROFILE_FILE"));
+}
+
+void test_pgo_optimize() {
+    BuildConfig config = make_pgo_project("pgo_optimize");
+    config.pgo = PgoPhase::OPTIMIZE;
+    BuildOrchestrator orchestrator(config);
+    write_text(orchestrator.profile_path(), "profile\n");
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    auto targets = orchestrator.list_targets();
+    ASSERT(find_target(targets, "app@pgo"));
+    ASSERT(!find_target(targets, "app"));
+
+    // The profile is an input of every profiled compile and link
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    std::string profile = orchestrator.profile_path().string();
+    const Action* compile = find_action(graph, "mod@pgo", ActionKind::COMPILE);
+    ASSERT(compile);
+    ASSERT(has_arg(*compile, "-fprofile-use="));
+    ASSERT(std::find(compile->inputs.begin(), compile->inputs.end(), profile) !=
+           compile->inputs.end());
+    const Action* link = find_action(graph, "app@pgo", ActionKind::LINK);
+    ASSERT(link);
+    ASSERT(std::find(link->inputs.begin(), link->inputs.end(), profile) != link->inputs.end());
+}
+
+void test_pgo_needs_profile() {
+    BuildConfig config = make_pgo_project("pgo_no_profile");
+    config.pgo = PgoPhase::OPTIMIZE;
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("aria_make pgo") != std::string::npos);
+}
+
+void test_pgo_training_must_be_test() {
+    BuildConfig config = make_pgo_project("pgo_training");
+    std::string text = PGO_BUILD_FILE;
+    text.replace(text.find("training = \"bench\""), 18, "training = \"app\"");
+    write_text(config.project_root / "build.abc", text);
+    config.pgo = PgoPhase::INSTRUMENT;
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("'app'") != std::string::npos);
+}
+
+// =============================================================================
+// Link Tests
+// =============================================================================
+
+static const char* LINK_BUILD_FILE = R"([project]
+name = "link"
+
+[link]
+linker = "lld"
+jobs = "2"
+
+[variant.debug]
+flags = ["-O0", "-g"]
+
+[variant.release]
+flags = ["-O2"]
+
+[target.core]
+type = "c_library"
+sources = ["src/a.c"]
+compiler = "gcc"
+
+[target.app]
+type = "binary"
+sources = ["src/main.aria"]
+deps = ["core"]
+)";
+
+static BuildConfig make_link_project(const std::string& name) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", LINK_BUILD_FILE);
+    write_text(root / "src" / "a.c", "int a(void) { return 1; }\n");
+    write_text(root / "src" / "main.aria", "// main\n");
+
+    // Stands in for ariac: creates the -o output after a short pause
+    write_text(root / "fake_ariac",
+               "#!/bin/sh\nsleep 0.05\n"
+               "while [ $# -gt 0 ]; do [ \"$1\" = -o ] && : > \"$2\"; shift; done\n");
+    fs::permissions(root / "fake_ariac", fs::perms::owner_all);
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.compiler = (root / "fake_ariac").string();
+    config.quiet = true;
+    return config;
+}
+
+void test_link_split_debug_per_variant() {
+    BuildConfig config = make_link_project("link_variants");
+    config.variants = {"debug", "release"};
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+    ASSERT_EQ(orchestrator.linker(), "lld");
+
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    ASSERT(errors.empty());
+
+    // Debug links get split DWARF and a gdb index; release links only the linker
+    const Action* debug_link = find_action(graph, "app@debug", ActionKind::LINK);
+    ASSERT(debug_link);
+    ASSERT(has_arg(*debug_link, "-fuse-ld=lld"));
+    ASSERT(has_arg(*debug_link, "-gsplit-dwarf"));
+    ASSERT(has_arg(*debug_link, "-Wl,--gdb-index"));
+    const Action* release_link = find_action(graph, "app@release", ActionKind::LINK);
+    ASSERT(release_link);
+    ASSERT(has_arg(*release_link, "-fuse-ld=lld"));
+    ASSERT(!has_arg(*release_link, "-gsplit-dwarf"));
+    ASSERT(!has_arg(*release_link, "-Wl,--gdb-index"));
+
+    const Action* debug_compile = find_action(graph, "core@debug", ActionKind::COMPILE);
+    ASSERT(debug_compile);
+    ASSERT(has_arg(*debug_compile, "-gsplit-dwarf"));
+    ASSERT(!has_arg(*find_action(graph, "core@release", ActionKind::COMPILE), "-gsplit-dwarf"));
+
+    // Links run in their own pool
+    ASSERT_EQ(orchestrator.pool_depths().at("link"), 2u);
+    ASSERT_EQ(debug_link->resources.pool, "link");
+}
+
+void test_split_dwarf_is_declared_output() {
+    BuildConfig config = make_link_project("link_dwo");
+    config.variants = {"debug", "release"};
+    config.linker = "default";
+    config.targets = {"core@debug", "core@release"};
+    BuildOrchestrator orchestrator(config);
+    ASSERT(orchestrator.check().errors.empty());
+
+    // The .dwo travels with its object (remote runs, cache bundles)
+    std::vector<std::string> errors;
+    const ActionGraph& graph = orchestrator.action_graph(errors);
+    const Action* debug_compile = find_action(graph, "core@debug", ActionKind::COMPILE);
+    ASSERT(debug_compile);
+    std::string dwo = fs::path(debug_compile->outputs[0]).replace_extension(".dwo").string();
+    ASSERT(std::find(debug_compile->outputs.begin(), debug_compile->outputs.end(), dwo) !=
+           debug_compile->outputs.end());
+    const Action* release_compile = find_action(graph, "core@release", ActionKind::COMPILE);
+    ASSERT(release_compile);
+    ASSERT_EQ(release_compile->outputs.size(), 1u);
+
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+    ASSERT(fs::exists(dwo));
+}
+
+void test_linker_override() {
+    BuildConfig config = make_link_project("link_override");
+    config.variants = {"debug"};
+    config.linker = "bfd";
+    BuildOrchestrator orchestrator(config);
+    ASSERT(orchestrator.check().errors.empty());
+
+    // BFD ld cannot write a gdb index
+    std::vector<std::string> errors;
+    const Action* link = find_action(orchestrator.action_graph(errors), "app@debug",
+                                     ActionKind::LINK);
+    ASSERT(link);
+    ASSERT(has_arg(*link, "-fuse-ld=bfd"));
+    ASSERT(has_arg(*link, "-gsplit-dwarf"));
+    ASSERT(!has_arg(*link, "-Wl,--gdb-index"));
+
+    config.linker = "ld64";
+    BuildOrchestrator invalid(config);
+    BuildResult result = invalid.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("linker") != std::string::npos);
+}
+
+void test_link_time_reported() {
+    BuildConfig config = make_link_project("link_time");
+    config.linker = "default";
+    BuildResult result = BuildOrchestrator(config).build();
+    ASSERT(result.success);
+
+    // Only the binary links; its link time is part of its build time
+    ASSERT_EQ(result.link_times.size(), 1u);
+    ASSERT_EQ(result.link_times[0].first, "app");
+    ASSERT(result.link_times[0].second.count() > 0);
+    ASSERT(result.link_time == result.link_times[0].second);
+    auto app = std::find_if(result.target_times.begin(), result.target_times.end(),
+                            [](const auto& t) { return t.first == "app"; });
+    ASSERT(app != result.target_times.end());
+    ASSERT(app->second >= result.link_times[0].second);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Variant Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("variant");
+
+    std::cout << "Variant Tests:\n";
+    TEST(no_variants_requested);
+    TEST(targets_per_variant);
+    TEST(variant_dependencies);
+    TEST(unknown_variant);
+
+    std::cout << "\nLTO Tests:\n";
+    TEST(lto_per_target);
+    TEST(lto_per_variant);
+    TEST(invalid_lto);
+
+    std::cout << "\nPGO Tests:\n";
+    TEST(pgo_instrument);
+    TEST(pgo_optimize);
+    TEST(pgo_needs_profile);
+    TEST(pgo_training_must_be_test);
+
+    std::cout << "\nLink Tests:\n";
+    TEST(link_split_debug_per_variant);
+    TEST(split_dwarf_is_declared_output);
+    TEST(linker_override);
+    TEST(link_time_reported);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+// test_workspace.cpp - Tests for workspaces of sub-project build files
+// Part of aria_make - Aria Build System
+
+#include "core/build_orchestrator.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+
+using namespace aria::make;
+
+// =============================================================================
+// Test Fixtures
+// =============================================================================
+
+static std::unique_ptr<TestFixture> fixture;
+
+static BuildConfig make_workspace(const std::string& name, const std::string& members) {
+    fs::path root = fixture->test_dir / name;
+    write_text(root / "build.abc", "[project]\nname = \"ws\"\n\n"
+                                   "[workspace]\nmembers = " + members + "\n\n"
+                                   "[pools]\nlink = \"2\"\n\n"
+                                   "[target.core]\ntype = \"c_library\"\n"
+                                   "sources = [\"src/*.c\"]\ncompiler = \"gcc\"\n");
+    write_text(root / "src" / "core.c", "int core(void) { return 0; }\n");
+
+    write_text(root / "packages" / "net" / "build.abc",
+               "[pools]\nlink = \"8\"\nnet_io = \"3\"\n\n"
+               "[target.gen]\ntype = \"command\"\ninputs = [\"proto.txt\"]\n"
+               "outputs = [\"gen/proto.c\"]\nargv = [\"cp\", \"proto.txt\", \"gen/proto.c\"]\n\n"
+               "[target.net]\ntype = \"c_library\"\nsources = [\"src/*.c\"]\n"
+               "compiler = \"gcc\"\npool = \"net_io\"\n");
+    write_text(root / "packages" / "net" / "proto.txt", "int proto;\n");
+    write_text(root / "packages" / "net" / "src" / "net.c", "int net(void) { return 1; }\n");
+
+    write_text(root / "packages" / "http" / "build.abc",
+               "[target.http]\ntype = \"c_library\"\nsources = [\"http.c\"]\n"
+               "compiler = \"gcc\"\ndeps = [\"packages/net:net\"]\n\n"
+               "[target.client]\ntype = \"c_library\"\nsources = [\"client.c\"]\n"
+               "compiler = \"gcc\"\ndeps = [\"http\"]\n");
+    write_text(root / "packages" / "http" / "http.c", "int http(void) { return 2; }\n");
+    write_text(root / "packages" / "http" / "client.c", "int client(void) { return 3; }\n");
+
+    write_text(root / "tools" / "cli" / "build.abc",
+               "[target.cli]\ntype = \"c_library\"\nsources = [\"main.c\"]\n"
+               "compiler = \"gcc\"\ndeps = [\":core\", \"packages/http:client\"]\n");
+    write_text(root / "tools" / "cli" / "main.c", "int cli(void) { return 4; }\n");
+
+    BuildConfig config;
+    config.project_root = root;
+    config.state_dir = root / ".aria_make";
+    config.output_dir = config.state_dir / "build";
+    config.quiet = true;
+    return config;
+}
+
+static const char* MEMBERS = R"(["packages/*", "tools/cli"])";
+
+static const BuildTarget* find_target(const std::vector<BuildTarget>& targets,
+                                      const std::string& name) {
+    auto it = std::find_if(targets.begin(), targets.end(),
+                           [&](const BuildTarget& t) { return t.name == name; });
+    return it == targets.end() ? nullptr : &*it;
+}
+
+// =============================================================================
+// Workspace Tests
+// =============================================================================
+
+void test_members_loaded() {
+    BuildConfig config = make_workspace("loaded", MEMBERS);
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(result.errors.empty());
+
+    auto targets = orchestrator.list_targets();
+    ASSERT_EQ(targets.size(), 6u);
+    ASSERT(find_target(targets, "core"));
+    ASSERT(find_target(targets, "packages/net:gen"));
+    ASSERT(find_target(targets, "packages/http:client"));
+    ASSERT(find_target(targets, "tools/cli:cli"));
+
+    const BuildTarget* core = find_target(targets, "core");
+    ASSERT(core->package.empty());
+    const BuildTarget* net = find_target(targets, "packages/net:net");
+    ASSERT(net);
+    ASSERT_EQ(net->package, "packages/net");
+}
+
+void test_paths_relative_to_member() {
+    BuildConfig config = make_workspace("paths", MEMBERS);
+    BuildOrchestrator orchestrator(config);
+    orchestrator.check();
+
+    auto targets = orchestrator.list_targets();
+    const BuildTarget* net = find_target(targets, "packages/net:net");
+    ASSERT(net);
+    ASSERT_EQ(net->sources.size(), 1u);
+    ASSERT_EQ(fs::path(net->sources[0]),
+              config.project_root / "packages" / "net" / "src" / "net.c");
+    ASSERT_EQ(net->output_path, config.output_dir / "packages" / "net" / "libnet.a");
+
+    const BuildTarget* gen = find_target(targets, "packages/net:gen");
+    ASSERT(gen);
+    ASSERT_EQ(fs::path(gen->outputs[0]),
+              config.project_root / "packages" / "net" / "gen" / "proto.c");
+}
+
+void test_cross_package_dependencies() {
+    BuildConfig config = make_workspace("deps", MEMBERS);
+    BuildOrchestrator orchestrator(config);
+    orchestrator.check();
+
+    std::string dot = orchestrator.dependency_graph_dot();
+    ASSERT(dot.find("\"packages/http:http\" -> \"packages/net:net\"") != std::string::npos);
+    ASSERT(dot.find("\"packages/http:client\" -> \"packages/http:http\"") != std::string::npos);
+    ASSERT(dot.find("\"tools/cli:cli\" -> \"core\"") != std::string::npos);
+    ASSERT(dot.find("\"tools/cli:cli\" -> \"packages/http:client\"") != std::string::npos);
+}
+
+void test_shared_pools() {
+    BuildConfig config = make_workspace("pools", MEMBERS);
+    BuildOrchestrator orchestrator(config);
+    orchestrator.check();
+
+    // The root's depth wins; pools only a member declares are added
+    const auto& pools = orchestrator.pool_depths();
+    ASSERT_EQ(pools.at("link"), 2u);
+    ASSERT_EQ(pools.at("net_io"), 3u);
+}
+
+void test_unknown_dependency() {
+    BuildConfig config = make_workspace("unknown", MEMBERS);
+    write_text(config.project_root / "tools" / "cli" / "build.abc",
+               "[target.cli]\ntype = \"c_library\"\nsources = [\"main.c\"]\n"
+               "deps = [\"packages/db:db\"]\n");
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("packages/db:db") != std::string::npos);
+}
+
+void test_missing_member() {
+    BuildConfig config = make_workspace("missing", R"(["packages/*", "tools/gone"])");
+    BuildOrchestrator orchestrator(config);
+    BuildResult result = orchestrator.check();
+    ASSERT(!result.success);
+    ASSERT(!result.errors.empty());
+    ASSERT(result.errors[0].find("tools/gone") != std::string::npos);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main() {
+    std::cout << "=== Workspace Test Suite ===\n\n";
+
+    // Setup
+    fixture = std::make_unique<TestFixture>("workspace");
+
+    std::cout << "Workspace Tests:\n";
+    TEST(members_loaded);
+    TEST(paths_relative_to_member);
+    TEST(cross_package_dependencies);
+    TEST(shared_pools);
+    TEST(unknown_dependency);
+    TEST(missing_member);
+
+    // Cleanup
+    fixture.reset();
+
+    std::cout << "\n=== Results ===\n";
+    std::cout << "Passed: " << tests_passed << "/" << tests_run << "\n";
+
+    return (tests_passed == tests_run) ? 0 : 1;
+}